@@ -0,0 +1,5 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+DECLARE_STATS_GROUP(TEXT("Heart"), STATGROUP_Heart, STATCAT_Advanced);
\ No newline at end of file
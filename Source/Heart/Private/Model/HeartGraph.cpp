@@ -70,6 +70,10 @@ void UHeartGraph::PreSave(FObjectPreSaveContext SaveContext)
 		if (GetSchema()->FlushNodesForRuntime)
 		{
 			Nodes.Empty();
+			if (Topology.IsValid())
+			{
+				Topology->Rebuild();
+			}
 		}
 	}
 #endif
@@ -84,6 +88,22 @@ void UHeartGraph::PostInitProperties()
 	}
 }
 
+void UHeartGraph::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	if (Ar.IsLoading())
+	{
+		NodeComponentIndexDirty = true;
+
+		// Nodes loaded in, such as by undoing a transaction, aren't broadcast either
+		if (Topology.IsValid())
+		{
+			Topology->Rebuild();
+		}
+	}
+}
+
 void UHeartGraph::PostLoad()
 {
 	Super::PostLoad();
@@ -137,18 +157,32 @@ void UHeartGraph::PostLoad()
 			continue;
 		}
 
-		for (auto SubIt = NodeMap.Value.Components.CreateIterator(); It; ++It)
+		for (auto SubIt = NodeMap.Value.Components.CreateIterator(); SubIt; ++SubIt)
 		{
 			auto&& Component = *SubIt;
 			if (!Component.Key.IsValid() ||
 				!IsValid(Component.Value) ||
 				CleanedUpNodes.Contains(Component.Key))
 			{
-				It.RemoveCurrent();
+				SubIt.RemoveCurrent();
 			}
 		}
 	}
 
+	for (auto It = StructComponents.CreateIterator(); It; ++It)
+	{
+		if (!IsValid(It->GetStructType()))
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		for (auto&& Node : CleanedUpNodes)
+		{
+			It->Remove(Node);
+		}
+	}
+
 	// Cannot do this without also running the presave action
 	/*
 	if (!IsTemplate())
@@ -156,7 +190,15 @@ void UHeartGraph::PostLoad()
 		GetSchema()->RefreshGraphExtensions(this);
 	}
 	*/
+
+	// Nodes removed above were never broadcast
+	if (Topology.IsValid() && !CleanedUpNodes.IsEmpty())
+	{
+		Topology->Rebuild();
+	}
 #endif
+
+	NodeComponentIndexDirty = true;
 }
 
 void UHeartGraph::PostDuplicate(const EDuplicateMode::Type DuplicateMode)
@@ -173,10 +215,16 @@ void UHeartGraph::PostDuplicate(const EDuplicateMode::Type DuplicateMode)
 		if (GetSchema()->FlushNodesForRuntime)
 		{
 			Nodes.Empty();
+			if (Topology.IsValid())
+			{
+				Topology->Rebuild();
+			}
 		}
 	}
 #endif
 
+	NodeComponentIndexDirty = true;
+
 	Super::PostDuplicate(DuplicateMode);
 }
 
@@ -233,7 +281,103 @@ void UHeartGraph::ForEachExtension(const TFunctionRef<bool(UHeartGraphExtension*
 
 void UHeartGraph::HandleNodeAddEvent(const FHeartNodeAddEvent& Event)
 {
-	// @todo batch this as well?
+	if (IsBatching())
+	{
+		for (const FHeartNodeGuid& NodeGuid : Event.NewNodes)
+		{
+			bool AlreadyAdded;
+			PendingAddedNodes.Add(NodeGuid, &AlreadyAdded);
+			if (!AlreadyAdded)
+			{
+				PendingBatch.Added.NewNodes.Add(NodeGuid);
+			}
+		}
+		return;
+	}
+
+	BroadcastNodeAddEvent(Event);
+
+	if (OnBatchEvent.IsBound())
+	{
+		FHeartGraphBatchEvent Batch;
+		Batch.Added = Event;
+		OnBatchEvent.Broadcast(Batch);
+	}
+}
+
+void UHeartGraph::HandleNodeRemoveEvent(const FHeartNodeRemoveEvent& Event)
+{
+	if (IsBatching())
+	{
+		for (UHeartGraphNode* Node : Event.AffectedNodes)
+		{
+			// Nodes added and removed within the same batch are never seen by listeners.
+			if (IsValid(Node) && PendingAddedNodes.Remove(Node->GetGuid()) > 0)
+			{
+				continue;
+			}
+
+			bool AlreadyRemoved;
+			PendingRemovedNodes.Add(Node, &AlreadyRemoved);
+			if (!AlreadyRemoved)
+			{
+				PendingBatch.Removed.AffectedNodes.Add(Node);
+			}
+		}
+		return;
+	}
+
+	BroadcastNodeRemoveEvent(Event);
+
+	if (OnBatchEvent.IsBound())
+	{
+		FHeartGraphBatchEvent Batch;
+		Batch.Removed = Event;
+		OnBatchEvent.Broadcast(Batch);
+	}
+}
+
+void UHeartGraph::HandleNodeMoveEvent(const FHeartNodeMoveEvent& Event)
+{
+	if (IsBatching())
+	{
+		PendingBatch.Moved.AffectedNodes.Append(Event.AffectedNodes);
+		// A move finished anywhere in the batch finishes the coalesced move.
+		PendingBatch.Moved.MoveFinished |= Event.MoveFinished;
+		return;
+	}
+
+	BroadcastNodeMoveEvent(Event);
+
+	if (OnBatchEvent.IsBound())
+	{
+		FHeartGraphBatchEvent Batch;
+		Batch.Moved = Event;
+		OnBatchEvent.Broadcast(Batch);
+	}
+}
+
+void UHeartGraph::HandleGraphConnectionEvent(const FHeartGraphConnectionEvent& Event)
+{
+	if (IsBatching())
+	{
+		PendingBatch.Connections.AffectedNodes.Append(Event.AffectedNodes);
+		PendingBatch.Connections.AffectedPins.Append(Event.AffectedPins);
+		return;
+	}
+
+	BroadcastGraphConnectionEvent(Event);
+
+	if (OnBatchEvent.IsBound())
+	{
+		FHeartGraphBatchEvent Batch;
+		Batch.Connections = Event;
+		OnBatchEvent.Broadcast(Batch);
+	}
+}
+
+void UHeartGraph::BroadcastNodeAddEvent(const FHeartNodeAddEvent& Event)
+{
 	for (const FHeartNodeGuid& NodeGuid : Event.NewNodes)
 	{
 		if (UHeartGraphNode* Node = GetNode(NodeGuid);
@@ -244,21 +388,20 @@ void UHeartGraph::HandleNodeAddEvent(const FHeartNodeAddEvent& Event)
 	}
 }
 
-void UHeartGraph::HandleNodeRemoveEvent(const FHeartNodeRemoveEvent& Event)
+void UHeartGraph::BroadcastNodeRemoveEvent(const FHeartNodeRemoveEvent& Event)
 {
-	// @todo batch this as well?
 	for (UHeartGraphNode* Node : Event.AffectedNodes)
 	{
 		OnNodeRemoved.Broadcast(Node);
 	}
 }
 
-void UHeartGraph::HandleNodeMoveEvent(const FHeartNodeMoveEvent& Event)
+void UHeartGraph::BroadcastNodeMoveEvent(const FHeartNodeMoveEvent& Event)
 {
 	OnNodeMoved.Broadcast(Event);
 }
 
-void UHeartGraph::HandleGraphConnectionEvent(const FHeartGraphConnectionEvent& Event)
+void UHeartGraph::BroadcastGraphConnectionEvent(const FHeartGraphConnectionEvent& Event)
 {
 	{
 #if WITH_EDITOR
@@ -269,6 +412,102 @@ void UHeartGraph::HandleGraphConnectionEvent(const FHeartGraphConnectionEvent& E
 	OnNodeConnectionsChanged.Broadcast(Event);
 }
 
+void UHeartGraph::BeginBatch()
+{
+	BatchDepth++;
+}
+
+void UHeartGraph::EndBatch()
+{
+	if (!ensure(BatchDepth > 0) || --BatchDepth > 0)
+	{
+		return;
+	}
+
+	// Take the pending batch first, as listeners are free to make further edits, or open batches of their own.
+	FHeartGraphBatchEvent Batch = MoveTemp(PendingBatch);
+	PendingBatch = FHeartGraphBatchEvent();
+	const TSet<FHeartNodeGuid> AddedNodes = MoveTemp(PendingAddedNodes);
+	PendingAddedNodes.Reset();
+	PendingRemovedNodes.Reset();
+
+	// Drop nodes that were removed again after being added, along with the duplicates left by re-adding them.
+	if (AddedNodes.Num() != Batch.Added.NewNodes.Num())
+	{
+		TSet<FHeartNodeGuid> Seen;
+		Seen.Reserve(AddedNodes.Num());
+		Batch.Added.NewNodes.RemoveAll(
+			[&AddedNodes, &Seen](const FHeartNodeGuid& NodeGuid)
+			{
+				bool AlreadySeen;
+				Seen.Add(NodeGuid, &AlreadySeen);
+				return AlreadySeen || !AddedNodes.Contains(NodeGuid);
+			});
+	}
+
+	// Drop nodes that left the graph after they were moved or reconnected.
+	auto IsInGraph = [this](const UHeartGraphNode* Node)
+		{
+			return IsValid(Node) && GetNode(Node->GetGuid()) == Node;
+		};
+	for (auto It = Batch.Moved.AffectedNodes.CreateIterator(); It; ++It)
+	{
+		if (!IsInGraph(*It))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = Batch.Connections.AffectedNodes.CreateIterator(); It; ++It)
+	{
+		if (!IsInGraph(*It))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// Pins that were disconnected from nodes removed in this batch are gone along with their node.
+	if (!Batch.Removed.AffectedNodes.IsEmpty() && !Batch.Connections.AffectedPins.IsEmpty())
+	{
+		for (const UHeartGraphNode* RemovedNode : Batch.Removed.AffectedNodes)
+		{
+			if (IsValid(RemovedNode))
+			{
+				RemovedNode->QueryPins().ForEach(
+					[&Batch](const FHeartPinGuid Pin)
+					{
+						Batch.Connections.AffectedPins.Remove(Pin);
+					});
+			}
+		}
+	}
+
+	if (Batch.IsEmpty())
+	{
+		return;
+	}
+
+	// Listeners of the individual events receive one coalesced event of each kind. Removals go first, so that a node
+	// removed and re-added in the same batch ends up in the graph.
+	if (!Batch.Removed.AffectedNodes.IsEmpty())
+	{
+		BroadcastNodeRemoveEvent(Batch.Removed);
+	}
+	if (!Batch.Added.NewNodes.IsEmpty())
+	{
+		BroadcastNodeAddEvent(Batch.Added);
+	}
+	if (!Batch.Connections.AffectedNodes.IsEmpty() || !Batch.Connections.AffectedPins.IsEmpty())
+	{
+		BroadcastGraphConnectionEvent(Batch.Connections);
+	}
+	if (!Batch.Moved.AffectedNodes.IsEmpty())
+	{
+		BroadcastNodeMoveEvent(Batch.Moved);
+	}
+
+	OnBatchEvent.Broadcast(Batch);
+}
+
 UHeartGraphNode* UHeartGraph::GetNode(const FHeartNodeGuid& NodeGuid) const
 {
 	auto&& Result = Nodes.Find(NodeGuid);
@@ -285,6 +524,15 @@ void UHeartGraph::GetNodeArray(TArray<UHeartGraphNode*>& OutNodes) const
 	Nodes.GenerateValueArray(ObjectPtrWrap(OutNodes));
 }
 
+FHeartGraphTopology& UHeartGraph::GetTopology()
+{
+	if (!Topology.IsValid())
+	{
+		Topology = MakeUnique<FHeartGraphTopology>(this);
+	}
+	return *Topology;
+}
+
 TSubclassOf<UHeartGraphSchema> UHeartGraph::GetSchemaClass_Implementation() const
 {
 	return SchemaClass;
@@ -533,13 +781,18 @@ TArray<UHeartGraphNodeComponent*> UHeartGraph::GetNodeComponentsForNode(const FH
 
 	TArray<UHeartGraphNodeComponent*> Out;
 
-	for (auto&& ClassMap : NodeComponents)
+	if (auto&& Classes = GetNodeComponentIndex().Find(Node))
 	{
-		for (auto&& NodeComponent : ClassMap.Value.Components)
+		Out.Reserve(Classes->Num());
+
+		for (auto&& Class : *Classes)
 		{
-			if (NodeComponent.Key == Node)
+			if (const FHeartGraphNodeComponentMap* ClassMap = NodeComponents.Find(Class))
 			{
-				Out.Add(NodeComponent.Value);
+				if (UHeartGraphNodeComponent* Component = ClassMap->Find(Node))
+				{
+					Out.Add(Component);
+				}
 			}
 		}
 	}
@@ -579,6 +832,10 @@ UHeartGraphNodeComponent* UHeartGraph::FindOrAddNodeComponent(const FHeartNodeGu
 	// Create and assign a new component for the node.
 	UHeartGraphNodeComponent* NewComponent =
 		NodeMap.Components.Add(Node, NewObject<UHeartGraphNodeComponent>(this, Class));
+	if (!NodeComponentIndexDirty)
+	{
+		NodeComponentIndex.FindOrAdd(Node).AddUnique(Class);
+	}
 
 	// @todo isn't this redundant, and gets assigned in PostInitProperties?
 	NewComponent->Guid = FHeartExtensionGuid::New();
@@ -603,6 +860,7 @@ bool UHeartGraph::RemoveNodeComponent(const FHeartNodeGuid& Node, const TSubclas
 	{
 		TObjectPtr<UHeartGraphNodeComponent> Component = nullptr;
 		NodeMap->Components.RemoveAndCopyValue(Node, Component);
+		RemoveFromNodeComponentIndex(Node, Class);
 		if (IsValid(Component))
 		{
 			Component->PreComponentRemoved();
@@ -616,21 +874,156 @@ bool UHeartGraph::RemoveNodeComponent(const FHeartNodeGuid& Node, const TSubclas
 
 void UHeartGraph::RemoveComponentsForNode(const FHeartNodeGuid& Node)
 {
-	for (auto&& NodeMap : NodeComponents)
+	for (auto&& Column : StructComponents)
+	{
+		Column.Remove(Node);
+	}
+
+	GetNodeComponentIndex();
+
+	TArray<TSubclassOf<UHeartGraphNodeComponent>> Classes;
+	if (!NodeComponentIndex.RemoveAndCopyValue(Node, Classes))
 	{
-		NodeMap.Value.Components.Remove(Node);
+		return;
+	}
+
+	for (auto&& Class : Classes)
+	{
+		if (FHeartGraphNodeComponentMap* NodeMap = NodeComponents.Find(Class))
+		{
+			NodeMap->Components.Remove(Node);
+		}
 	}
 }
 
 void UHeartGraph::RemoveComponentsForNodes(const TConstArrayView<FHeartNodeGuid> InNodes)
 {
+	for (auto&& Node : InNodes)
+	{
+		RemoveComponentsForNode(Node);
+	}
+}
+
+FHeartNodeStructColumn* UHeartGraph::FindStructColumn(const UScriptStruct* Type)
+{
+	return StructComponents.FindByPredicate(
+		[Type](const FHeartNodeStructColumn& Column)
+		{
+			return Column.GetStructType() == Type;
+		});
+}
+
+const FHeartNodeStructColumn* UHeartGraph::FindStructColumn(const UScriptStruct* Type) const
+{
+	return const_cast<ThisClass*>(this)->FindStructColumn(Type);
+}
+
+FStructView UHeartGraph::FindNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type)
+{
+	if (FHeartNodeStructColumn* Column = FindStructColumn(Type))
+	{
+		return Column->Find(Node);
+	}
+	return FStructView();
+}
+
+FConstStructView UHeartGraph::FindNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type) const
+{
+	if (const FHeartNodeStructColumn* Column = FindStructColumn(Type))
+	{
+		return Column->Find(Node);
+	}
+	return FConstStructView();
+}
+
+FStructView UHeartGraph::FindOrAddNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type)
+{
+	if (!Node.IsValid() ||
+		!IsValid(Type))
+	{
+		return FStructView();
+	}
+
+	FHeartNodeStructColumn* Column = FindStructColumn(Type);
+	if (!Column)
+	{
+		Column = &StructComponents.Emplace_GetRef(Type);
+	}
+
+	return Column->FindOrAdd(Node);
+}
+
+bool UHeartGraph::RemoveNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type)
+{
+	if (FHeartNodeStructColumn* Column = FindStructColumn(Type))
+	{
+		return Column->Remove(Node);
+	}
+	return false;
+}
+
+FInstancedStruct UHeartGraph::GetNodeStruct(const FHeartNodeGuid& Node, UScriptStruct* Type) const
+{
+	if (const FConstStructView View = FindNodeStruct(Node, Type);
+		View.IsValid())
+	{
+		FInstancedStruct Out;
+		Out.InitializeAs(View.GetScriptStruct(), View.GetMemory());
+		return Out;
+	}
+	return FInstancedStruct();
+}
+
+void UHeartGraph::SetNodeStruct(const FHeartNodeGuid& Node, const FInstancedStruct& Value)
+{
+	if (!Value.IsValid())
+	{
+		return;
+	}
+
+	if (const FStructView View = FindOrAddNodeStruct(Node, Value.GetScriptStruct());
+		View.IsValid())
+	{
+		View.GetScriptStruct()->CopyScriptStruct(View.GetMemory(), Value.GetMemory());
+	}
+}
+
+void UHeartGraph::RemoveFromNodeComponentIndex(const FHeartNodeGuid& Node, const TSubclassOf<UHeartGraphNodeComponent> Class)
+{
+	if (NodeComponentIndexDirty)
+	{
+		return;
+	}
+
+	if (auto&& Classes = NodeComponentIndex.Find(Node))
+	{
+		Classes->RemoveSingleSwap(Class);
+		if (Classes->IsEmpty())
+		{
+			NodeComponentIndex.Remove(Node);
+		}
+	}
+}
+
+const TMap<FHeartNodeGuid, TArray<TSubclassOf<UHeartGraphNodeComponent>>>& UHeartGraph::GetNodeComponentIndex() const
+{
+	if (!NodeComponentIndexDirty)
+	{
+		return NodeComponentIndex;
+	}
+
+	NodeComponentIndexDirty = false;
+	NodeComponentIndex.Reset();
+
 	for (auto&& NodeMap : NodeComponents)
 	{
-		for (auto&& Node : InNodes)
+		for (auto&& Component : NodeMap.Value.Components)
 		{
-			NodeMap.Value.Components.Remove(Node);
+			NodeComponentIndex.FindOrAdd(Component.Key).Add(NodeMap.Key);
 		}
 	}
+
+	return NodeComponentIndex;
 }
 
 Heart::API::FPinEdit UHeartGraph::EditConnections()
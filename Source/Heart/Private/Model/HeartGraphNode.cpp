@@ -54,7 +54,10 @@ PRAGMA_DISABLE_DEPRECATION_WARNINGS
 	{
 		for (auto&& Element : PinConnections)
 		{
-			PinData.GetConnectionsMutable(Element.Key) = Element.Value;
+			if (PinData.Contains(Element.Key))
+			{
+				PinData.GetConnectionsMutable(Element.Key) = Element.Value;
+			}
 		}
 		PinConnections.Empty();
 	}
@@ -190,19 +193,10 @@ FHeartGraphPinReference UHeartGraphNode::GetPinReference(const FHeartPinGuid& Pi
 
 FHeartPinGuid UHeartGraphNode::GetPinByName(FName Name) const
 {
-	auto&& RetVal = PinData.Find(
-		[Name](const TPair<FHeartPinGuid, FHeartGraphPinDesc>& Desc) -> TOptional<FHeartPinGuid>
-		{
-			if (Desc.Value.Name == Name)
-			{
-				return Desc.Key;
-			}
-			return NullOpt;
-		});
-
-	if (RetVal.IsSet())
+	if (const int32 Index = PinData.FindIndexByName(Name);
+		Index != INDEX_NONE)
 	{
-		return RetVal.GetValue();
+		return PinData.PinGuids[Index];
 	}
 
 	return FHeartPinGuid();
@@ -372,6 +366,19 @@ bool UHeartGraphNode::RemovePin(const FHeartPinGuid& Pin)
 	return false;
 }
 
+int32 UHeartGraphNode::RemovePins(const TConstArrayView<FHeartPinGuid> Pins)
+{
+	const int32 NumRemoved = PinData.RemovePins(Pins);
+
+	if (NumRemoved > 0)
+	{
+		OnNodePinsChanged_Native.Broadcast(this);
+		OnNodePinsChanged.Broadcast(this);
+	}
+
+	return NumRemoved;
+}
+
 FHeartGraphPinDesc UHeartGraphNode::MakeInstancedPin(const EHeartPinDirection Direction)
 {
 	FHeartGraphPinDesc PinDesc;
@@ -456,9 +463,11 @@ void UHeartGraphNode::OnCreate(UObject* NodeSpawningContext)
 
 bool UHeartGraphNode::ReconstructPins(const bool IsCreation)
 {
-	TArray<FHeartGraphPinDesc> GatheredPins;
-	GatheredPins.Append(GetDefaultPins());
-	GatheredPins.Append(CreateDynamicPins());
+	// Default pins are read straight from the class's sparse data, which is shared by every node of the class, instead
+	// of copying them out first.
+	const TArray<FHeartGraphPinDesc>& DefaultPins = GetHeartGraphNodeSparseClassData()->DefaultPins;
+
+	TArray<FHeartGraphPinDesc> GatheredPins = CreateDynamicPins();
 
 	// Instanced pins (@todo move to node component)
 	{
@@ -467,6 +476,8 @@ bool UHeartGraphNode::ReconstructPins(const bool IsCreation)
 		InstancedInputs = 0;
 		InstancedOutputs = 0;
 
+		GatheredPins.Reserve(GatheredPins.Num() + InstancedInputNum + InstancedOutputNum);
+
 		// Create instanced inputs
 		for (uint8 i = 0; i < InstancedInputNum; ++i)
 		{
@@ -480,66 +491,86 @@ bool UHeartGraphNode::ReconstructPins(const bool IsCreation)
 		}
 	}
 
+	// Default pins come first, followed by the gathered ones.
+	const int32 NumDefault = DefaultPins.Num();
+	const int32 NumTotal = NumDefault + GatheredPins.Num();
+	auto GetPin = [&](const int32 Index) -> const FHeartGraphPinDesc&
+		{
+			return Index < NumDefault ? DefaultPins[Index] : GatheredPins[Index - NumDefault];
+		};
+
 	if (IsCreation)
 	{
-		// Create all pins
-		for (auto&& Pin : GatheredPins)
+		// Create all pins, but only announce the change once.
+		for (int32 i = 0; i < NumTotal; ++i)
 		{
-			AddPin(Pin);
+			if (ensure(GetPin(i).IsValid()))
+			{
+				PinData.AddPin(FHeartPinGuid::New(), GetPin(i));
+			}
+		}
+
+		if (NumTotal > 0)
+		{
+			OnNodePinsChanged_Native.Broadcast(this);
+			OnNodePinsChanged.Broadcast(this);
 		}
 		return true;
 	}
 	else
 	{
+		// Hash join existing pins against the wanted ones by name. Wanted pins with the same name are chained in order,
+		// so each existing pin claims the first unclaimed wanted pin with its name.
+		TMap<FName, int32> FirstWithName;
+		FirstWithName.Reserve(NumTotal);
+		TArray<int32> NextWithName;
+		NextWithName.SetNumUninitialized(NumTotal);
+
+		for (int32 i = NumTotal - 1; i >= 0; --i)
+		{
+			int32& Head = FirstWithName.FindOrAdd(GetPin(i).Name, INDEX_NONE);
+			NextWithName[i] = Head;
+			Head = i;
+		}
+
+		TBitArray<> Claimed(false, NumTotal);
 		TArray<FHeartPinGuid> DiscardedPins;
 
-		// Iterate over existing pins and remove the ones we already have from GatheredPins, or discard them
-		for (auto&& ExistingPin : PinData.PinDescriptions)
+		for (int32 i = 0; i < PinData.Num(); ++i)
 		{
-			bool Found = false;
-
-			for (auto It = GatheredPins.CreateIterator(); It; ++It)
+			int32* Head = FirstWithName.Find(PinData.PinDescs[i].Name);
+			if (Head && *Head != INDEX_NONE)
 			{
-				auto&& GatheredPin = *It;
-				if (GatheredPin.Name == ExistingPin.Value.Name)
-				{
-					ExistingPin.Value = GatheredPin; // Overwrite anyway, to update other info that may have changed.
-					// @todo should we do anything about metadata?
-					It.RemoveCurrent();
-					Found = true;
-					break;
-				}
+				PinData.PinDescs[i] = GetPin(*Head); // Overwrite anyway, to update other info that may have changed.
+				// @todo should we do anything about metadata?
+				Claimed[*Head] = true;
+				*Head = NextWithName[*Head];
 			}
-
-			if (!Found)
+			else
 			{
 				// A pin with this name was not gathered, remove it.
-				DiscardedPins.Add(ExistingPin.Key);
+				DiscardedPins.Add(PinData.PinGuids[i]);
 			}
 		}
 
-		bool Modified = false;
+		// These pins exist, but shouldn't. They are removed in one pass, with a single reindex.
+		bool Modified = PinData.RemovePins(DiscardedPins) > 0;
 
-		if (!GatheredPins.IsEmpty())
+		// The unclaimed pins do not exist, but should
+		for (int32 i = 0; i < NumTotal; ++i)
 		{
-			// The remaining pins in Gathered do not exist, but should
-			for (auto&& GatheredPin : GatheredPins)
+			if (!Claimed[i] && ensure(GetPin(i).IsValid()))
 			{
-				AddPin(GatheredPin);
+				PinData.AddPin(FHeartPinGuid::New(), GetPin(i));
+				Modified = true;
 			}
-
-			Modified |= true;
 		}
 
-		if (!DiscardedPins.IsEmpty())
+		// Announce all changes at once.
+		if (Modified)
 		{
-			// These pins exist, but shouldn't
-			for (auto&& DiscardedPin : DiscardedPins)
-			{
-				RemovePin(DiscardedPin);
-			}
-
-			Modified |= true;
+			OnNodePinsChanged_Native.Broadcast(this);
+			OnNodePinsChanged.Broadcast(this);
 		}
 
 		return Modified;
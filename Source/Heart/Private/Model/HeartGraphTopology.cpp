@@ -0,0 +1,419 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Model/HeartGraphTopology.h"
+#include "Model/HeartGraph.h"
+#include "Model/HeartGraphNode.h"
+#include "Model/HeartGraphUtils.h"
+#include "Algo/Reverse.h"
+
+FHeartGraphTopology::FHeartGraphTopology(UHeartGraph* InGraph)
+  : Graph(InGraph)
+{
+	check(Graph);
+
+	Rebuild();
+
+	Graph->GetOnNodeAdded().AddRaw(this, &FHeartGraphTopology::HandleNodeAdded);
+	Graph->GetOnNodeRemoved().AddRaw(this, &FHeartGraphTopology::HandleNodeRemoved);
+	Graph->GetOnNodeConnectionsChanged().AddRaw(this, &FHeartGraphTopology::HandleConnectionsChanged);
+}
+
+void FHeartGraphTopology::Rebuild()
+{
+	Guids.Reset(Graph->GetNodes().Num());
+	Indices.Reset();
+	Indices.Reserve(Graph->GetNodes().Num());
+	DirtyRows.Reset();
+	PreviousRows.Reset();
+	RowRemap.Reset();
+
+	for (auto&& Element : Graph->GetNodes())
+	{
+		AddNode(Element.Key);
+	}
+
+	// Set even when there are no nodes, so the next update still replaces the previous outputs, and bumps the version.
+	AnyDirty = true;
+}
+
+int32 FHeartGraphTopology::FindIndex(const FHeartNodeGuid& Node) const
+{
+	const int32* Index = Indices.Find(Node);
+	return Index ? *Index : INDEX_NONE;
+}
+
+Nodesoup::FGraphView FHeartGraphTopology::GetOutputs()
+{
+	Update();
+	return Outputs;
+}
+
+Nodesoup::FGraphView FHeartGraphTopology::GetInputs()
+{
+	Update();
+	UpdateInputs();
+	return Inputs;
+}
+
+void FHeartGraphTopology::ForEachLinked(const int32 Index, const EHeartPinDirection Direction,
+										const TFunctionRef<void(int32 Linked)> Visitor)
+{
+	Update();
+
+	if (EnumHasAnyFlags(Direction, EHeartPinDirection::Output))
+	{
+		for (const int32 Linked : Nodesoup::FGraphView(Outputs)[Index])
+		{
+			Visitor(Linked);
+		}
+	}
+
+	if (EnumHasAnyFlags(Direction, EHeartPinDirection::Input))
+	{
+		UpdateInputs();
+		for (const int32 Linked : Nodesoup::FGraphView(Inputs)[Index])
+		{
+			Visitor(Linked);
+		}
+	}
+}
+
+void FHeartGraphTopology::BreadthFirst(const int32 Start, const EHeartPinDirection Direction,
+									   const TFunctionRef<bool(int32 Index, int32 Depth)> Visitor)
+{
+	if (!ensure(Guids.IsValidIndex(Start)))
+	{
+		return;
+	}
+
+	ResetVisited();
+	Frontier.Reset();
+	Frontier.Add(Start);
+	MarkVisited(Start);
+
+	// Frontier is used as a queue, with each depth ending where the next one begins.
+	int32 Depth = 0;
+	int32 DepthEnd = Frontier.Num();
+
+	for (int32 Head = 0; Head < Frontier.Num(); ++Head)
+	{
+		if (Head == DepthEnd)
+		{
+			++Depth;
+			DepthEnd = Frontier.Num();
+		}
+
+		const int32 Index = Frontier[Head];
+		if (!Visitor(Index, Depth))
+		{
+			return;
+		}
+
+		ForEachLinked(Index, Direction,
+			[this](const int32 Linked)
+			{
+				if (MarkVisited(Linked))
+				{
+					Frontier.Add(Linked);
+				}
+			});
+	}
+}
+
+void FHeartGraphTopology::DepthFirst(const int32 Start, const EHeartPinDirection Direction,
+									 const TFunctionRef<bool(int32 Index)> Visitor)
+{
+	if (!ensure(Guids.IsValidIndex(Start)))
+	{
+		return;
+	}
+
+	ResetVisited();
+	Frontier.Reset();
+	Frontier.Add(Start);
+
+	// Frontier is used as a stack. Nodes are marked when popped rather than when pushed, so they are visited in the
+	// order a recursive search would visit them. Each node may be pushed once per link leading to it.
+	while (!Frontier.IsEmpty())
+	{
+		const int32 Index = Frontier.Pop(EAllowShrinking::No);
+		if (!MarkVisited(Index))
+		{
+			continue;
+		}
+
+		if (!Visitor(Index))
+		{
+			return;
+		}
+
+		// Push links in reverse, so the first link is searched first.
+		const int32 FirstPushed = Frontier.Num();
+		ForEachLinked(Index, Direction,
+			[this](const int32 Linked)
+			{
+				if (VisitEpochs[Linked] != VisitEpoch)
+				{
+					Frontier.Add(Linked);
+				}
+			});
+		Algo::Reverse(Frontier.GetData() + FirstPushed, Frontier.Num() - FirstPushed);
+	}
+}
+
+bool FHeartGraphTopology::IsReachable(const int32 From, const int32 To, const EHeartPinDirection Direction)
+{
+	if (!Guids.IsValidIndex(From) || !Guids.IsValidIndex(To))
+	{
+		return false;
+	}
+
+	bool Found = false;
+	BreadthFirst(From, Direction,
+		[To, &Found](const int32 Index, int32)
+		{
+			Found = Index == To;
+			return !Found;
+		});
+	return Found;
+}
+
+bool FHeartGraphTopology::TopologicalSort(TArray<int32>& OutOrder)
+{
+	Update();
+	UpdateInputs();
+
+	const Nodesoup::FGraphView OutputsView = Outputs;
+	const Nodesoup::FGraphView InputsView = Inputs;
+	const int32 Num = Guids.Num();
+
+	// Kahn's algorithm, using OutOrder as the queue, and Frontier for the number of unsorted inputs left per node.
+	OutOrder.Reset(Num);
+	Frontier.SetNumUninitialized(Num, EAllowShrinking::No);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Frontier[Index] = InputsView[Index].Num();
+		if (Frontier[Index] == 0)
+		{
+			OutOrder.Add(Index);
+		}
+	}
+
+	for (int32 Head = 0; Head < OutOrder.Num(); ++Head)
+	{
+		for (const int32 Output : OutputsView[OutOrder[Head]])
+		{
+			if (--Frontier[Output] == 0)
+			{
+				OutOrder.Add(Output);
+			}
+		}
+	}
+
+	return OutOrder.Num() == Num;
+}
+
+void FHeartGraphTopology::HandleNodeAdded(UHeartGraphNode* Node)
+{
+	if (!IsValid(Node) || Indices.Contains(Node->GetGuid()))
+	{
+		return;
+	}
+
+	AddNode(Node->GetGuid());
+
+	// Nodes may be added with their connections already in place, in which case the outputs of the nodes linking to
+	// them have changed as well.
+	for (auto&& InputNode : Heart::Utils::GetConnectedNodes(Graph, Node->GetGuid(), EHeartPinDirection::Input))
+	{
+		MarkDirty(InputNode);
+	}
+}
+
+void FHeartGraphTopology::HandleNodeRemoved(UHeartGraphNode* Node)
+{
+	if (!IsValid(Node))
+	{
+		return;
+	}
+
+	int32 Index;
+	if (!Indices.RemoveAndCopyValue(Node->GetGuid(), Index))
+	{
+		return;
+	}
+
+	if (PreviousRows[Index] != INDEX_NONE)
+	{
+		RowRemap[PreviousRows[Index]] = INDEX_NONE;
+	}
+
+	// Move the last node into the hole, so indices stay dense.
+	if (const int32 LastIndex = Guids.Num() - 1;
+		Index != LastIndex)
+	{
+		Guids[Index] = Guids[LastIndex];
+		Indices[Guids[Index]] = Index;
+		DirtyRows[Index] = DirtyRows[LastIndex];
+		PreviousRows[Index] = PreviousRows[LastIndex];
+
+		if (PreviousRows[Index] != INDEX_NONE)
+		{
+			RowRemap[PreviousRows[Index]] = Index;
+		}
+	}
+
+	Guids.Pop(EAllowShrinking::No);
+	DirtyRows.RemoveAt(DirtyRows.Num() - 1);
+	PreviousRows.Pop(EAllowShrinking::No);
+
+	// Rows that linked to the removed node drop it when remapped, so they don't need to be gathered again.
+	AnyDirty = true;
+}
+
+void FHeartGraphTopology::HandleConnectionsChanged(const FHeartGraphConnectionEvent& Event)
+{
+	for (auto&& Node : Event.AffectedNodes)
+	{
+		if (IsValid(Node))
+		{
+			MarkDirty(Node->GetGuid());
+		}
+	}
+}
+
+void FHeartGraphTopology::AddNode(const FHeartNodeGuid& Node)
+{
+	Indices.Add(Node, Guids.Add(Node));
+	DirtyRows.Add(true);
+	PreviousRows.Add(INDEX_NONE);
+	AnyDirty = true;
+}
+
+void FHeartGraphTopology::MarkDirty(const FHeartNodeGuid& Node)
+{
+	if (const int32* Index = Indices.Find(Node))
+	{
+		DirtyRows[*Index] = true;
+		AnyDirty = true;
+	}
+}
+
+void FHeartGraphTopology::Update()
+{
+	if (!AnyDirty)
+	{
+		return;
+	}
+
+	Swap(Outputs, ScratchOutputs);
+	const Nodesoup::FGraphView PreviousOutputs = ScratchOutputs;
+
+	Outputs.Reset();
+	Outputs.Offsets.Reserve(Guids.Num() + 1);
+	Outputs.Indices.Reserve(ScratchOutputs.Indices.Num());
+
+	for (int32 Index = 0; Index < Guids.Num(); ++Index)
+	{
+		if (DirtyRows[Index])
+		{
+			for (auto&& OutputNode : Heart::Utils::GetConnectedNodes(Graph, Guids[Index], EHeartPinDirection::Output))
+			{
+				if (const int32* OutputIndex = Indices.Find(OutputNode))
+				{
+					Outputs.Indices.Add(*OutputIndex);
+				}
+			}
+		}
+		else
+		{
+			// Unchanged rows are copied from the previous outputs, with indices remapped past any removals.
+			for (const int32 PreviousIndex : PreviousOutputs[PreviousRows[Index]])
+			{
+				if (const int32 OutputIndex = RowRemap[PreviousIndex];
+					OutputIndex != INDEX_NONE)
+				{
+					Outputs.Indices.Add(OutputIndex);
+				}
+			}
+		}
+
+		Outputs.FinishVertex();
+	}
+
+	DirtyRows.Init(false, Guids.Num());
+	AnyDirty = false;
+
+	PreviousRows.SetNumUninitialized(Guids.Num());
+	RowRemap.SetNumUninitialized(Guids.Num());
+	for (int32 Index = 0; Index < Guids.Num(); ++Index)
+	{
+		PreviousRows[Index] = Index;
+		RowRemap[Index] = Index;
+	}
+
+	++Version;
+}
+
+void FHeartGraphTopology::UpdateInputs()
+{
+	if (InputsVersion == Version)
+	{
+		return;
+	}
+
+	const Nodesoup::FGraphView OutputsView = Outputs;
+	const int32 Num = OutputsView.Num();
+
+	// Count the inputs of each node, and sum them so each offset is the end of its row. Filling rows back to front
+	// then leaves each offset at the start of its row, with rows sorted by source index.
+	Inputs.Offsets.SetNumUninitialized(Num + 1, EAllowShrinking::No);
+	FMemory::Memzero(Inputs.Offsets.GetData(), Inputs.Offsets.Num() * sizeof(int32));
+	for (const int32 Output : Outputs.Indices)
+	{
+		++Inputs.Offsets[Output];
+	}
+	for (int32 Index = 1; Index < Num; ++Index)
+	{
+		Inputs.Offsets[Index] += Inputs.Offsets[Index - 1];
+	}
+	Inputs.Offsets[Num] = Outputs.Indices.Num();
+
+	Inputs.Indices.SetNumUninitialized(Outputs.Indices.Num(), EAllowShrinking::No);
+	for (int32 Index = Num - 1; Index >= 0; --Index)
+	{
+		for (const int32 Output : OutputsView[Index])
+		{
+			Inputs.Indices[--Inputs.Offsets[Output]] = Index;
+		}
+	}
+
+	InputsVersion = Version;
+}
+
+void FHeartGraphTopology::ResetVisited()
+{
+	Update();
+
+	if (VisitEpochs.Num() != Guids.Num())
+	{
+		VisitEpochs.SetNumZeroed(Guids.Num(), EAllowShrinking::No);
+	}
+
+	// On wrap-around, old stamps could match the new epoch, so clear them.
+	if (++VisitEpoch == 0)
+	{
+		FMemory::Memzero(VisitEpochs.GetData(), VisitEpochs.Num() * sizeof(uint32));
+		VisitEpoch = 1;
+	}
+}
+
+bool FHeartGraphTopology::MarkVisited(const int32 Index)
+{
+	if (VisitEpochs[Index] == VisitEpoch)
+	{
+		return false;
+	}
+	VisitEpochs[Index] = VisitEpoch;
+	return true;
+}
\ No newline at end of file
@@ -55,6 +55,24 @@ namespace Heart::API
 		return NewGraphNode;
 	}
 
+	FGraphBatch::FGraphBatch(IHeartGraphInterface* GraphInterface)
+	{
+		if (ensureAlways(GraphInterface))
+		{
+			Graph = GraphInterface->GetHeartGraph();
+			checkSlow(IsValid(Graph))
+			Graph->BeginBatch();
+		}
+	}
+
+	FGraphBatch::~FGraphBatch()
+	{
+		if (IsValid(Graph))
+		{
+			Graph->EndBatch();
+		}
+	}
+
 	FNodeEdit::FNodeEdit(IHeartGraphInterface* GraphInterface)
 	{
 		if (ensureAlways(GraphInterface))
@@ -84,6 +102,8 @@ namespace Heart::API
 			return false;
 		}
 
+		FGraphBatch Batch(GraphPtr);
+
 		GraphPtr->RemoveComponentsForNode(Node);
 
 		FPinEdit(GraphPtr).DisconnectAll(Node);
@@ -164,6 +184,14 @@ namespace Heart::API
 
 	void FNodeEdit::HandlePending()
 	{
+		if (PendingDeletes.IsEmpty() && PendingCreates.IsEmpty())
+		{
+			return;
+		}
+
+		// Deleting nodes sends a connection event and a remove event; announce them together with any creations.
+		FGraphBatch Batch(Graph);
+
 		if (!PendingDeletes.IsEmpty())
 		{
 			// Pending delete pass 0: Verify and clean
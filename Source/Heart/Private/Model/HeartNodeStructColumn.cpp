@@ -0,0 +1,263 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Model/HeartNodeStructColumn.h"
+#include "Model/HeartGraph.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HeartNodeStructColumn)
+
+FHeartNodeStructColumn::FHeartNodeStructColumn(const UScriptStruct* InStructType)
+{
+	SetStructType(InStructType);
+}
+
+FHeartNodeStructColumn::FHeartNodeStructColumn(const FHeartNodeStructColumn& Other)
+{
+	*this = Other;
+}
+
+FHeartNodeStructColumn& FHeartNodeStructColumn::operator=(const FHeartNodeStructColumn& Other)
+{
+	if (this == &Other)
+	{
+		return *this;
+	}
+
+	Release();
+	SetStructType(Other.StructType);
+
+	Nodes = Other.Nodes;
+	Indices = Other.Indices;
+
+	if (StructType && !Nodes.IsEmpty())
+	{
+		Grow(Nodes.Num());
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			StructType->InitializeStruct(GetData(i));
+			StructType->CopyScriptStruct(GetData(i), Other.GetData(i));
+		}
+	}
+
+	return *this;
+}
+
+FHeartNodeStructColumn::~FHeartNodeStructColumn()
+{
+	Release();
+}
+
+FStructView FHeartNodeStructColumn::Find(const FHeartNodeGuid& Node)
+{
+	if (const int32* Index = Indices.Find(Node))
+	{
+		return GetAt(*Index);
+	}
+	return FStructView();
+}
+
+FConstStructView FHeartNodeStructColumn::Find(const FHeartNodeGuid& Node) const
+{
+	if (const int32* Index = Indices.Find(Node))
+	{
+		return GetAt(*Index);
+	}
+	return FConstStructView();
+}
+
+FStructView FHeartNodeStructColumn::FindOrAdd(const FHeartNodeGuid& Node)
+{
+	if (!ensure(StructType) || !Node.IsValid())
+	{
+		return FStructView();
+	}
+
+	if (const int32* Index = Indices.Find(Node))
+	{
+		return GetAt(*Index);
+	}
+
+	const int32 NewIndex = Nodes.Add(Node);
+	Indices.Add(Node, NewIndex);
+
+	if (NewIndex >= Capacity)
+	{
+		Grow(NewIndex + 1);
+	}
+
+	StructType->InitializeStruct(GetData(NewIndex));
+	return GetAt(NewIndex);
+}
+
+bool FHeartNodeStructColumn::Remove(const FHeartNodeGuid& Node)
+{
+	int32 Index;
+	if (!Indices.RemoveAndCopyValue(Node, Index))
+	{
+		return false;
+	}
+
+	StructType->DestroyStruct(GetData(Index));
+
+	// Fill the hole with the last component, to keep the array dense.
+	const int32 LastIndex = Nodes.Num() - 1;
+	if (Index != LastIndex)
+	{
+		FMemory::Memcpy(GetData(Index), GetData(LastIndex), StructType->GetStructureSize());
+		Indices[Nodes[LastIndex]] = Index;
+	}
+
+	Nodes.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	return true;
+}
+
+void FHeartNodeStructColumn::Empty()
+{
+	const UScriptStruct* Type = StructType;
+	Release();
+	SetStructType(Type);
+}
+
+FStructView FHeartNodeStructColumn::GetAt(const int32 Index)
+{
+	check(Nodes.IsValidIndex(Index));
+	return FStructView(const_cast<UScriptStruct*>(StructType.Get()), GetData(Index));
+}
+
+FConstStructView FHeartNodeStructColumn::GetAt(const int32 Index) const
+{
+	check(Nodes.IsValidIndex(Index));
+	return FConstStructView(StructType, GetData(Index));
+}
+
+bool FHeartNodeStructColumn::Serialize(FArchive& Ar)
+{
+	UScriptStruct* Type = const_cast<UScriptStruct*>(StructType.Get());
+	Ar << Type;
+
+	if (Ar.IsLoading())
+	{
+		Release();
+		SetStructType(Type);
+	}
+
+	Ar << Nodes;
+
+	// Components are prefixed with their total size, so they can be skipped if the struct type no longer exists. They
+	// are serialized through the outer archive, so object references stay visible to linkers, cooking, and reference
+	// collection. The size is patched in after writing, on archives that track their position. Others write no size.
+	int64 SerialSize = INDEX_NONE;
+	const int64 SizeOffset = Ar.Tell();
+	Ar << SerialSize;
+	const int64 DataStart = Ar.Tell();
+
+	if (Ar.IsLoading())
+	{
+		if (!StructType)
+		{
+			if (SerialSize != INDEX_NONE && DataStart != INDEX_NONE)
+			{
+				Ar.Seek(DataStart + SerialSize);
+			}
+			else if (!Nodes.IsEmpty())
+			{
+				UE_LOG(LogHeartGraph, Error, TEXT("Struct column type is missing, and its components cannot be skipped!"))
+				Ar.SetError();
+			}
+			Nodes.Empty();
+			return true;
+		}
+
+		Grow(Nodes.Num());
+		Indices.Reserve(Nodes.Num());
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			Indices.Add(Nodes[i], i);
+			StructType->InitializeStruct(GetData(i));
+			StructType->SerializeItem(Ar, GetData(i), nullptr);
+		}
+	}
+	else if (StructType)
+	{
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			StructType->SerializeItem(Ar, GetData(i), nullptr);
+		}
+
+		if (Ar.IsSaving() && SizeOffset != INDEX_NONE && DataStart != INDEX_NONE)
+		{
+			const int64 DataEnd = Ar.Tell();
+			SerialSize = DataEnd - DataStart;
+			Ar.Seek(SizeOffset);
+			Ar << SerialSize;
+			Ar.Seek(DataEnd);
+		}
+	}
+
+	return true;
+}
+
+bool FHeartNodeStructColumn::Identical(const FHeartNodeStructColumn* Other, const uint32 PortFlags) const
+{
+	if (!Other || StructType != Other->StructType || Nodes.Num() != Other->Nodes.Num())
+	{
+		return false;
+	}
+
+	// Dense order depends on removal history, so components are matched by node.
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		const int32* OtherIndex = Other->Indices.Find(Nodes[i]);
+		if (!OtherIndex || !StructType->CompareScriptStruct(GetData(i), Other->GetData(*OtherIndex), PortFlags))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FHeartNodeStructColumn::AddStructReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(StructType);
+
+	if (StructType)
+	{
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			Collector.AddPropertyReferencesWithStructARO(StructType, GetData(i));
+		}
+	}
+}
+
+void FHeartNodeStructColumn::SetStructType(const UScriptStruct* InStructType)
+{
+	StructType = InStructType;
+	Stride = StructType ? Align(StructType->GetStructureSize(), StructType->GetMinAlignment()) : 0;
+}
+
+void FHeartNodeStructColumn::Grow(const int32 MinCapacity)
+{
+	if (MinCapacity <= Capacity || !StructType)
+	{
+		return;
+	}
+
+	const int32 NewCapacity = FMath::Max(MinCapacity, Capacity * 2);
+	Memory = static_cast<uint8*>(FMemory::Realloc(Memory, static_cast<SIZE_T>(NewCapacity) * Stride, StructType->GetMinAlignment()));
+	Capacity = NewCapacity;
+}
+
+void FHeartNodeStructColumn::Release()
+{
+	if (StructType && Memory)
+	{
+		StructType->DestroyStruct(Memory, Nodes.Num());
+	}
+
+	FMemory::Free(Memory);
+	Memory = nullptr;
+	Capacity = 0;
+	Nodes.Empty();
+	Indices.Empty();
+}
\ No newline at end of file
@@ -6,6 +6,76 @@
 
 namespace Heart::API
 {
+	void FPinEdit::FDelta::Record(const bool Connected, const FHeartGraphPinReference& A, const FHeartGraphPinReference& B)
+	{
+		UpdateLookups();
+
+		TArray<FLink>& To = Connected ? Added : Removed;
+		TArray<FLink>& Other = Connected ? Removed : Added;
+		TMap<FLink, int32>& ToLookup = Connected ? AddedLookup : RemovedLookup;
+		TMap<FLink, int32>& OtherLookup = Connected ? RemovedLookup : AddedLookup;
+
+		const FLink Link{A, B};
+
+		// A link broken after being made by the same edit (or the reverse) is no change at all.
+		if (int32 Index;
+			OtherLookup.RemoveAndCopyValue(Link, Index))
+		{
+			Other.RemoveAtSwap(Index, EAllowShrinking::No);
+			if (Other.IsValidIndex(Index))
+			{
+				OtherLookup[Other[Index]] = Index;
+			}
+			return;
+		}
+
+		if (!ToLookup.Contains(Link))
+		{
+			ToLookup.Add(Link, To.Add(Link));
+		}
+	}
+
+	void FPinEdit::FDelta::UpdateLookups()
+	{
+		if (AddedLookup.Num() == Added.Num() && RemovedLookup.Num() == Removed.Num())
+		{
+			return;
+		}
+
+		AddedLookup.Reset();
+		RemovedLookup.Reset();
+		for (int32 i = 0; i < Added.Num(); ++i)
+		{
+			AddedLookup.Add(Added[i], i);
+		}
+		for (int32 i = 0; i < Removed.Num(); ++i)
+		{
+			RemovedLookup.Add(Removed[i], i);
+		}
+	}
+
+	FPinEdit::FDelta FPinEdit::FDelta::Inverse() const
+	{
+		FDelta Out;
+		Out.Added = Removed;
+		Out.Removed = Added;
+		return Out;
+	}
+
+	FArchive& operator<<(FArchive& Ar, FPinEdit::FDelta& V)
+	{
+		int32 Version = FPinEdit::FDelta::LatestVersion;
+		Ar << Version;
+
+		if (Version > FPinEdit::FDelta::LatestVersion)
+		{
+			Ar.SetError();
+			return Ar;
+		}
+
+		return Ar << V.Added << V.Removed;
+	}
+
 	FPinEdit::FPinEdit(UHeartGraphNode* Node)
 	  : Graph(Node->GetGraph()) {}
 
@@ -39,12 +109,17 @@ namespace Heart::API
 		}
 
 		// Add to both lists
-		ANode->PinData.AddConnection(PinA.PinGuid, PinB);
-		BNode->PinData.AddConnection(PinB.PinGuid, PinA);
+		const bool AddedA = ANode->PinData.AddConnection(PinA.PinGuid, PinB);
+		const bool AddedB = BNode->PinData.AddConnection(PinB.PinGuid, PinA);
 
 		ChangedPins.Add(ANode, PinA.PinGuid);
 		ChangedPins.Add(BNode, PinB.PinGuid);
 
+		if (Recording && (AddedA || AddedB))
+		{
+			Recording->Record(true, PinA, PinB);
+		}
+
 		return *this;
 	}
 
@@ -88,7 +163,7 @@ namespace Heart::API
 			return *this;
 		}
 
-		for (auto ConnectionsCopy = Node->PinData.PinConnections;
+		for (auto ConnectionsCopy = Node->PinData.GetAllConnections();
 			 auto&& Element : ConnectionsCopy)
 		{
 			const FHeartGraphPinReference This = {NodeGuid, Element.Key};
@@ -105,7 +180,7 @@ namespace Heart::API
 	FPinEdit& FPinEdit::Override(const FHeartGraphPinReference& Pin, const FHeartGraphPinConnections& Connections)
 	{
 		UHeartGraphNode* ANode = Graph->GetNode(Pin.NodeGuid);
-		if (!ensure(IsValid(ANode)))
+		if (!ensure(IsValid(ANode)) || !ensure(ANode->PinData.Contains(Pin.PinGuid)))
 		{
 			return *this;
 		}
@@ -126,7 +201,7 @@ namespace Heart::API
 		}
 
 		// Memento for self
-		OutMementos.Add(Pin.NodeGuid).PinConnections = Node->PinData.PinConnections;
+		OutMementos.Add(Pin.NodeGuid).PinConnections = Node->PinData.GetAllConnections();
 
 		// Mementos for all connected pins
 		if (auto&& Connections = Node->PinData.ViewConnections(Pin.PinGuid);
@@ -134,7 +209,7 @@ namespace Heart::API
 		{
 			for (const FHeartGraphPinReference& Link : Connections.Get())
 			{
-				OutMementos.Add(Link.NodeGuid).PinConnections = Graph->GetNode(Link.NodeGuid)->PinData.PinConnections;
+				OutMementos.Add(Link.NodeGuid).PinConnections = Graph->GetNode(Link.NodeGuid)->PinData.GetAllConnections();
 			}
 		}
 
@@ -150,15 +225,15 @@ namespace Heart::API
 		}
 
 		// Memento for this pin
-		OutMementos.Add(NodeGuid).PinConnections = Node->PinData.PinConnections;
+		OutMementos.Add(NodeGuid).PinConnections = Node->PinData.GetAllConnections();
 
-		for (auto&& Connections = Node->PinData.PinConnections;
+		for (auto&& Connections = Node->PinData.GetAllConnections();
 			 auto&& Element : Connections)
 		{
 			// Mementos for all connected pins
 			for (const FHeartGraphPinReference& Link : Element.Value)
 			{
-				OutMementos.Add(Link.NodeGuid).PinConnections = Graph->GetNode(Link.NodeGuid)->PinData.PinConnections;
+				OutMementos.Add(Link.NodeGuid).PinConnections = Graph->GetNode(Link.NodeGuid)->PinData.GetAllConnections();
 			}
 		}
 
@@ -176,15 +251,15 @@ namespace Heart::API
 			}
 
 			// Mark all pins as changed, we have no idea what the memento will remove.
-			for (auto&& Element : ANode->PinData.PinConnections)
+			for (auto&& Element : ANode->PinData.GetAllConnections())
 			{
 				ChangedPins.Add(ANode, Element.Key);
 			}
 
-			ANode->PinData.PinConnections = PinAndMemento.Value.PinConnections;
+			ANode->PinData.SetAllConnections(PinAndMemento.Value.PinConnections);
 
 			// Mark all pins as changed again, as we have no idea what the memento has restored.
-			for (auto&& Element : ANode->PinData.PinConnections)
+			for (auto&& Element : PinAndMemento.Value.PinConnections)
 			{
 				ChangedPins.Add(ANode, Element.Key);
 			}
@@ -192,14 +267,48 @@ namespace Heart::API
 		return *this;
 	}
 
+	FPinEdit& FPinEdit::RecordDelta(FDelta& OutDelta)
+	{
+		Recording = &OutDelta;
+		return *this;
+	}
+
+	FPinEdit& FPinEdit::ApplyDelta(const FDelta& Delta)
+	{
+		Internal_ApplyLinks(Delta.Removed, Delta.Added);
+		return *this;
+	}
+
+	FPinEdit& FPinEdit::RevertDelta(const FDelta& Delta)
+	{
+		Internal_ApplyLinks(Delta.Added, Delta.Removed);
+		return *this;
+	}
+
+	void FPinEdit::Internal_ApplyLinks(const TConstArrayView<FDelta::FLink> Removes, const TConstArrayView<FDelta::FLink> Adds)
+	{
+		for (const FDelta::FLink& Link : Removes)
+		{
+			Disconnect(Link.A, Link.B);
+		}
+
+		for (const FDelta::FLink& Link : Adds)
+		{
+			Connect(Link.A, Link.B);
+		}
+	}
+
 	void FPinEdit::Internal_Disconnect(UHeartGraphNode* NodeA, const FHeartGraphPinReference& PinA,
 									UHeartGraphNode* NodeB, const FHeartGraphPinReference& PinB)
 	{
+		bool Removed = false;
+
 		if (IsValid(NodeA))
 		{
 			if (NodeA->PinData.RemoveConnection(PinA.PinGuid, PinB))
 			{
 				ChangedPins.Add(NodeA, PinA.PinGuid);
+				Removed = true;
 			}
 		}
 
@@ -208,7 +317,13 @@ namespace Heart::API
 			if (NodeB->PinData.RemoveConnection(PinB.PinGuid, PinA))
 			{
 				ChangedPins.Add(NodeB, PinB.PinGuid);
+				Removed = true;
 			}
 		}
+
+		if (Recording && Removed)
+		{
+			Recording->Record(false, PinA, PinB);
+		}
 	}
 }
\ No newline at end of file
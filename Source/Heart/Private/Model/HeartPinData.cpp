@@ -4,108 +4,346 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartPinData)
 
+namespace Heart::PinData
+{
+	// The index is kept at most half full, so probe sequences stay short.
+	static int32 GetIndexCapacity(const int32 NumPins)
+	{
+		return static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(NumPins * 2, 8))));
+	}
+}
+
+void FHeartNodePinData::PostSerialize(const FArchive& Ar)
+{
+	if (Ar.IsLoading())
+	{
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		if (!PinDescriptions.IsEmpty())
+		{
+			PinDescriptions.KeySort(
+				[this](const FHeartPinGuid& A, const FHeartPinGuid& B)
+				{
+					const int32* OrderA = PinOrder.Find(A);
+					const int32* OrderB = PinOrder.Find(B);
+					return (OrderA ? *OrderA : MAX_int32) < (OrderB ? *OrderB : MAX_int32);
+				});
+
+			for (auto&& Element : PinDescriptions)
+			{
+				PinGuids.Add(Element.Key);
+				PinDescs.Add(Element.Value);
+
+				const FHeartGraphPinConnections* Connections = PinConnections.Find(Element.Key);
+				PinLinks.Add(Connections ? *Connections : FHeartGraphPinConnections());
+			}
+
+			PinDescriptions.Empty();
+			PinConnections.Empty();
+			PinOrder.Empty();
+		}
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+
+		RebuildIndex();
+	}
+}
+
 void FHeartNodePinData::AddPin(const FHeartPinGuid NewKey, const FHeartGraphPinDesc& Desc)
 {
-	PinOrder.Add(NewKey, PinOrder.Num());
-	PinDescriptions.Add(NewKey, Desc);
+	if (const int32 Existing = FindIndex(NewKey);
+		Existing != INDEX_NONE)
+	{
+		const bool Renamed = PinDescs[Existing].Name != Desc.Name;
+		PinDescs[Existing] = Desc;
+		if (Renamed)
+		{
+			RebuildIndex();
+		}
+		return;
+	}
+
+	const int32 Index = PinGuids.Add(NewKey);
+	PinDescs.Add(Desc);
+	PinLinks.AddDefaulted();
+
+	if (IndexSlots.Num() < Heart::PinData::GetIndexCapacity(PinGuids.Num()))
+	{
+		RebuildIndex();
+	}
+	else
+	{
+		InsertIntoIndex(Index);
+	}
 }
 
 bool FHeartNodePinData::RemovePin(const FHeartPinGuid Key)
 {
-	PinDescriptions.Remove(Key);
-	PinConnections.Remove(Key);
+	const int32 Index = FindIndex(Key);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
 
-	if (const int32* Order = PinOrder.Find(Key))
+	// Shift the remaining pins down to preserve their order. Nodes have few pins, so reindexing them all is cheap.
+	PinGuids.RemoveAt(Index);
+	PinDescs.RemoveAt(Index);
+	PinLinks.RemoveAt(Index);
+	RebuildIndex();
+
+	return true;
+}
+
+int32 FHeartNodePinData::RemovePins(const TConstArrayView<FHeartPinGuid> Keys)
+{
+	TBitArray<> Removed(false, PinGuids.Num());
+	int32 NumRemoved = 0;
+	for (const FHeartPinGuid Key : Keys)
 	{
-		// @todo this is horrid
-		for (auto&& Element : PinOrder)
+		if (const int32 Index = FindIndex(Key);
+			Index != INDEX_NONE && !Removed[Index])
 		{
-			if (Element.Value > *Order)
-			{
-				Element.Value--;
-			}
+			Removed[Index] = true;
+			++NumRemoved;
+		}
+	}
+
+	if (NumRemoved == 0)
+	{
+		return 0;
+	}
+
+	// Shift the remaining pins down in one pass, preserving their order, then reindex once.
+	int32 Write = 0;
+	for (int32 Read = 0; Read < PinGuids.Num(); ++Read)
+	{
+		if (Removed[Read])
+		{
+			continue;
 		}
+
+		if (Write != Read)
+		{
+			PinGuids[Write] = PinGuids[Read];
+			PinDescs[Write] = MoveTemp(PinDescs[Read]);
+			PinLinks[Write] = MoveTemp(PinLinks[Read]);
+		}
+		++Write;
 	}
 
-	return !!PinOrder.Remove(Key);
+	PinGuids.SetNum(Write);
+	PinDescs.SetNum(Write);
+	PinLinks.SetNum(Write);
+	RebuildIndex();
+
+	return NumRemoved;
 }
 
 int32 FHeartNodePinData::Num() const
 {
-	return PinDescriptions.Num();
+	return PinGuids.Num();
 }
 
 bool FHeartNodePinData::Contains(const FHeartPinGuid Key) const
 {
-	return PinDescriptions.Contains(Key);
+	return FindIndex(Key) != INDEX_NONE;
 }
 
 int32 FHeartNodePinData::GetPinIndex(const FHeartPinGuid Key) const
 {
-	return PinOrder[Key];
+	return FindIndex(Key);
 }
 
 bool FHeartNodePinData::HasConnections(const FHeartPinGuid Key) const
 {
-	return PinConnections.Contains(Key);
+	const int32 Index = FindIndex(Key);
+	return Index != INDEX_NONE && !PinLinks[Index].Connections.IsEmpty();
 }
 
 TOptional<FHeartGraphPinDesc> FHeartNodePinData::GetPinDesc(const FHeartPinGuid Key) const
 {
-	if (const FHeartGraphPinDesc* Descriptions = PinDescriptions.Find(Key))
+	if (const int32 Index = FindIndex(Key);
+		Index != INDEX_NONE)
 	{
-		return *Descriptions;
+		return PinDescs[Index];
 	}
 	return NullOpt;
 }
 
 TConstStructView<FHeartGraphPinDesc> FHeartNodePinData::ViewPin(const FHeartPinGuid Key) const
 {
-	if (const FHeartGraphPinDesc* Descriptions = PinDescriptions.Find(Key))
+	if (const int32 Index = FindIndex(Key);
+		Index != INDEX_NONE)
 	{
-		return *Descriptions;
+		return PinDescs[Index];
 	}
 	return TConstStructView<FHeartGraphPinDesc>();
 }
 
-FHeartGraphPinDesc& FHeartNodePinData::GetPinChecked(const FHeartPinGuid Key)
+const FHeartGraphPinDesc& FHeartNodePinData::GetPinChecked(const FHeartPinGuid Key) const
+{
+	const int32 Index = FindIndex(Key);
+	check(Index != INDEX_NONE);
+	return PinDescs[Index];
+}
+
+void FHeartNodePinData::SetPinDesc(const FHeartPinGuid Key, const FHeartGraphPinDesc& Desc)
 {
-	return PinDescriptions.FindChecked(Key);
+	const int32 Index = FindIndex(Key);
+	check(Index != INDEX_NONE);
+
+	const bool Renamed = PinDescs[Index].Name != Desc.Name;
+	PinDescs[Index] = Desc;
+	if (Renamed)
+	{
+		RebuildIndex();
+	}
 }
 
 TConstStructView<FHeartGraphPinConnections> FHeartNodePinData::ViewConnections(const FHeartPinGuid Key) const
 {
-	if (const FHeartGraphPinConnections* Connections = PinConnections.Find(Key))
+	// Pins without connections return an invalid view, same as pins that don't exist.
+	if (const int32 Index = FindIndex(Key);
+		Index != INDEX_NONE && !PinLinks[Index].Connections.IsEmpty())
 	{
-		return *Connections;
+		return PinLinks[Index];
 	}
 	return TConstStructView<FHeartGraphPinConnections>{};
 }
 
 FHeartGraphPinConnections& FHeartNodePinData::GetConnectionsMutable(const FHeartPinGuid Key)
 {
-	return PinConnections.FindOrAdd(Key);
+	const int32 Index = FindIndex(Key);
+	check(Index != INDEX_NONE);
+	return PinLinks[Index];
 }
 
-void FHeartNodePinData::AddConnection(const FHeartPinGuid Key, const FHeartGraphPinReference& Pin)
+bool FHeartNodePinData::AddConnection(const FHeartPinGuid Key, const FHeartGraphPinReference& Pin)
 {
-	PinConnections.FindOrAdd(Key).Connections.AddUnique(Pin);
+	if (const int32 Index = FindIndex(Key);
+		ensure(Index != INDEX_NONE))
+	{
+		TArray<FHeartGraphPinReference>& Connections = PinLinks[Index].Connections;
+		const int32 Num = Connections.Num();
+		return Connections.AddUnique(Pin) == Num;
+	}
+
+	return false;
 }
 
 bool FHeartNodePinData::RemoveConnection(const FHeartPinGuid Key, const FHeartGraphPinReference& Pin)
 {
-	if (FHeartGraphPinConnections* Connections = PinConnections.Find(Key))
+	if (const int32 Index = FindIndex(Key);
+		Index != INDEX_NONE)
 	{
-		const int32 Removed = Connections->Connections.Remove(Pin);
+		return !!PinLinks[Index].Connections.Remove(Pin);
+	}
 
-		// Remove Connections element, if empty.
-		if (Connections->Connections.IsEmpty())
+	return false;
+}
+
+TMap<FHeartPinGuid, FHeartGraphPinConnections> FHeartNodePinData::GetAllConnections() const
+{
+	TMap<FHeartPinGuid, FHeartGraphPinConnections> Connections;
+	for (int32 i = 0; i < PinGuids.Num(); ++i)
+	{
+		if (!PinLinks[i].Connections.IsEmpty())
 		{
-			PinConnections.Remove(Key);
+			Connections.Add(PinGuids[i], PinLinks[i]);
 		}
+	}
+	return Connections;
+}
 
-		return !!Removed;
+void FHeartNodePinData::SetAllConnections(const TMap<FHeartPinGuid, FHeartGraphPinConnections>& Connections)
+{
+	for (int32 i = 0; i < PinGuids.Num(); ++i)
+	{
+		const FHeartGraphPinConnections* PinConnections = Connections.Find(PinGuids[i]);
+		PinLinks[i] = PinConnections ? *PinConnections : FHeartGraphPinConnections();
 	}
+}
 
-	return false;
+int32 FHeartNodePinData::FindIndex(const FHeartPinGuid Key) const
+{
+	// The index may not exist yet if this was loaded through a path that skipped PostSerialize.
+	if (IndexSlots.IsEmpty())
+	{
+		return PinGuids.Find(Key);
+	}
+
+	const uint32 Mask = IndexSlots.Num() - 1;
+	for (uint32 Slot = GetTypeHash(Key) & Mask; ; Slot = (Slot + 1) & Mask)
+	{
+		const int32 Entry = IndexSlots[Slot];
+		if (Entry == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		if (PinGuids[Entry - 1] == Key)
+		{
+			return Entry - 1;
+		}
+	}
+}
+
+int32 FHeartNodePinData::FindIndexByName(const FName Name) const
+{
+	if (NameSlots.IsEmpty())
+	{
+		return PinDescs.IndexOfByPredicate(
+			[Name](const FHeartGraphPinDesc& Desc)
+			{
+				return Desc.Name == Name;
+			});
+	}
+
+	const uint32 Mask = NameSlots.Num() - 1;
+	for (uint32 Slot = GetTypeHash(Name) & Mask; ; Slot = (Slot + 1) & Mask)
+	{
+		const int32 Entry = NameSlots[Slot];
+		if (Entry == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		if (PinDescs[Entry - 1].Name == Name)
+		{
+			return Entry - 1;
+		}
+	}
+}
+
+void FHeartNodePinData::RebuildIndex()
+{
+	IndexSlots.Reset();
+	NameSlots.Reset();
+	if (PinGuids.IsEmpty())
+	{
+		return;
+	}
+
+	IndexSlots.SetNumZeroed(Heart::PinData::GetIndexCapacity(PinGuids.Num()));
+	NameSlots.SetNumZeroed(IndexSlots.Num());
+	for (int32 i = 0; i < PinGuids.Num(); ++i)
+	{
+		InsertIntoIndex(i);
+	}
+}
+
+void FHeartNodePinData::InsertIntoIndex(const int32 Index)
+{
+	const uint32 Mask = IndexSlots.Num() - 1;
+	uint32 Slot = GetTypeHash(PinGuids[Index]) & Mask;
+	while (IndexSlots[Slot] != 0)
+	{
+		Slot = (Slot + 1) & Mask;
+	}
+	IndexSlots[Slot] = Index + 1;
+
+	Slot = GetTypeHash(PinDescs[Index].Name) & Mask;
+	while (NameSlots[Slot] != 0)
+	{
+		Slot = (Slot + 1) & Mask;
+	}
+	NameSlots[Slot] = Index + 1;
 }
\ No newline at end of file
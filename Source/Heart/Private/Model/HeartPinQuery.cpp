@@ -12,12 +12,7 @@ namespace Heart::Query
 	{
 		return SortBy([this](const FHeartPinGuid& Key)
 			{
-				return Reference.PinOrder[Key];
+				return Reference.GetPinIndex(Key);
 			});
 	}
-
-	const TMap<FHeartPinGuid, FHeartGraphPinDesc>& FPinQueryResult::SimpleData() const
-	{
-		return Reference.PinDescriptions;
-	}
 }
\ No newline at end of file
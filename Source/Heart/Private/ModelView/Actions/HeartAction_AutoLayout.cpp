@@ -4,6 +4,7 @@
 #include "Model/HeartGraph.h"
 #include "Model/HeartGraphNode.h"
 #include "ModelView/HeartActionHistory.h"
+#include "ModelView/HeartAsyncLayout.h"
 #include "ModelView/HeartLayoutHelper.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartAction_AutoLayout)
@@ -49,7 +50,14 @@ FHeartEvent UHeartAction_AutoLayout::ExecuteOnGraph(IHeartGraphInterface* Graph,
 		UndoData.Add(OriginalLocationsStorage, OriginalLocations);
 	}
 
-	LayoutHelper->Layout(Graph);
+	if (LayoutHelper->GetPreferAsync())
+	{
+		LayoutHelper->LayoutAsync(Graph);
+	}
+	else
+	{
+		LayoutHelper->Layout(Graph);
+	}
 	return FHeartEvent::Handled;
 }
 
@@ -58,6 +66,9 @@ bool UHeartAction_AutoLayout::Undo(UObject* Target, const FBloodContainer& UndoD
 	// We must use the Interface for the SetNodeLocation calls, in case it's overriden.
 	IHeartGraphInterface* Interface = Cast<IHeartGraphInterface>(Target);
 
+	// A layout still running would keep publishing positions over the restored ones.
+	Heart::Layout::FAsyncLayoutJob::CancelForGraph(Interface->GetHeartGraph());
+
 	TSet<FHeartNodeGuid> Touched;
 
 	auto&& Data = UndoData.Get<TMap<FHeartNodeGuid, FVector2D>>(OriginalLocationsStorage);
@@ -4,6 +4,7 @@
 #include "Model/HeartGraph.h"
 #include "Model/HeartGraphNode.h"
 #include "Model/HeartGraphNodeInterface.h"
+#include "Model/HeartNodeEdit.h"
 #include "ModelView/HeartActionHistory.h"
 #include "Providers/FlakesBinarySerializer.h"
 
@@ -29,7 +30,7 @@ bool FHeartDeleteNodeUndoData::Serialize(FArchive& Ar)
 		DeletedNode = Flakes::CreateObject<UHeartGraphNode, Flakes::Binary::Type>(NodeData);
 	}
 
-	Ar << Mementos;
+	Ar << Delta;
 
 	return true;
 }
@@ -46,18 +47,24 @@ bool UHeartAction_DeleteNode::CanExecute(const UObject* Object) const
 FHeartEvent UHeartAction_DeleteNode::ExecuteOnNode(UHeartGraphNode* Node, const FHeartInputActivation& Activation,
 												   UObject* ContextObject, FBloodContainer& UndoData) const
 {
+	UHeartGraph* Graph = Node->GetGraph();
+
+	// Announce the disconnect and the removal together, same as a removal that isn't undoable.
+	Heart::API::FGraphBatch Batch(Graph);
+
 	if (Heart::Action::History::IsUndoable())
 	{
 		// Cache undo data
 		FHeartDeleteNodeUndoData Data;
 		Data.DeletedNode = Node;
 
-		Heart::API::FPinEdit(Node).CreateAllMementos(Node->GetGuid(), Data.Mementos);
+		// Disconnect the node ahead of removing it, to record which links were broken.
+		Heart::API::FPinEdit(Node).RecordDelta(Data.Delta).DisconnectAll(Node->GetGuid());
 
 		UndoData.Add(DeletedNodeStorage, Data);
 	}
 
-	Node->GetGraph()->RemoveNode(Node->GetGuid());
+	Graph->RemoveNode(Node->GetGuid());
 
 	return FHeartEvent::Handled;
 }
@@ -81,7 +88,7 @@ bool UHeartAction_DeleteNode::Undo(UObject* Target, const FBloodContainer& UndoD
 	Graph->AddNode(Data.DeletedNode);
 
 	// Relink broken connections
-	Heart::API::FPinEdit(Graph).RestoreMementos(Data.Mementos);
+	Heart::API::FPinEdit(Graph).RevertDelta(Data.Delta);
 
 	return true;
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ static const FLazyName DisconnectPinsStorage("discpins");
 
 bool FHeartDisconnectPinsUndoData::Serialize(FArchive& Ar)
 {
-	return !(Ar << TargetNode << Mementos).IsError();
+	return !(Ar << TargetNode << Delta).IsError();
 }
 
 bool UHeartAction_DisconnectPins::CanExecute(const UObject* Object) const
@@ -39,7 +39,7 @@ FHeartEvent UHeartAction_DisconnectPins::ExecuteOnPin(const TScriptInterface<IHe
 	{
 		FHeartDisconnectPinsUndoData Data;
 		Data.TargetNode = Node;
-		Heart::API::FPinEdit(Node).CreateMementos(PinRef, Data.Mementos).DisconnectAll(PinRef);
+		Heart::API::FPinEdit(Node).RecordDelta(Data.Delta).DisconnectAll(PinRef);
 		UndoData.Add(DisconnectPinsStorage, Data);
 	}
 	else
@@ -60,7 +60,7 @@ FHeartEvent UHeartAction_DisconnectPins::ExecuteOnNode(UHeartGraphNode* Node, co
 	{
 		FHeartDisconnectPinsUndoData Data;
 		Data.TargetNode = Node;
-		Heart::API::FPinEdit(Node).CreateAllMementos(Guid, Data.Mementos).DisconnectAll(Guid);
+		Heart::API::FPinEdit(Node).RecordDelta(Data.Delta).DisconnectAll(Guid);
 		UndoData.Add(DisconnectPinsStorage, Data);
 	}
 	else
@@ -81,7 +81,7 @@ bool UHeartAction_DisconnectPins::Undo(UObject* Target, const FBloodContainer& U
 		return false;
 	}
 
-	Heart::API::FPinEdit(Data.TargetNode.Get()).RestoreMementos(Data.Mementos);
+	Heart::API::FPinEdit(Data.TargetNode.Get()).RevertDelta(Data.Delta);
 
 	return true;
 }
\ No newline at end of file
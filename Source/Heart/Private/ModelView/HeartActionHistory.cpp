@@ -6,9 +6,20 @@
 #include "Model/HeartGraphNode.h"
 #include "Model/HeartGraphNodeInterface.h"
 #include "Model/HeartGraphPinInterface.h"
+#include "HeartPrivate.h"
+#include "Algo/Rotate.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartActionHistory)
 
+DECLARE_MEMORY_STAT(TEXT("ActionHistory"), STAT_ActionHistoryMemory, STATGROUP_Heart);
+
 namespace Heart::Action::History
 {
 	namespace Impl
@@ -31,6 +42,39 @@ namespace Heart::Action::History
 		 */
 		static TArray<TOptional<FExecutingAction>> ExecutingActionsStack;
 
+		// Counts the bytes an archive would write, without storing them. Names and object references are counted at
+		// their in-memory size.
+		class FSizeCountingArchive : public FArchiveUObject
+		{
+		public:
+			FSizeCountingArchive()
+			{
+				SetIsSaving(true);
+				SetIsPersistent(false);
+			}
+
+			using FArchiveUObject::operator<<;
+
+			virtual void Serialize(void* V, const int64 Length) override { Size += Length; }
+			virtual FArchive& operator<<(FName& Value) override { Size += sizeof(FName); return *this; }
+			virtual FArchive& operator<<(UObject*& Value) override { Size += sizeof(UObject*); return *this; }
+			virtual int64 Tell() override { return Size; }
+			virtual int64 TotalSize() override { return Size; }
+			virtual FString GetArchiveName() const override { return TEXT("FSizeCountingArchive"); }
+
+			int64 Size = 0;
+		};
+
+		// The serialized size of a record, including data only written by custom serializers, like pin deltas and
+		// flakes. Each record is measured once, when it's added or loaded, and keeps that size while it's unpacked.
+		static int64 GetRecordSize(const FHeartActionRecord& Record)
+		{
+			// Saving doesn't modify the record, it's only non-const because the same function is used for loading.
+			FSizeCountingArchive Ar;
+			const_cast<FHeartActionRecord&>(Record).Serialize(Ar);
+			return Ar.Size;
+		}
+
 		void BeginLog(const UHeartActionBase* Action, const FArguments& Arguments)
 		{
 			if (IsLoggable(Action, Arguments))
@@ -203,19 +247,108 @@ namespace Heart::Action::History
 	}
 }
 
+void UHeartActionHistory::Serialize(FArchive& Ar)
+{
+	// Save records in order, unpacked, and without released slots, so the ring doesn't need to be saved with them.
+	if (Ar.IsSaving() && !Ar.IsCountingMemory())
+	{
+		for (int32 Index = 0; Index < NumRecords; ++Index)
+		{
+			UnpackRecord(GetSlot(Index));
+		}
+
+		Linearize();
+		Actions.SetNum(NumRecords);
+		RecordSizes.SetNum(NumRecords);
+		PackedRecords.SetNum(NumRecords);
+	}
+
+	Super::Serialize(Ar);
+
+	if (Ar.IsLoading())
+	{
+		FirstAction = 0;
+		NumRecords = Actions.Num();
+
+		// Sizes are measured again in PostLoad.
+		DEC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, MemoryUsage);
+		MemoryUsage = 0;
+		RecordSizes.Reset();
+		RecordSizes.SetNumZeroed(NumRecords);
+
+		for (int32 Slot = 0; Slot < PackedRecords.Num(); ++Slot)
+		{
+			ReleasePackedRecord(Slot);
+		}
+		PackedRecords.SetNum(NumRecords);
+	}
+}
+
+void UHeartActionHistory::PostLoad()
+{
+	Super::PostLoad();
+
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		const int32 Slot = GetSlot(Index);
+		const int64 RecordSize = Heart::Action::History::Impl::GetRecordSize(Actions[Slot]);
+		MemoryUsage += RecordSize - RecordSizes[Slot];
+		INC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, RecordSize - RecordSizes[Slot]);
+		RecordSizes[Slot] = RecordSize;
+	}
+
+	PackOldRecords();
+}
+
+void UHeartActionHistory::BeginDestroy()
+{
+	// Delete any spill files.
+	for (int32 Slot = 0; Slot < PackedRecords.Num(); ++Slot)
+	{
+		ReleasePackedRecord(Slot);
+	}
+
+	DEC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, MemoryUsage);
+	MemoryUsage = 0;
+
+	Super::BeginDestroy();
+}
+
 void UHeartActionHistory::AddRecord(const FHeartActionRecord& Record)
 {
 	// Clear history above Pointer
-	Actions.SetNumUninitialized(ActionPointer + 1);
+	for (int32 Index = ActionPointer + 1; Index < NumRecords; ++Index)
+	{
+		ReleaseRecord(Index);
+	}
+	NumRecords = ActionPointer + 1;
+
+	const int64 RecordSize = Heart::Action::History::Impl::GetRecordSize(Record);
 
-	// Remove the element at index 0, but don't shrink, because we are just going to add another element
-	if (Actions.Num() == MaxRecordedActions)
+	// Pack before trimming, so packing can make room before anything has to be evicted.
+	PackOldRecords();
+	TrimToFit(1, RecordSize);
+
+	// Reuse a released slot if there is one, otherwise the ring has to grow.
+	if (NumRecords < Actions.Num())
+	{
+		const int32 Slot = GetSlot(NumRecords);
+		Actions[Slot] = Record;
+		RecordSizes[Slot] = RecordSize;
+	}
+	else
 	{
-		Actions.RemoveAt(0, 1, EAllowShrinking::No);
+		Linearize();
+		Actions.Add(Record);
+		RecordSizes.Add(RecordSize);
+		PackedRecords.AddDefaulted();
 	}
 
+	MemoryUsage += RecordSize;
+	INC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, RecordSize);
+
 	// Add action to record, and reassign Pointer to new index
-	ActionPointer = Actions.Emplace(Record);
+	ActionPointer = NumRecords++;
 
 	BroadcastUpdate(ActionPointer, 1);
 	BroadcastPointer();
@@ -228,63 +361,122 @@ TConstStructView<FHeartActionRecord> UHeartActionHistory::RetrieveRecordPtr()
 		return TConstStructView<FHeartActionRecord>{};
 	}
 
-	FHeartActionRecord& Action = Actions[ActionPointer--];
+	const int32 Slot = GetSlot(ActionPointer--);
+	UnpackRecord(Slot);
+
+	FHeartActionRecord& Action = Actions[Slot];
 	BroadcastPointer();
 	return Action;
 }
 
 TConstStructView<FHeartActionRecord> UHeartActionHistory::AdvanceRecordPtr()
 {
-	if (ActionPointer == Actions.Num()-1)
+	if (ActionPointer == NumRecords-1)
 	{
 		// Cannot Redo the most recent action
 		return TConstStructView<FHeartActionRecord>{};
 	}
 
-	FHeartActionRecord& Action = Actions[++ActionPointer];
+	const int32 Slot = GetSlot(++ActionPointer);
+	UnpackRecord(Slot);
+
+	FHeartActionRecord& Action = Actions[Slot];
 	BroadcastPointer();
 	return Action;
 }
 
 TConstArrayView<FHeartActionRecord> UHeartActionHistory::RetrieveRecords(const int32 Count)
 {
-	if (Count >= Actions.Num())
+	for (int32 Index = FMath::Max(NumRecords - Count, 0); Index < NumRecords; ++Index)
+	{
+		UnpackRecord(GetSlot(Index));
+	}
+
+	Linearize();
+	const TConstArrayView<FHeartActionRecord> Records(Actions.GetData(), NumRecords);
+
+	if (Count >= NumRecords)
 	{
 		ActionPointer = INDEX_NONE;
-		return Actions;
+		return Records;
 	}
 
 	ActionPointer -= Count;
 	BroadcastPointer();
 
-	return MakeArrayView(Actions).Right(Count);
+	return Records.Right(Count);
 }
 
-TConstArrayView<FHeartActionRecord> UHeartActionHistory::ViewRecords(const int32 Count) const
+TConstArrayView<FHeartActionRecord> UHeartActionHistory::ViewRecords(const int32 Count)
 {
-	if (Count >= Actions.Num())
+	for (int32 Index = FMath::Max(NumRecords - Count, 0); Index < NumRecords; ++Index)
 	{
-		return Actions;
+		UnpackRecord(GetSlot(Index));
 	}
-	return MakeArrayView(Actions).Right(Count);
+
+	Linearize();
+	const TConstArrayView<FHeartActionRecord> Records(Actions.GetData(), NumRecords);
+
+	if (Count >= NumRecords)
+	{
+		return Records;
+	}
+	return Records.Right(Count);
 }
 
 void UHeartActionHistory::ViewRecords(const int32 Count, TArray<FHeartActionRecord>& Records) const
 {
-	Records = ViewRecords(Count);
+	const int32 First = FMath::Max(NumRecords - Count, 0);
+
+	Records.Reset(NumRecords - First);
+	for (int32 Index = First; Index < NumRecords; ++Index)
+	{
+		const int32 Slot = GetSlot(Index);
+		if (PackedRecords[Slot].IsSet())
+		{
+			// Read packed records into the copy, without unpacking them in the history.
+			ReadPackedRecord(PackedRecords[Slot], Records.AddDefaulted_GetRef());
+		}
+		else
+		{
+			Records.Add(Actions[Slot]);
+		}
+	}
 }
 
 void UHeartActionHistory::SetMaxRecordedActions(const int32 Count)
 {
 	if (Count != MaxRecordedActions)
 	{
-		if (Actions.Num() > Count)
+		MaxRecordedActions = Count;
+
+		const int32 PreviousNum = NumRecords;
+		TrimToFit(0, 0);
+		if (NumRecords != PreviousNum)
 		{
-			Actions.RemoveAt(0, Actions.Num() - Count);
+			BroadcastUpdate(0, INDEX_NONE);
 		}
-		BroadcastUpdate(0, INDEX_NONE);
 
-		MaxRecordedActions = Count;
+		// Drop released slots, so the ring's capacity matches the new limit.
+		Linearize();
+		Actions.SetNum(NumRecords);
+		RecordSizes.SetNum(NumRecords);
+		PackedRecords.SetNum(NumRecords);
+	}
+}
+
+void UHeartActionHistory::SetMemoryBudget(const int64 Bytes)
+{
+	if (Bytes != MemoryBudget)
+	{
+		MemoryBudget = Bytes;
+
+		const int32 PreviousNum = NumRecords;
+		TrimToFit(0, 0);
+		if (NumRecords != PreviousNum)
+		{
+			BroadcastUpdate(0, INDEX_NONE);
+		}
 	}
 }
 
@@ -298,6 +490,187 @@ FHeartEvent UHeartActionHistory::Redo()
 	return Heart::Action::History::TryRedo(this);
 }
 
+void UHeartActionHistory::Linearize()
+{
+	if (FirstAction != 0)
+	{
+		Algo::Rotate(Actions, FirstAction);
+		Algo::Rotate(RecordSizes, FirstAction);
+		Algo::Rotate(PackedRecords, FirstAction);
+		FirstAction = 0;
+	}
+}
+
+void UHeartActionHistory::ReleaseRecord(const int32 Index)
+{
+	const int32 Slot = GetSlot(Index);
+
+	MemoryUsage -= RecordSizes[Slot];
+	DEC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, RecordSizes[Slot]);
+
+	Actions[Slot] = FHeartActionRecord();
+	RecordSizes[Slot] = 0;
+	ReleasePackedRecord(Slot);
+}
+
+void UHeartActionHistory::EvictOldest()
+{
+	ReleaseRecord(0);
+
+	// The released slot is now the last in the ring.
+	FirstAction = (FirstAction + 1) % Actions.Num();
+	NumRecords--;
+	ActionPointer = FMath::Max(ActionPointer - 1, INDEX_NONE);
+}
+
+void UHeartActionHistory::TrimToFit(const int32 IncomingRecords, const int64 IncomingSize)
+{
+	auto IsOverBudget = [this, IncomingRecords, IncomingSize]()
+		{
+			if (MaxRecordedActions > 0 && NumRecords + IncomingRecords > MaxRecordedActions)
+			{
+				return true;
+			}
+			return MemoryBudget > 0 && MemoryUsage + IncomingSize > MemoryBudget;
+		};
+
+	while (NumRecords > 0 && IsOverBudget())
+	{
+		EvictOldest();
+	}
+}
+
+bool UHeartActionHistory::PackRecord(const int32 Slot)
+{
+	FPackedRecord& Packed = PackedRecords[Slot];
+	if (Packed.IsSet())
+	{
+		return true;
+	}
+
+	// Objects and names are written as strings, so they can be found again after being unloaded from the record.
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	FObjectAndNameAsStringProxyArchive Ar(Writer, false);
+	if (!Actions[Slot].Serialize(Ar) || Ar.IsError() || Bytes.IsEmpty())
+	{
+		return false;
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, Bytes.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(CompressionFormat, Compressed.GetData(), CompressedSize, Bytes.GetData(), Bytes.Num()))
+	{
+		UE_LOG(LogHeartGraph, Warning, TEXT("Failed to compress action record with format '%s'"), *CompressionFormat.ToString())
+		return false;
+	}
+	Compressed.SetNum(CompressedSize);
+
+	if (SpillToDisk)
+	{
+		const FString File = FPaths::CreateTempFilename(*(FPaths::ProjectSavedDir() / TEXT("HeartHistory")), TEXT("Undo"), TEXT(".bin"));
+		if (FFileHelper::SaveArrayToFile(Compressed, *File))
+		{
+			Packed.SpillFile = File;
+			Compressed.Empty();
+		}
+	}
+
+	Packed.Data = MoveTemp(Compressed);
+	Packed.Format = CompressionFormat;
+	Packed.UncompressedSize = Bytes.Num();
+	Packed.RecordSize = RecordSizes[Slot];
+
+	Actions[Slot] = FHeartActionRecord();
+
+	const int64 PackedSize = Packed.Data.Num();
+	MemoryUsage += PackedSize - RecordSizes[Slot];
+	INC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, PackedSize - RecordSizes[Slot]);
+	RecordSizes[Slot] = PackedSize;
+
+	return true;
+}
+
+void UHeartActionHistory::UnpackRecord(const int32 Slot)
+{
+	if (!PackedRecords[Slot].IsSet())
+	{
+		return;
+	}
+
+	// The record was measured before it was packed, so it doesn't need to be measured again.
+	int64 RecordSize = PackedRecords[Slot].RecordSize;
+
+	if (!ReadPackedRecord(PackedRecords[Slot], Actions[Slot]))
+	{
+		// The record is lost, so leave it empty. Undoing it will fail, as it has no action.
+		UE_LOG(LogHeartGraph, Error, TEXT("Failed to unpack action record! It can no longer be undone."))
+		Actions[Slot] = FHeartActionRecord();
+		RecordSize = 0;
+	}
+
+	ReleasePackedRecord(Slot);
+
+	MemoryUsage += RecordSize - RecordSizes[Slot];
+	INC_MEMORY_STAT_BY(STAT_ActionHistoryMemory, RecordSize - RecordSizes[Slot]);
+	RecordSizes[Slot] = RecordSize;
+}
+
+void UHeartActionHistory::PackOldRecords()
+{
+	if (!CompressOldRecords)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < NumRecords - UncompressedRecords; ++Index)
+	{
+		PackRecord(GetSlot(Index));
+	}
+}
+
+void UHeartActionHistory::ReleasePackedRecord(const int32 Slot)
+{
+	if (!PackedRecords.IsValidIndex(Slot))
+	{
+		return;
+	}
+
+	FPackedRecord& Packed = PackedRecords[Slot];
+	if (!Packed.SpillFile.IsEmpty())
+	{
+		IFileManager::Get().Delete(*Packed.SpillFile, false, false, true);
+	}
+	Packed = FPackedRecord();
+}
+
+bool UHeartActionHistory::ReadPackedRecord(const FPackedRecord& Packed, FHeartActionRecord& OutRecord)
+{
+	TArray<uint8> FileData;
+	const TArray<uint8>* Compressed = &Packed.Data;
+	if (!Packed.SpillFile.IsEmpty())
+	{
+		if (!FFileHelper::LoadFileToArray(FileData, *Packed.SpillFile))
+		{
+			return false;
+		}
+		Compressed = &FileData;
+	}
+
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(Packed.UncompressedSize);
+	if (!FCompression::UncompressMemory(Packed.Format, Bytes.GetData(), Bytes.Num(), Compressed->GetData(), Compressed->Num()))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	FObjectAndNameAsStringProxyArchive Ar(Reader, false);
+	OutRecord.Serialize(Ar);
+	return !Ar.IsError();
+}
+
 void UHeartActionHistory::BroadcastPointer()
 {
 	OnPointerChangedNative.Broadcast(ActionPointer);
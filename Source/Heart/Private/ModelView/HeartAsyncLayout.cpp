@@ -0,0 +1,189 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "ModelView/HeartAsyncLayout.h"
+#include "Model/HeartGraph.h"
+#include "Model/HeartGraphInterface.h"
+
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "UObject/ObjectKey.h"
+
+namespace Heart::Layout
+{
+	// The job running on each graph. Only touched on the game thread.
+	static TMap<TObjectKey<UHeartGraph>, TWeakPtr<FAsyncLayoutJob>> GActiveJobs;
+
+	FAsyncLayoutJob::FAsyncLayoutJob(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& InNodes,
+									 FHeartGraphAdjacencyList&& InAdjacencyList, const float PublishRate)
+	  : InterfaceObject(Interface->_getUObject()),
+		Graph(Interface->GetHeartGraph()),
+		Nodes(InNodes),
+		AdjacencyList(MoveTemp(InAdjacencyList)),
+		PublishInterval(1.0 / FMath::Max(PublishRate, 1.f))
+	{
+		StartPositions.Reserve(Nodes.Num());
+		Algo::Transform(Nodes, StartPositions,
+			[Interface](const FHeartNodeGuid& Node)
+			{
+				return Interface->GetNodeLocation(Node);
+			});
+	}
+
+	void FAsyncLayoutJob::Start(FAsyncLayoutWork&& Work)
+	{
+		check(IsInGameThread());
+
+		// Positions computed from a stale copy of the graph are meaningless, so stop as soon as its topology changes.
+		if (UHeartGraph* GraphPtr = Graph.Get())
+		{
+			// Two jobs would fight over the same nodes, so the newest one wins.
+			CancelForGraph(GraphPtr);
+			GActiveJobs.Add(GraphPtr, AsShared());
+
+			GraphPtr->GetOnNodeAdded().AddSPLambda(this, [this](UHeartGraphNode*) { Cancel(); });
+			GraphPtr->GetOnNodeRemoved().AddSPLambda(this, [this](UHeartGraphNode*) { Cancel(); });
+			GraphPtr->GetOnNodeConnectionsChanged().AddSPLambda(this, [this](const FHeartGraphConnectionEvent&) { Cancel(); });
+			GraphPtr->GetOnNodeMoved().AddSP(this, &FAsyncLayoutJob::OnNodesMoved);
+		}
+
+		UE::Tasks::Launch(UE_SOURCE_LOCATION,
+			[This = AsShared(), Work = MoveTemp(Work)]() mutable
+			{
+				TArray<FVector2D> FinalPositions;
+				if (!This->IsCancelled())
+				{
+					FinalPositions = Work(*This);
+				}
+
+				// Always publish a final result, so the game thread knows to clean up the job, even if it was cancelled.
+				This->PublishInternal(MoveTemp(FinalPositions), true);
+			});
+	}
+
+	void FAsyncLayoutJob::Cancel()
+	{
+		check(IsInGameThread());
+		Cancelled = true;
+		UnbindFromGraph();
+	}
+
+	void FAsyncLayoutJob::CancelForGraph(const UHeartGraph* Graph)
+	{
+		check(IsInGameThread());
+
+		if (const TWeakPtr<FAsyncLayoutJob>* Job = GActiveJobs.Find(Graph))
+		{
+			if (const TSharedPtr<FAsyncLayoutJob> JobPtr = Job->Pin())
+			{
+				// Cancelling unregisters the job.
+				JobPtr->Cancel();
+			}
+			else
+			{
+				GActiveJobs.Remove(Graph);
+			}
+		}
+	}
+
+	bool FAsyncLayoutJob::ShouldPublish()
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (Now < NextPublishTime)
+		{
+			return false;
+		}
+
+		NextPublishTime = Now + PublishInterval;
+		return true;
+	}
+
+	void FAsyncLayoutJob::Publish(const TArray<FVector2D>& Positions)
+	{
+		PublishInternal(CopyTemp(Positions), false);
+	}
+
+	void FAsyncLayoutJob::PublishInternal(TArray<FVector2D>&& Positions, const bool Final)
+	{
+		{
+			FScopeLock Lock(&PendingLock);
+			PendingPositions = MoveTemp(Positions);
+			PendingFinal |= Final;
+
+			// A task is already waiting to apply positions, it will pick these up instead.
+			if (PublishQueued)
+			{
+				return;
+			}
+			PublishQueued = true;
+		}
+
+		AsyncTask(ENamedThreads::GameThread,
+			[This = AsShared()]
+			{
+				This->ApplyPendingPositions();
+			});
+	}
+
+	void FAsyncLayoutJob::ApplyPendingPositions()
+	{
+		TArray<FVector2D> Positions;
+		bool Final;
+		{
+			FScopeLock Lock(&PendingLock);
+			Positions = MoveTemp(PendingPositions);
+			Final = PendingFinal;
+			PublishQueued = false;
+		}
+
+		IHeartGraphInterface* Interface = Cast<IHeartGraphInterface>(InterfaceObject.Get());
+		UHeartGraph* GraphPtr = Graph.Get();
+
+		if (!Cancelled && Interface && GraphPtr && Positions.Num() == Nodes.Num())
+		{
+			TGuardValue<bool> ApplyingGuard(ApplyingPositions, true);
+
+			for (int32 i = 0; i < Positions.Num(); ++i)
+			{
+				Interface->SetNodeLocation(Nodes[i], Positions[i], !Final);
+			}
+
+			// Intermediate results are moves in progress. The final one finishes the move, so listeners that wait for it,
+			// like net replication and undo recording, see where the layout settled.
+			TSet<FHeartNodeGuid> Touched;
+			Touched.Append(Nodes);
+			GraphPtr->NotifyNodeLocationsChanged(Touched, !Final);
+		}
+
+		if (Final)
+		{
+			Finished = true;
+			UnbindFromGraph();
+		}
+	}
+
+	void FAsyncLayoutJob::UnbindFromGraph()
+	{
+		if (UHeartGraph* GraphPtr = Graph.Get())
+		{
+			GraphPtr->GetOnNodeAdded().RemoveAll(this);
+			GraphPtr->GetOnNodeRemoved().RemoveAll(this);
+			GraphPtr->GetOnNodeConnectionsChanged().RemoveAll(this);
+			GraphPtr->GetOnNodeMoved().RemoveAll(this);
+
+			if (const TWeakPtr<FAsyncLayoutJob>* Active = GActiveJobs.Find(GraphPtr);
+				Active && Active->HasSameObject(this))
+			{
+				GActiveJobs.Remove(GraphPtr);
+			}
+		}
+	}
+
+	void FAsyncLayoutJob::OnNodesMoved(const FHeartNodeMoveEvent& Event)
+	{
+		// A finished move by the user, or anything else, means the layout's positions are no longer wanted.
+		if (Event.MoveFinished && !ApplyingPositions)
+		{
+			Cancel();
+		}
+	}
+}
@@ -1,6 +1,7 @@
 ﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
 
 #include "ModelView/HeartLayoutHelper.h"
+#include "ModelView/HeartAsyncLayout.h"
 #include "Model/HeartGraph.h"
 #include "Model/HeartGraphNode.h"
 #include "Model/HeartGraphUtils.h"
@@ -33,27 +34,79 @@ bool UHeartLayoutHelper::Layout(IHeartGraphInterface* Interface, const float Del
 	return false;
 }
 
+bool UHeartLayoutHelper::LayoutAsync(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes)
+{
+	CancelAsyncLayout();
+
+	Heart::Layout::FAsyncLayoutWork Work = CreateAsyncLayout();
+	if (!Work)
+	{
+		return Layout(Interface, Nodes);
+	}
+
+	const TSharedRef<Heart::Layout::FAsyncLayoutJob> Job = MakeShared<Heart::Layout::FAsyncLayoutJob>(
+		Interface, Nodes, GetGraphAdjacencyList(Interface, Nodes), AsyncPublishRate);
+	ActiveAsyncJob = Job;
+	Job->Start(MoveTemp(Work));
+	return true;
+}
+
+bool UHeartLayoutHelper::LayoutAsync(IHeartGraphInterface* Interface)
+{
+	const UHeartGraph* Graph = Interface->GetHeartGraph();
+	if (IsValid(Graph))
+	{
+		TArray<FHeartNodeGuid> AllNodes;
+		Graph->GetNodeGuids(AllNodes);
+		return LayoutAsync(Interface, AllNodes);
+	}
+
+	return false;
+}
+
+void UHeartLayoutHelper::CancelAsyncLayout()
+{
+	if (const TSharedPtr<Heart::Layout::FAsyncLayoutJob> Job = ActiveAsyncJob.Pin())
+	{
+		Job->Cancel();
+	}
+	ActiveAsyncJob.Reset();
+}
+
+bool UHeartLayoutHelper::IsAsyncLayoutRunning() const
+{
+	const TSharedPtr<Heart::Layout::FAsyncLayoutJob> Job = ActiveAsyncJob.Pin();
+	return Job.IsValid() && Job->IsRunning();
+}
+
 FHeartGraphAdjacencyList UHeartLayoutHelper::GetGraphAdjacencyList(const IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes)
 {
 	FHeartGraphAdjacencyList Result;
 
 	const UHeartGraph* Graph = Interface->GetHeartGraph();
 
+	TMap<FHeartNodeGuid, int32> NodeIndices;
+	NodeIndices.Reserve(Nodes.Num());
 	for (int32 i = 0; i < Nodes.Num(); ++i)
 	{
-		const TArray<FHeartNodeGuid> OutputLinks = Heart::Utils::GetConnectedNodes(Graph, Nodes[i], EHeartPinDirection::Output);
+		NodeIndices.Add(Nodes[i], i);
+	}
+
+	Result.AdjacencyList.Offsets.Reserve(Nodes.Num() + 1);
 
-		TArray<int32>& NodeAdjacency = Result.AdjacencyList.AddDefaulted_GetRef();
-		NodeAdjacency.Reserve(OutputLinks.Num());
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		const TArray<FHeartNodeGuid> OutputLinks = Heart::Utils::GetConnectedNodes(Graph, Nodes[i], EHeartPinDirection::Output);
 
 		for (auto&& OutputLink : OutputLinks)
 		{
-			if (const int32 NodeIndex = Nodes.Find(OutputLink);
-				NodeIndex != INDEX_NONE)
+			if (const int32* NodeIndex = NodeIndices.Find(OutputLink))
 			{
-				NodeAdjacency.Add(NodeIndex);
+				Result.AdjacencyList.Indices.Add(*NodeIndex);
 			}
 		}
+
+		Result.AdjacencyList.FinishVertex();
 	}
 
 	return Result;
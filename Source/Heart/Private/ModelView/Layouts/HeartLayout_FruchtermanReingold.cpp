@@ -1,28 +1,83 @@
 ﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
 
 #include "ModelView/Layouts/HeartLayout_FruchtermanReingold.h"
+#include "Model/HeartGraph.h"
 #include "Model/HeartGraphInterface.h"
 #include "Model/HeartGuids.h"
+#include "ModelView/HeartAsyncLayout.h"
 #include "Algorithms/FruchtermanReingold.h"
+#include "Algo/AllOf.h"
+#include "Algo/Compare.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartLayout_FruchtermanReingold)
 
 bool UHeartLayout_FruchtermanReingold::Layout(IHeartGraphInterface* Interface,
 											  const TArray<FHeartNodeGuid>& Nodes, const float DeltaTime)
 {
+	UHeartGraph* Graph = Interface->GetHeartGraph();
+	if (!IsValid(Graph))
+	{
+		return false;
+	}
+
+	// Laying out the whole graph runs off its cached topology, which is only patched when the graph changes. Layouts
+	// of a subset of nodes still gather their own adjacency list each tick.
+	FHeartGraphTopology& Topology = Graph->GetTopology();
+	const Nodesoup::FGraphView Outputs = Topology.GetOutputs();
+
+	// The topology can only stand in for Nodes if it holds exactly those nodes. Matching counts aren't enough, as a
+	// swapped node leaves the count unchanged, so the check is redone whenever either side changes.
+	if (CheckedGraph != Graph || CheckedTopologyVersion != Topology.GetVersion() || !Algo::Compare(Nodes, CheckedNodes))
+	{
+		UsesTopology = Nodes.Num() == Topology.Num() &&
+			Algo::AllOf(Nodes, [&Topology](const FHeartNodeGuid& Node) { return Topology.FindIndex(Node) != INDEX_NONE; });
+		CheckedGraph = Graph;
+		CheckedNodes = Nodes;
+		CheckedTopologyVersion = Topology.GetVersion();
+	}
+
+	const bool UseTopology = UsesTopology;
+
+	if (!UseTopology)
+	{
+		AdjacencyList = GetGraphAdjacencyList(Interface, Nodes);
+	}
+
+	const Nodesoup::FGraphView GraphView = UseTopology ? Outputs : Nodesoup::FGraphView(AdjacencyList.AdjacencyList);
+
+	const TArray<FHeartNodeGuid>& LayoutNodes = UseTopology ? Topology.GetGuids() : Nodes;
+
 	TArray<FVector2D> Positions;
-	Positions.Reserve(Nodes.Num());
-	Algo::Transform(Nodes, Positions,
+	Positions.Reserve(LayoutNodes.Num());
+	Algo::Transform(LayoutNodes, Positions,
 		[Interface](const FHeartNodeGuid& Node)
 		{
 			return Interface->GetNodeLocation(Node);
 		});
 
-	//if (!Algorithm.IsSet())
+	// Nodes appended after the ones Algorithm already knows can be swapped in. Anything else, such as a removed node
+	// moving another into its index, or switching between a subset and the whole graph, invalidates its vertex state.
+	const bool SameNodes = LayoutNodes.Num() >= AlgorithmNodes.Num() &&
+		Algo::Compare(MakeArrayView(LayoutNodes.GetData(), AlgorithmNodes.Num()), AlgorithmNodes);
+
+	if (const uint32 NewConfigHash = GetConfigHash();
+		!Algorithm.IsSet() || LayoutGraph != Graph || !SameNodes || ConfigHash != NewConfigHash)
 	{
-		// @todo rebuild this when graph changes!
-		AdjacencyList = GetGraphAdjacencyList(Interface, Nodes);
-		Algorithm = Nodesoup::FruchtermanReingold(AdjacencyList.AdjacencyList, Strength);
+		Algorithm.Emplace(GraphView, Strength, GetRepulsionMode(), GetExecutionSettings());
+		LayoutGraph = Graph;
+		AlgorithmNodes = LayoutNodes;
+		TopologyVersion = Topology.GetVersion();
+		ConfigHash = NewConfigHash;
+	}
+	else if (!UseTopology || TopologyVersion != Topology.GetVersion())
+	{
+		// Keep the temperature, so the layout continues to settle instead of restarting.
+		Algorithm->SetGraph(GraphView);
+		if (LayoutNodes.Num() != AlgorithmNodes.Num())
+		{
+			AlgorithmNodes = LayoutNodes;
+		}
+		TopologyVersion = Topology.GetVersion();
 	}
 
 	Accum += DeltaTime;
@@ -33,7 +88,58 @@ bool UHeartLayout_FruchtermanReingold::Layout(IHeartGraphInterface* Interface,
 		Accum -= IterationInterval;
 	}
 
-	ApplyNewPositions(Interface->_getUObject(), Nodes, Positions);
+	ApplyNewPositions(Interface->_getUObject(), LayoutNodes, Positions);
 
 	return true;
+}
+
+Heart::Layout::FAsyncLayoutWork UHeartLayout_FruchtermanReingold::CreateAsyncLayout() const
+{
+	return [Strength = Strength, Mode = GetRepulsionMode(), Execution = GetExecutionSettings(), Iterations = AsyncIterations]
+		(Heart::Layout::FAsyncLayoutJob& Job)
+		{
+			TArray<FVector2D> Positions = Job.GetStartPositions();
+			Nodesoup::FruchtermanReingold AsyncAlgorithm(Job.GetAdjacencyList().AdjacencyList, Strength, Mode, Execution);
+
+			for (int32 i = 0; i < Iterations && !Job.IsCancelled(); ++i)
+			{
+				AsyncAlgorithm(Positions);
+
+				if (Job.ShouldPublish())
+				{
+					Job.Publish(Positions);
+				}
+			}
+
+			return Positions;
+		};
+}
+
+Nodesoup::ERepulsionMode UHeartLayout_FruchtermanReingold::GetRepulsionMode() const
+{
+	switch (RepulsionMode)
+	{
+	case EHeartLayoutRepulsionMode::SpatialGrid:
+		return Nodesoup::ERepulsionMode::SpatialGrid;
+	case EHeartLayoutRepulsionMode::Exact:
+	default:
+		return Nodesoup::ERepulsionMode::Exact;
+	}
+}
+
+Nodesoup::FExecutionSettings UHeartLayout_FruchtermanReingold::GetExecutionSettings() const
+{
+	Nodesoup::FExecutionSettings Execution;
+	Execution.NumTasks = NumTasks;
+	Execution.SinglePrecision = SinglePrecision;
+	return Execution;
+}
+
+uint32 UHeartLayout_FruchtermanReingold::GetConfigHash() const
+{
+	uint32 Hash = GetTypeHash(Strength);
+	Hash = HashCombineFast(Hash, GetTypeHash(RepulsionMode));
+	Hash = HashCombineFast(Hash, GetTypeHash(NumTasks));
+	Hash = HashCombineFast(Hash, GetTypeHash(SinglePrecision));
+	return Hash;
 }
\ No newline at end of file
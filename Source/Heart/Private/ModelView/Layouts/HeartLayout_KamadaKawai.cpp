@@ -1,18 +1,78 @@
 ﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
 
 #include "ModelView/Layouts/HeartLayout_KamadaKawai.h"
+#include "Model/HeartGraph.h"
 #include "Model/HeartGraphInterface.h"
+#include "ModelView/HeartAsyncLayout.h"
+#include "Algorithms/KamadaKawai.h"
+#include "Algorithms/Layout.h"
 #include "Algorithms/Nodesoup.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartLayout_KamadaKawai)
 
 bool UHeartLayout_KamadaKawai::Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes)
 {
+	if (!Nodesoup::KamadaKawai::CanLayout(Nodes.Num()))
+	{
+		UE_LOG(LogHeartGraph, Warning, TEXT("Kamada-Kawai layout skipped: %i nodes exceeds the limit of %i. Use Heart Layout Sparse Stress for large graphs."),
+			Nodes.Num(), Nodesoup::KamadaKawai::MaxVertices)
+		return false;
+	}
+
 	const FHeartGraphAdjacencyList GraphAdjacencyList = GetGraphAdjacencyList(Interface, Nodes);
 
-	const TArray<FVector2D> NewPositions = Nodesoup::kamada_kawai(GraphAdjacencyList.AdjacencyList, Width, Height, Strength, EnergyThreshold);
+	Nodesoup::FExecutionSettings Execution;
+	Execution.NumTasks = NumTasks;
+
+	const TArray<FVector2D> NewPositions = Nodesoup::kamada_kawai(GraphAdjacencyList.AdjacencyList, Width, Height, Strength, EnergyThreshold, Execution);
 
 	ApplyNewPositions(Interface->_getUObject(), Nodes, NewPositions);
 
 	return true;
+}
+
+Heart::Layout::FAsyncLayoutWork UHeartLayout_KamadaKawai::CreateAsyncLayout() const
+{
+	Nodesoup::FExecutionSettings Execution;
+	Execution.NumTasks = NumTasks;
+
+	return [Width = Width, Height = Height, Strength = Strength, EnergyThreshold = EnergyThreshold, Execution]
+		(Heart::Layout::FAsyncLayoutJob& Job)
+		{
+			Nodesoup::FGraphView Graph(Job.GetAdjacencyList().AdjacencyList);
+
+			// Returning no positions leaves the nodes where they are.
+			if (!Nodesoup::KamadaKawai::CanLayout(Graph.Num()))
+			{
+				UE_LOG(LogHeartGraph, Warning, TEXT("Kamada-Kawai layout skipped: %i nodes exceeds the limit of %i. Use Heart Layout Sparse Stress for large graphs."),
+					Graph.Num(), Nodesoup::KamadaKawai::MaxVertices)
+				return TArray<FVector2D>();
+			}
+
+			TArray<FVector2D> Positions;
+			Positions.SetNumZeroed(Graph.Num());
+			// Initial layout on a circle
+			Nodesoup::Circle(Positions);
+
+			const Nodesoup::KamadaKawai Algorithm(Graph, Strength, EnergyThreshold, Execution);
+			Algorithm(Positions,
+				[&](const TConstArrayView<FVector2D> Current)
+				{
+					if (Job.IsCancelled())
+					{
+						return false;
+					}
+
+					if (Job.ShouldPublish())
+					{
+						TArray<FVector2D> Scaled(Current);
+						Nodesoup::CenterAndScale(Width, Height, Scaled);
+						Job.Publish(Scaled);
+					}
+					return true;
+				});
+
+			Nodesoup::CenterAndScale(Width, Height, Positions);
+			return Positions;
+		};
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "ModelView/Layouts/HeartLayout_Layered.h"
+#include "Model/HeartGraphInterface.h"
+#include "Algorithms/Nodesoup.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HeartLayout_Layered)
+
+bool UHeartLayout_Layered::Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes)
+{
+	if (Nodes.IsEmpty())
+	{
+		return false;
+	}
+
+	const FHeartGraphAdjacencyList GraphAdjacencyList = GetGraphAdjacencyList(Interface, Nodes);
+
+	TArray<FVector2D> NewPositions = Nodesoup::layered(GraphAdjacencyList.AdjacencyList, LayerSpacing, NodeSpacing, CrossingSweeps);
+
+	// Keep the layout anchored to the top-left corner of where the nodes were.
+	FVector2D Origin(TNumericLimits<double>::Max());
+	for (const FHeartNodeGuid& Node : Nodes)
+	{
+		Origin = FVector2D::Min(Origin, Interface->GetNodeLocation(Node));
+	}
+
+	for (FVector2D& Position : NewPositions)
+	{
+		Position += Origin;
+	}
+
+	ApplyNewPositions(Interface->_getUObject(), Nodes, NewPositions);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "ModelView/Layouts/HeartLayout_SparseStress.h"
+#include "Model/HeartGraphInterface.h"
+#include "ModelView/HeartAsyncLayout.h"
+#include "Algorithms/Layout.h"
+#include "Algorithms/Nodesoup.h"
+#include "Algorithms/SparseStress.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HeartLayout_SparseStress)
+
+bool UHeartLayout_SparseStress::Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes)
+{
+	const FHeartGraphAdjacencyList GraphAdjacencyList = GetGraphAdjacencyList(Interface, Nodes);
+
+	Nodesoup::FExecutionSettings Execution;
+	Execution.NumTasks = NumTasks;
+
+	const TArray<FVector2D> NewPositions = Nodesoup::sparse_stress(GraphAdjacencyList.AdjacencyList, Width, Height, NumPivots, Iterations, Execution);
+
+	ApplyNewPositions(Interface->_getUObject(), Nodes, NewPositions);
+
+	return true;
+}
+
+Heart::Layout::FAsyncLayoutWork UHeartLayout_SparseStress::CreateAsyncLayout() const
+{
+	Nodesoup::FExecutionSettings Execution;
+	Execution.NumTasks = NumTasks;
+
+	return [Width = Width, Height = Height, NumPivots = NumPivots, Iterations = Iterations, Execution]
+		(Heart::Layout::FAsyncLayoutJob& Job)
+		{
+			TArray<FVector2D> Positions;
+			Nodesoup::SparseStress Algorithm(Job.GetAdjacencyList().AdjacencyList, NumPivots, Execution);
+			Algorithm.Initialize(Positions);
+
+			for (int32 i = 0; i < Iterations && !Job.IsCancelled(); ++i)
+			{
+				Algorithm(Positions);
+
+				if (Job.ShouldPublish())
+				{
+					TArray<FVector2D> Scaled = Positions;
+					Nodesoup::CenterAndScale(Width, Height, Scaled);
+					Job.Publish(Scaled);
+				}
+			}
+
+			Nodesoup::CenterAndScale(Width, Height, Positions);
+			return Positions;
+		};
+}
@@ -8,12 +8,16 @@
 #include "HeartGuids.h"
 #include "HeartGraphTypes.h"
 #include "HeartGraphPinReference.h"
+#include "HeartGraphTopology.h"
+#include "HeartNodeStructColumn.h"
+#include "StructUtils/InstancedStruct.h"
 #include "HeartGraph.generated.h"
 
 namespace Heart::API
 {
 	class FNodeEdit;
 	class FPinEdit;
+	class FGraphBatch;
 }
 
 class UHeartGraph;
@@ -28,6 +32,7 @@ namespace Heart::Events
 	using FNodeAddOrRemove = TMulticastDelegate<void(UHeartGraphNode*)>;
 	using FNodeMoveEventHandler = TMulticastDelegate<void(const FHeartNodeMoveEvent&)>;
 	using FConnectionEventHandler = TMulticastDelegate<void(const FHeartGraphConnectionEvent&)>;
+	using FBatchEventHandler = TMulticastDelegate<void(const FHeartGraphBatchEvent&)>;
 
 	using FGraphExtensionAddOrRemove = TMulticastDelegate<void(UHeartGraphExtension*)>;
 	using FNodeComponentAddOrRemove = TMulticastDelegate<void(FHeartNodeGuid, UHeartGraphNodeComponent*)>;
@@ -73,6 +78,7 @@ class HEART_API UHeartGraph : public UObject, public IHeartGraphInterface
 	friend class UHeartGraphSchema;
 	friend Heart::API::FNodeEdit;
 	friend Heart::API::FPinEdit;
+	friend Heart::API::FGraphBatch;
 
 public:
 	UHeartGraph();
@@ -86,6 +92,7 @@ public:
 	/* UObject */
 	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
 	virtual void PostInitProperties() override;
+	virtual void Serialize(FArchive& Ar) override;
 	virtual void PostLoad() override;
 	virtual void PostDuplicate(EDuplicateMode::Type DuplicateMode) override;
 	/* UObject */
@@ -106,6 +113,9 @@ public:
 	// Return true in Iter to continue iterating
 	void ForEachExtension(const TFunctionRef<bool(UHeartGraphExtension*)>& Iter) const;
 
+	// Is a Heart::API::FGraphBatch open on this graph? While true, events are deferred until the batch closes.
+	bool IsBatching() const { return BatchDepth > 0; }
+
 protected:
 	// Called after nodes have been added.
 	virtual void HandleNodeAddEvent(const FHeartNodeAddEvent& Event);
@@ -119,6 +129,21 @@ protected:
 	// Called after a pin connection change has been made. Called by Heart::Connections::~FEdit
 	virtual void HandleGraphConnectionEvent(const FHeartGraphConnectionEvent& Event);
 
+private:
+	void BroadcastNodeAddEvent(const FHeartNodeAddEvent& Event);
+	void BroadcastNodeRemoveEvent(const FHeartNodeRemoveEvent& Event);
+	void BroadcastNodeMoveEvent(const FHeartNodeMoveEvent& Event);
+	void BroadcastGraphConnectionEvent(const FHeartGraphConnectionEvent& Event);
+
+	// Called by Heart::API::FGraphBatch. Batches may nest; events are only flushed when the outermost batch closes.
+	void BeginBatch();
+	void EndBatch();
+
+	void RemoveFromNodeComponentIndex(const FHeartNodeGuid& Node, TSubclassOf<UHeartGraphNodeComponent> Class);
+
+	// Returns NodeComponentIndex, rebuilding it first if NodeComponents was replaced since it was last built.
+	const TMap<FHeartNodeGuid, TArray<TSubclassOf<UHeartGraphNodeComponent>>>& GetNodeComponentIndex() const;
+
 
 	/*-----------------------
 			GETTERS
@@ -134,6 +159,9 @@ public:
 	Heart::Events::FNodeMoveEventHandler::RegistrationType& GetOnNodeMoved() { return OnNodeMoved; }
 	Heart::Events::FConnectionEventHandler::RegistrationType& GetOnNodeConnectionsChanged() { return OnNodeConnectionsChanged; }
 
+	// Listeners that can handle many edits at once should bind to this instead of the individual node events above.
+	Heart::Events::FBatchEventHandler::RegistrationType& GetOnBatchEvent() { return OnBatchEvent; }
+
 	Heart::Events::FGraphExtensionAddOrRemove::RegistrationType& GetOnExtensionAdded() { return OnExtensionAdded; }
 	Heart::Events::FGraphExtensionAddOrRemove::RegistrationType& GetOnExtensionRemoved() { return OnExtensionRemoved; }
 
@@ -163,6 +191,9 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Heart|Graph")
 	void GetNodeArray(TArray<UHeartGraphNode*>& OutNodes) const;
 
+	// Cached connection index for algorithms that walk the whole graph repeatedly. Created on first use.
+	FHeartGraphTopology& GetTopology();
+
 protected:
 	UFUNCTION(BlueprintCallable, Category = "Heart|Graph", meta = (DisplayName = "Get Nodes"))
 	const TMap<FHeartNodeGuid, UHeartGraphNode*>& BP_GetNodes() const { return ObjectPtrDecay(Nodes); }
@@ -293,7 +324,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Heart|Graph", Meta = (DeterminesOutputType = "Class", DisplayName = "Get Node Component"))
 	UHeartGraphNodeComponent* GetNodeComponent(const FHeartNodeGuid& Node, TSubclassOf<UHeartGraphNodeComponent> Class) const;
 
-	/** Finds all components for a node. (Iterates over all components; may be slow if graph has many node components!) */
+	/** Finds all components for a node. */
 	UFUNCTION(BlueprintCallable, Category = "Heart|Graph")
 	TArray<UHeartGraphNodeComponent*> GetNodeComponentsForNode(const FHeartNodeGuid& Node) const;
 
@@ -333,6 +364,79 @@ public:
 	void RemoveComponentsForNodes(TConstArrayView<FHeartNodeGuid> InNodes);
 
 
+	/*----------------------------
+		STRUCT NODE COMPONENTS
+	----------------------------*/
+
+	// Struct components are plain data, stored by value in one column per struct type, instead of as a UObject per node.
+
+	FHeartNodeStructColumn* FindStructColumn(const UScriptStruct* Type);
+	const FHeartNodeStructColumn* FindStructColumn(const UScriptStruct* Type) const;
+
+	FStructView FindNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type);
+	FConstStructView FindNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type) const;
+	FStructView FindOrAddNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type);
+	bool RemoveNodeStruct(const FHeartNodeGuid& Node, const UScriptStruct* Type);
+
+	template <typename TStruct>
+	TStruct* FindNodeStruct(const FHeartNodeGuid& Node)
+	{
+		return FindNodeStruct(Node, TBaseStructure<TStruct>::Get()).template GetPtr<TStruct>();
+	}
+
+	template <typename TStruct>
+	const TStruct* FindNodeStruct(const FHeartNodeGuid& Node) const
+	{
+		return FindNodeStruct(Node, TBaseStructure<TStruct>::Get()).template GetPtr<TStruct>();
+	}
+
+	// Returns nullptr if the node is invalid, or the stored component is not of the template type.
+	template <typename TStruct>
+	TStruct* FindOrAddNodeStruct(const FHeartNodeGuid& Node)
+	{
+		const UScriptStruct* Type = TBaseStructure<TStruct>::Get();
+		const FStructView View = FindOrAddNodeStruct(Node, Type);
+		if (!View.IsValid() || !View.GetScriptStruct()->IsChildOf(Type))
+		{
+			return nullptr;
+		}
+		return reinterpret_cast<TStruct*>(View.GetMemory());
+	}
+
+	template <typename TStruct>
+	bool RemoveNodeStruct(const FHeartNodeGuid& Node)
+	{
+		return RemoveNodeStruct(Node, TBaseStructure<TStruct>::Get());
+	}
+
+	// Visit every node that has a struct component of the template type.
+	template <typename TStruct>
+	void ForEachNodeStruct(TFunctionRef<void(const FHeartNodeGuid&, TStruct&)> Iter)
+	{
+		if (FHeartNodeStructColumn* Column = FindStructColumn(TBaseStructure<TStruct>::Get()))
+		{
+			Column->ForEach<TStruct>(Iter);
+		}
+	}
+
+	template <typename TStruct>
+	void ForEachNodeStruct(TFunctionRef<void(const FHeartNodeGuid&, const TStruct&)> Iter) const
+	{
+		if (const FHeartNodeStructColumn* Column = FindStructColumn(TBaseStructure<TStruct>::Get()))
+		{
+			Column->ForEach<TStruct>(Iter);
+		}
+	}
+
+	/** Copies out a node's struct component of the requested type. Returns an empty struct if the node doesn't have one. */
+	UFUNCTION(BlueprintCallable, Category = "Heart|Graph")
+	FInstancedStruct GetNodeStruct(const FHeartNodeGuid& Node, UScriptStruct* Type) const;
+
+	/** Sets a node's struct component of the value's type, adding it if the node doesn't have one yet. */
+	UFUNCTION(BlueprintCallable, Category = "Heart|Graph")
+	void SetNodeStruct(const FHeartNodeGuid& Node, const FInstancedStruct& Value);
+
+
 	/*----------------------------
 			PIN EDITING
 	----------------------------*/
@@ -377,10 +481,34 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	TMap<TSubclassOf<UHeartGraphNodeComponent>, FHeartGraphNodeComponentMap> NodeComponents;
 
+	// The classes of each node's components, so per-node lookups don't have to visit every class in NodeComponents.
+	// Kept in sync by FindOrAddNodeComponent and RemoveNodeComponent. Whenever NodeComponents is serialized in, duplicated,
+	// or cleaned up, the index is marked dirty instead, and lazily rebuilt by the next lookup.
+	mutable TMap<FHeartNodeGuid, TArray<TSubclassOf<UHeartGraphNodeComponent>>> NodeComponentIndex;
+	mutable bool NodeComponentIndexDirty = true;
+
+	// Struct node components, one column per struct type
+	UPROPERTY()
+	TArray<FHeartNodeStructColumn> StructComponents;
+
+	TUniquePtr<FHeartGraphTopology> Topology;
+
 	Heart::Events::FNodeAddOrRemove OnNodeAdded;
 	Heart::Events::FNodeAddOrRemove OnNodeRemoved;
 	Heart::Events::FNodeMoveEventHandler OnNodeMoved;
 	Heart::Events::FConnectionEventHandler OnNodeConnectionsChanged;
+	Heart::Events::FBatchEventHandler OnBatchEvent;
+
+	// Events deferred by the open batch. A UPROPERTY so that removed nodes are kept alive until the batch closes.
+	UPROPERTY(Transient)
+	FHeartGraphBatchEvent PendingBatch;
+
+	// Lookups for the node lists of PendingBatch, so deduplicating them doesn't scan the arrays. Nodes added and then
+	// removed are dropped from PendingAddedNodes, and compacted out of PendingBatch.Added once, when the batch closes.
+	TSet<FHeartNodeGuid> PendingAddedNodes;
+	TSet<const UHeartGraphNode*> PendingRemovedNodes;
+
+	int32 BatchDepth = 0;
 
 	Heart::Events::FGraphExtensionAddOrRemove OnExtensionAdded;
 	Heart::Events::FGraphExtensionAddOrRemove OnExtensionRemoved;
@@ -314,6 +314,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Heart|GraphNode")
 	bool RemovePin(const FHeartPinGuid& Pin);
 
+	// Remove many pins, announcing the change once. Returns num of pins removed.
+	int32 RemovePins(TConstArrayView<FHeartPinGuid> Pins);
+
 	FHeartGraphPinDesc MakeInstancedPin(EHeartPinDirection Direction);
 
 	// Add a numbered instance pin
@@ -428,12 +431,6 @@ Heart::Query::FPinQueryResult UHeartGraphNode::FindPinsByPredicate(const EHeartP
 template <typename Predicate>
 int32 UHeartGraphNode::RemovePinsByPredicate(const EHeartPinDirection Direction, Predicate Pred)
 {
-	TArray<FHeartPinGuid> PinsToRemove = FindPinsByPredicate(Direction, Pred).Get();
-
-	for (auto&& ToRemove : PinsToRemove)
-	{
-		RemovePin(ToRemove);
-	}
-
-	return PinsToRemove.Num();
+	const TArray<FHeartPinGuid> PinsToRemove = FindPinsByPredicate(Direction, Pred).Get();
+	return RemovePins(PinsToRemove);
 }
\ No newline at end of file
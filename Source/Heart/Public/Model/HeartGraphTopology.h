@@ -0,0 +1,118 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Algorithms/Nodesoup.h"
+#include "HeartGuids.h"
+#include "HeartPinDirection.h"
+
+struct FHeartGraphConnectionEvent;
+class UHeartGraph;
+class UHeartGraphNode;
+
+/**
+ * Cached index of the connections between the nodes of a graph, kept up to date as nodes and connections
+ * change, for algorithms that walk the whole graph every frame, like tick-driven layouts.
+ *
+ * Each node is given a dense index. Indices are stable until a node is removed, at which point the last node is moved
+ * into the removed node's slot. Changes are only recorded as they happen; the compressed outputs are patched the next
+ * time they are requested, and only the rows of nodes whose connections changed are gathered from the graph again.
+ */
+class HEART_API FHeartGraphTopology : FNoncopyable
+{
+public:
+	explicit FHeartGraphTopology(UHeartGraph* InGraph);
+
+	// Incremented each time the outputs are rebuilt. Views returned by GetOutputs and GetInputs are invalidated when this changes.
+	uint32 GetVersion() const { return Version; }
+
+	int32 Num() const { return Guids.Num(); }
+
+	// Reindexes the graph's current nodes from scratch. For when the graph's nodes are changed without broadcasting,
+	// such as when they are cleaned up or flushed after loading or duplicating.
+	void Rebuild();
+
+	int32 FindIndex(const FHeartNodeGuid& Node) const;
+
+	const FHeartNodeGuid& GetGuid(const int32 Index) const { return Guids[Index]; }
+	const TArray<FHeartNodeGuid>& GetGuids() const { return Guids; }
+
+	// Output links of each node, by index. Patches in any changes made to the graph since the last call.
+	Nodesoup::FGraphView GetOutputs();
+
+	// Input links of each node, by index. Transposed from the outputs the first time they are requested after a change.
+	Nodesoup::FGraphView GetInputs();
+
+	/**
+	 * Traversal helpers. These work on node indices, and reuse buffers kept by the topology, so they don't allocate once
+	 * the buffers have grown to fit the graph. They are not reentrant: visitors must not start another traversal, or
+	 * change the graph.
+	 */
+
+	// Calls the visitor for each node linked to Index in the given direction. Nodes linked both ways under
+	// Bidirectional are visited twice.
+	void ForEachLinked(int32 Index, EHeartPinDirection Direction, TFunctionRef<void(int32 Linked)> Visitor);
+
+	// Visits the nodes reachable from Start in breadth-first order, starting with Start itself at depth 0. Return false
+	// from the visitor to stop the search.
+	void BreadthFirst(int32 Start, EHeartPinDirection Direction, TFunctionRef<bool(int32 Index, int32 Depth)> Visitor);
+
+	// Visits the nodes reachable from Start in depth-first pre-order, starting with Start itself. Return false from the
+	// visitor to stop the search.
+	void DepthFirst(int32 Start, EHeartPinDirection Direction, TFunctionRef<bool(int32 Index)> Visitor);
+
+	// Can To be reached from From by following links in the given direction. A node can always reach itself.
+	bool IsReachable(int32 From, int32 To, EHeartPinDirection Direction = EHeartPinDirection::Output);
+
+	// Fills OutOrder with node indices, ordered so that each node comes before the nodes its outputs link to. Returns
+	// false if the graph contains a cycle, in which case the nodes on or after the cycle are left out.
+	bool TopologicalSort(TArray<int32>& OutOrder);
+
+private:
+	void HandleNodeAdded(UHeartGraphNode* Node);
+	void HandleNodeRemoved(UHeartGraphNode* Node);
+	void HandleConnectionsChanged(const FHeartGraphConnectionEvent& Event);
+
+	void AddNode(const FHeartNodeGuid& Node);
+	void MarkDirty(const FHeartNodeGuid& Node);
+	void Update();
+	void UpdateInputs();
+
+	// Starts a new traversal, clearing visited marks.
+	void ResetVisited();
+
+	// Marks a node as visited. Returns false if it already was during this traversal.
+	bool MarkVisited(int32 Index);
+
+	// The graph owns this object, so it always outlives it.
+	UHeartGraph* Graph;
+
+	TArray<FHeartNodeGuid> Guids;
+	TMap<FHeartNodeGuid, int32> Indices;
+
+	// Nodes whose connections must be gathered from the graph again.
+	TBitArray<> DirtyRows;
+	bool AnyDirty = false;
+
+	// For each current index, the row it had in Outputs when it was last built, or INDEX_NONE for new nodes.
+	TArray<int32> PreviousRows;
+
+	// For each row in Outputs, the current index of that node, or INDEX_NONE if the node has been removed.
+	TArray<int32> RowRemap;
+
+	Nodesoup::FCompressedGraph Outputs;
+
+	// The previous outputs, swapped with Outputs when patching, so rebuilding doesn't reallocate.
+	Nodesoup::FCompressedGraph ScratchOutputs;
+
+	uint32 Version = 0;
+
+	// Transpose of Outputs, and the version it was built from.
+	Nodesoup::FCompressedGraph Inputs;
+	uint32 InputsVersion = 0;
+
+	// Traversal buffers. Visited nodes are stamped with the current epoch, so they don't need to be cleared each query.
+	TArray<int32> Frontier;
+	TArray<uint32> VisitEpochs;
+	uint32 VisitEpoch = 0;
+};
\ No newline at end of file
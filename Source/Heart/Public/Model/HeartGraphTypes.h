@@ -59,6 +59,35 @@ struct FHeartNodeMoveEvent
 	bool MoveFinished = false;
 };
 
+/*
+ * Event broadcast once when a batch of graph edits closes, instead of an event per edit. Nodes that were added and then
+ * removed in the same batch are left out entirely, and moves and connection changes only list nodes still in the graph.
+ * Events made outside of a batch are also broadcast as a batch of one, so batch listeners never miss an edit.
+ */
+USTRUCT(BlueprintType)
+struct FHeartGraphBatchEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "HeartGraphBatchEvent")
+	FHeartNodeAddEvent Added;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HeartGraphBatchEvent")
+	FHeartNodeRemoveEvent Removed;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HeartGraphBatchEvent")
+	FHeartNodeMoveEvent Moved;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HeartGraphBatchEvent")
+	FHeartGraphConnectionEvent Connections;
+
+	bool IsEmpty() const
+	{
+		return Added.NewNodes.IsEmpty() && Removed.AffectedNodes.IsEmpty() &&
+			Moved.AffectedNodes.IsEmpty() && Connections.AffectedNodes.IsEmpty() && Connections.AffectedPins.IsEmpty();
+	}
+};
+
 USTRUCT(BlueprintType)
 struct FHeartGraphNodeMessage
 {
@@ -26,6 +26,24 @@ namespace Heart::API
 			const UObject* NodeObject, const FVector2D& Location, UObject* NodeSpawningContext = nullptr);
 	};
 
+	/*
+	 * Scoped batch of graph edits. While any batch is alive, the graph defers its node, move, and connection events, and
+	 * broadcasts them coalesced when the outermost batch goes out of scope. Listeners bound to GetOnBatchEvent receive
+	 * the whole batch as a single FHeartGraphBatchEvent. Unlike FNodeEdit, this doesn't change when edits happen, only
+	 * when they are announced, so it can wrap any mix of FNodeEdit, FPinEdit, and node movement.
+	 */
+	class HEART_API FGraphBatch : FNoncopyable
+	{
+	public:
+		FGraphBatch(IHeartGraphInterface* GraphInterface);
+
+		// Dtor broadcasts the deferred events, if this is the outermost batch.
+		~FGraphBatch();
+
+	private:
+		TObjectPtr<UHeartGraph> Graph;
+	};
+
 	/*
 	 * Central API for creating and deleting nodes in a HeartGraph. All creation and deletion calls are pooled and then
 	 * run in the dtor. This allows us to batch connection rewiring, and broadcast fewer events in a single frame.
@@ -0,0 +1,102 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "HeartGuids.h"
+#include "StructUtils/StructView.h"
+#include "HeartNodeStructColumn.generated.h"
+
+/**
+ * A sparse set of struct components of a single type, keyed by node. Components are stored by value in one dense
+ * allocation, with a map from node to index, so per-node data doesn't need a UObject for each node. Removal swaps the
+ * last component into the hole, so dense order is not stable.
+ */
+USTRUCT()
+struct HEART_API FHeartNodeStructColumn
+{
+	GENERATED_BODY()
+
+	FHeartNodeStructColumn() = default;
+	explicit FHeartNodeStructColumn(const UScriptStruct* InStructType);
+	FHeartNodeStructColumn(const FHeartNodeStructColumn& Other);
+	FHeartNodeStructColumn& operator=(const FHeartNodeStructColumn& Other);
+	~FHeartNodeStructColumn();
+
+	const UScriptStruct* GetStructType() const { return StructType; }
+
+	int32 Num() const { return Nodes.Num(); }
+	bool Contains(const FHeartNodeGuid& Node) const { return Indices.Contains(Node); }
+
+	FStructView Find(const FHeartNodeGuid& Node);
+	FConstStructView Find(const FHeartNodeGuid& Node) const;
+
+	// Returns the node's component, adding a default initialized one if it doesn't have one yet.
+	FStructView FindOrAdd(const FHeartNodeGuid& Node);
+
+	bool Remove(const FHeartNodeGuid& Node);
+
+	void Empty();
+
+	// Nodes in dense order, matching the indices passed to GetAt.
+	TConstArrayView<FHeartNodeGuid> GetNodes() const { return Nodes; }
+
+	FStructView GetAt(int32 Index);
+	FConstStructView GetAt(int32 Index) const;
+
+	// Visit every component in the column. T must be the column's struct type, or a parent of it.
+	template <typename T>
+	void ForEach(TFunctionRef<void(const FHeartNodeGuid&, T&)> Iter)
+	{
+		check(StructType && StructType->IsChildOf(TBaseStructure<T>::Get()));
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			Iter(Nodes[i], *reinterpret_cast<T*>(GetData(i)));
+		}
+	}
+
+	template <typename T>
+	void ForEach(TFunctionRef<void(const FHeartNodeGuid&, const T&)> Iter) const
+	{
+		check(StructType && StructType->IsChildOf(TBaseStructure<T>::Get()));
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			Iter(Nodes[i], *reinterpret_cast<const T*>(GetData(i)));
+		}
+	}
+
+	bool Serialize(FArchive& Ar);
+	bool Identical(const FHeartNodeStructColumn* Other, uint32 PortFlags) const;
+	void AddStructReferencedObjects(FReferenceCollector& Collector);
+
+private:
+	uint8* GetData(const int32 Index) const { return Memory + Index * Stride; }
+
+	void SetStructType(const UScriptStruct* InStructType);
+	void Grow(int32 MinCapacity);
+	void Release();
+
+	TObjectPtr<const UScriptStruct> StructType;
+
+	// Dense list of the node owning each component
+	TArray<FHeartNodeGuid> Nodes;
+
+	// Index of each node's component in the dense arrays
+	TMap<FHeartNodeGuid, int32> Indices;
+
+	// Component memory, Stride bytes per component. Like TArray, this assumes structs can be relocated with memcpy.
+	uint8* Memory = nullptr;
+	int32 Capacity = 0;
+	int32 Stride = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FHeartNodeStructColumn> : public TStructOpsTypeTraitsBase2<FHeartNodeStructColumn>
+{
+	enum
+	{
+		WithCopy = true,
+		WithSerializer = true,
+		WithIdentical = true,
+		WithAddStructReferencedObjects = true,
+	};
+};
\ No newline at end of file
@@ -25,6 +25,64 @@ namespace Heart::API
 			}
 		};
 
+		// A record of the connections made and broken by an edit. Unlike mementos, this only stores the links that
+		// changed, instead of every connection on each node involved.
+		class HEART_API FDelta
+		{
+			friend FPinEdit;
+
+			struct FLink
+			{
+				FHeartGraphPinReference A;
+				FHeartGraphPinReference B;
+
+				// Links are undirected, so A-B and B-A are the same link.
+				bool operator==(const FLink& Other) const
+				{
+					return (A == Other.A && B == Other.B) || (A == Other.B && B == Other.A);
+				}
+
+				friend uint32 GetTypeHash(const FLink& V)
+				{
+					return GetTypeHash(V.A) ^ GetTypeHash(V.B);
+				}
+
+				friend FArchive& operator<<(FArchive& Ar, FLink& V)
+				{
+					return Ar << V.A << V.B;
+				}
+			};
+
+			// Bumped whenever the serialized layout of a delta changes.
+			enum EVersion : int32
+			{
+				Initial = 1,
+
+				LatestVersion = Initial
+			};
+
+			// Records a link as made or broken, unless it cancels out a link recorded the other way.
+			void Record(bool Connected, const FHeartGraphPinReference& A, const FHeartGraphPinReference& B);
+
+			// Rebuilds the link lookups, if they are out of date with the lists, such as after loading.
+			void UpdateLookups();
+
+			TArray<FLink> Added;
+			TArray<FLink> Removed;
+
+			// Index of each link in Added and Removed. Not serialized.
+			TMap<FLink, int32> AddedLookup;
+			TMap<FLink, int32> RemovedLookup;
+
+		public:
+			bool IsEmpty() const { return Added.IsEmpty() && Removed.IsEmpty(); }
+
+			// Get a delta that undoes this one.
+			FDelta Inverse() const;
+
+			friend HEART_API FArchive& operator<<(FArchive& Ar, FDelta& V);
+		};
+
 		FPinEdit(UHeartGraph* Graph)
 		  : Graph(Graph) {}
 
@@ -54,13 +112,25 @@ namespace Heart::API
 
 		FPinEdit& RestoreMementos(const TMap<FHeartNodeGuid, FMemento>& Mementos);
 
+		// Record each connection made or broken by this edit from now on into a delta. The delta must outlive the edit.
+		FPinEdit& RecordDelta(FDelta& OutDelta);
+
+		// Make and break the connections recorded in a delta again.
+		FPinEdit& ApplyDelta(const FDelta& Delta);
+
+		// Undo the connections recorded in a delta.
+		FPinEdit& RevertDelta(const FDelta& Delta);
+
 		[[nodiscard]] bool Modified() const { return !ChangedPins.IsEmpty(); }
 
 	private:
 		void Internal_Disconnect(UHeartGraphNode* NodeA, const FHeartGraphPinReference& PinA, UHeartGraphNode* NodeB, const FHeartGraphPinReference& PinB);
 
+		void Internal_ApplyLinks(TConstArrayView<FDelta::FLink> Removes, TConstArrayView<FDelta::FLink> Adds);
+
 		UHeartGraph* Graph;
 		TMultiMap<UHeartGraphNode*, FHeartPinGuid> ChangedPins;
+		FDelta* Recording = nullptr;
 	};
 }
 
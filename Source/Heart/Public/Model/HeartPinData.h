@@ -26,11 +26,12 @@ namespace Heart
 }
 
 // @todo this should not be BlueprintType. it only is temporarily until there is a way to view pins in the editor window without making PinData VisibleInstanceOnly
-// Long-term, it would be nice to make this type not a USTRUCT at all, and swap out the TMaps for the faster one from VoxelCore
 // This struct is *intentionally* not exported, as it should not be accessible to anything but UHeartGraphNode
 
 /**
  * Container for all pin data on a Heart Node, including links to other nodes.
+ * Pins are stored as a table of parallel arrays in the order they were added, so iterating pins or their connections
+ * walks contiguous memory. Pins are found by guid or by name through open-addressing indices into the table.
  */
 USTRUCT(BlueprintType)
 struct FHeartNodePinData
@@ -41,10 +42,15 @@ struct FHeartNodePinData
 	friend Heart::Query::FPinQueryResult;
 	friend Heart::API::FPinEdit;
 
+	void PostSerialize(const FArchive& Ar);
+
 protected:
 	void AddPin(FHeartPinGuid NewKey, const FHeartGraphPinDesc& Desc);
 	bool RemovePin(FHeartPinGuid Key);
 
+	// Removes many pins at once, compacting the table in a single pass. Returns the number of pins removed.
+	int32 RemovePins(TConstArrayView<FHeartPinGuid> Keys);
+
 	int32 Num() const;
 	bool Contains(FHeartPinGuid Key) const;
 	int32 GetPinIndex(FHeartPinGuid Key) const;
@@ -55,17 +61,29 @@ protected:
 	TConstStructView<FHeartGraphPinDesc> ViewPin(const FHeartPinGuid Key) const;
 
 	// Gets a reference to a pin. For a safer function, use ViewPinDesc when possible.
-	FHeartGraphPinDesc& GetPinChecked(FHeartPinGuid Key);
+	const FHeartGraphPinDesc& GetPinChecked(FHeartPinGuid Key) const;
+
+	// Replaces the description of an existing pin, keeping the name index up to date if it was renamed.
+	void SetPinDesc(FHeartPinGuid Key, const FHeartGraphPinDesc& Desc);
 
 	TConstStructView<FHeartGraphPinConnections> ViewConnections(FHeartPinGuid Key) const;
+
+	// Gets a reference to the connections of a pin. The pin must exist.
 	FHeartGraphPinConnections& GetConnectionsMutable(FHeartPinGuid Key);
 
-	void AddConnection(const FHeartPinGuid Key, const FHeartGraphPinReference& Pin);
+	// Returns false if the pin was already connected.
+	bool AddConnection(const FHeartPinGuid Key, const FHeartGraphPinReference& Pin);
 	bool RemoveConnection(const FHeartPinGuid Key, const FHeartGraphPinReference& Pin);
 
+	// Copies the connections of all pins that have any.
+	TMap<FHeartPinGuid, FHeartGraphPinConnections> GetAllConnections() const;
+
+	// Replaces the connections of every pin. Pins missing from the map are left without connections.
+	void SetAllConnections(const TMap<FHeartPinGuid, FHeartGraphPinConnections>& Connections);
+
 	FORCEINLINE const FHeartGraphPinConnections& operator[](const FHeartPinGuid Key)
 	{
-		return PinConnections.FindChecked(Key);
+		return GetConnectionsMutable(Key);
 	}
 
 	/**
@@ -74,9 +92,9 @@ protected:
 	template <typename Predicate>
 	TOptional<FHeartPinGuid> Find(Predicate Pred) const
 	{
-		for (auto&& Element : PinDescriptions)
+		for (int32 i = 0; i < PinGuids.Num(); ++i)
 		{
-			if (auto Result = Pred(Element);
+			if (auto Result = Pred(PinGuids[i], PinDescs[i]);
 				Result.IsSet())
 			{
 				return Result.GetValue();
@@ -85,15 +103,54 @@ protected:
 		return NullOpt;
 	}
 
-	// Maps pins to their Pin Description, which carries all unique instance data about
+	// Index of a pin in the table, or INDEX_NONE.
+	int32 FindIndex(FHeartPinGuid Key) const;
+
+	// Index of the first pin with this name in the table, or INDEX_NONE.
+	int32 FindIndexByName(FName Name) const;
+
+	void RebuildIndex();
+	void InsertIntoIndex(int32 Index);
+
+	// Guid of each pin, in the order they were added to the node.
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
-	TMap<FHeartPinGuid, FHeartGraphPinDesc> PinDescriptions;
+	TArray<FHeartPinGuid> PinGuids;
 
-	// Maps pins to their connections in other nodes.
+	// Pin Description of each pin, which carries all unique instance data about it.
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
-	TMap<FHeartPinGuid, FHeartGraphPinConnections> PinConnections;
+	TArray<FHeartGraphPinDesc> PinDescs;
 
-	// Maintains the original order of pins as added to the node.
+	// Connections of each pin to pins in other nodes.
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
+	TArray<FHeartGraphPinConnections> PinLinks;
+
+	// Open-addressing hash index, with linear probing. Each slot holds a table index plus one, or zero when empty.
+	// Not serialized; rebuilt after loading.
+	TArray<int32> IndexSlots;
+
+	// Same as IndexSlots, but hashed by pin name. Pins are inserted in table order, so duplicate names resolve to the
+	// first pin, matching a linear scan.
+	TArray<int32> NameSlots;
+
+	// The legacy layout is kept in every build, so cooked data saved before the table layout still loads its pins.
+	UE_DEPRECATED(5.5, "Replaced by PinGuids/PinDescs")
+	UPROPERTY()
+	TMap<FHeartPinGuid, FHeartGraphPinDesc> PinDescriptions;
+
+	UE_DEPRECATED(5.5, "Replaced by PinLinks")
+	UPROPERTY()
+	TMap<FHeartPinGuid, FHeartGraphPinConnections> PinConnections;
+
+	UE_DEPRECATED(5.5, "Replaced by the order of PinGuids")
+	UPROPERTY()
 	TMap<FHeartPinGuid, int32> PinOrder;
+};
+
+template<>
+struct TStructOpsTypeTraits<FHeartNodePinData> : public TStructOpsTypeTraitsBase2<FHeartNodePinData>
+{
+	enum
+	{
+		WithPostSerialize = true,
+	};
 };
\ No newline at end of file
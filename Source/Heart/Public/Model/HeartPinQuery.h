@@ -4,23 +4,49 @@
 
 #include "HeartGraphPinDesc.h"
 #include "HeartGuids.h"
+#include "HeartPinData.h"
 #include "HeartQueries.h"
 
-struct FHeartNodePinData;
-
 namespace Heart::Query
 {
 	class HEART_API FPinQueryResult : public TMapQueryBase<FPinQueryResult, FHeartPinGuid, FHeartGraphPinDesc>
 	{
 		friend TMapQueryBase;
 
+		struct FPinElement
+		{
+			const FHeartPinGuid& Key;
+			const FHeartGraphPinDesc& Value;
+		};
+
+		// Iterates the pin table in pin order
+		class FIterator
+		{
+		public:
+			FIterator(const FHeartNodePinData& Data, const int32 Index)
+			  : Data(Data), Index(Index) {}
+
+			FORCEINLINE FIterator& operator++() { ++Index; return *this; }
+			FORCEINLINE bool operator!=(const FIterator& Other) const { return Index != Other.Index; }
+			FORCEINLINE FPinElement operator*() const { return { Data.PinGuids[Index], Data.PinDescs[Index] }; }
+
+		private:
+			const FHeartNodePinData& Data;
+			int32 Index;
+		};
+
 	public:
 		FPinQueryResult(const FHeartNodePinData& Src);
 
 		// Sort the results by their Pin Order
 		FPinQueryResult& CustomSort();
 
-		const TMap<FHeartPinGuid, FHeartGraphPinDesc>& SimpleData() const;
+		int32 SrcNum() const { return Reference.Num(); }
+
+		const FHeartGraphPinDesc& operator[](const FHeartPinGuid Key) const { return Reference.PinDescs[Reference.FindIndex(Key)]; }
+
+		FIterator begin() const { return FIterator(Reference, 0); }
+		FIterator end  () const { return FIterator(Reference, Reference.Num()); }
 
 	private:
 		const FHeartNodePinData& Reference;
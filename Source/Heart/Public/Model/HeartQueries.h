@@ -4,6 +4,8 @@
 
 #include "Containers/Array.h"
 #include "Templates/UnrealTypeTraits.h"
+#include "Templates/Function.h"
+#include "Async/ParallelFor.h"
 
 namespace Heart::Query
 {
@@ -27,6 +29,18 @@ namespace Heart::Query
 		// Instead of making redundant calls, the projection results will be cached in a map, so each key is only ran
 		// through the callback once.
 		ProjectionCache = 1 << 0,
+
+		// Filters, sorts, and limits are recorded instead of applied immediately, and are all resolved in a single pass
+		// when the results are needed. Iteration and Find run directly over the source data without copying the keys.
+		// Predicates passed to a lazy query must stay valid until the results are resolved.
+		Lazy = 1 << 1,
+
+		// Filters and ForEach callbacks are run across worker threads, in chunks, once there are enough results to be
+		// worth it (see SetParallelThreshold). Predicates must be thread-safe, and must not write to shared state.
+		// Filtered results keep their order. ForEach callbacks are not called in any particular order. Delegate filters
+		// and callbacks may call into Blueprint, so while one is pending, or being called, the query runs serially on
+		// the calling thread.
+		Parallel = 1 << 2,
 	};
 	ENUM_CLASS_FLAGS(EFlags)
 
@@ -87,7 +101,7 @@ namespace Heart::Query
 		FORCEINLINE		  QueryType& AsType()		{ return *static_cast<		QueryType*>(this); }
 		FORCEINLINE const QueryType& AsType() const { return *static_cast<const QueryType*>(this); }
 
-		FORCEINLINE auto Lookup(KeyType Key) const
+		FORCEINLINE decltype(auto) Lookup(KeyType Key) const
 		{
 			if constexpr (FImplFeatures::template THasMemberFunction_SimpleData<QueryType>::Value)
 			{
@@ -158,6 +172,99 @@ namespace Heart::Query
 			}
 		};
 
+		// Calls a predicate with whichever of the key and value it takes. The value is only fetched if needed.
+		template <typename Predicate, typename ValueGetter>
+		static decltype(auto) InvokePredicate(Predicate& Pred, const PassedKey Key, ValueGetter& GetValue)
+		{
+			if constexpr (TIsPredicate<Predicate>::IsKeyPredicate)
+			{
+				return Pred(Key);
+			}
+			else if constexpr (TIsPredicate<Predicate>::IsValuePredicate)
+			{
+				return Pred(GetValue());
+			}
+			else
+			{
+				return Pred(Key, GetValue());
+			}
+		}
+
+		bool HasPending() const
+		{
+			return !KeyFilters.IsEmpty() || !ValueFilters.IsEmpty() || PendingSort || PendingLimit != INDEX_NONE;
+		}
+
+		// A limit applies to the results as they were when it was recorded, so it has to be resolved before a filter or
+		// sort can be recorded after it.
+		void ResolvePendingLimit()
+		{
+			if (PendingLimit != INDEX_NONE)
+			{
+				InitResults();
+			}
+		}
+
+		// Checks a key against the pending filters of a lazy query.
+		template <typename ValueGetter>
+		bool PassesFilters(const PassedKey Key, ValueGetter& GetValue) const
+		{
+			for (auto&& KeyFilter : KeyFilters)
+			{
+				if (!KeyFilter(Key))
+				{
+					return false;
+				}
+			}
+
+			if (!ValueFilters.IsEmpty())
+			{
+				decltype(auto) Value = GetValue();
+				for (auto&& ValueFilter : ValueFilters)
+				{
+					if (!ValueFilter(Key, Value))
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * Walks the current results, or the source data if there are none, in a single pass, and calls Func with the
+		 * key and a value getter for each key passing the pending filters, until Func returns false. Key filters run
+		 * before value filters, so values are only looked up for keys that might pass. Pending sorts and limits are not
+		 * applied here.
+		 */
+		template <typename FuncType>
+		void Scan(FuncType&& Func) const
+		{
+			if (Results.IsSet())
+			{
+				for (auto&& Key : Results.GetValue())
+				{
+					auto GetValue = [this, &Key]() -> decltype(auto) { return Lookup(Key); };
+					if (PassesFilters(Key, GetValue) && !Func(Key, GetValue))
+					{
+						return;
+					}
+				}
+			}
+			else
+			{
+				for (auto&& Element : FQueryRange(this))
+				{
+					auto GetValue = [&Element]() -> decltype(auto) { return (Element.Value); };
+					if (PassesFilters(Element.Key, GetValue) && !Func(Element.Key, GetValue))
+					{
+						return;
+					}
+				}
+			}
+		}
+
 	public:
 		// Enable query features
 		QueryType& Enable(const EFlags InFlags)
@@ -183,34 +290,56 @@ namespace Heart::Query
 		>
 		QueryType& Filter(Predicate Pred)
 		{
-			InitResults();
-
-			for (auto It = Results.GetValue().CreateIterator(); It; ++It)
+			if (EnumHasAnyFlags(Flags, Lazy))
 			{
+				ResolvePendingLimit();
+
 				if constexpr (TIsPredicate<Predicate, bool>::IsKeyPredicate)
 				{
-					if (!Eval<Invert>(Pred(*It)))
-					{
-						It.RemoveCurrentSwap();
-					}
+					KeyFilters.Emplace([Pred](const PassedKey Key) { return Eval<Invert>(Pred(Key)); });
 				}
-
-				if constexpr (TIsPredicate<Predicate, bool>::IsValuePredicate)
+				else if constexpr (TIsPredicate<Predicate, bool>::IsValuePredicate)
 				{
-					if (!Eval<Invert>(Pred(Lookup(*It))))
-					{
-						It.RemoveCurrentSwap();
-					}
+					ValueFilters.Emplace([Pred](PassedKey, const PassedValue Value) { return Eval<Invert>(Pred(Value)); });
+				}
+				else
+				{
+					ValueFilters.Emplace([Pred](const PassedKey Key, const PassedValue Value) { return Eval<Invert>(Pred(Key, Value)); });
 				}
 
-				if constexpr (TIsPredicate<Predicate, bool>::IsKeyValuePredicate)
+				return AsType();
+			}
+
+			InitResults();
+
+			if (ShouldRunParallel(Results->Num()))
+			{
+				CompactParallel(
+					[this, &Pred](const PassedKey Key)
+					{
+						auto GetValue = [this, &Key]() -> decltype(auto) { return Lookup(Key); };
+						return Eval<Invert>(InvokePredicate(Pred, Key, GetValue));
+					});
+				return AsType();
+			}
+
+			// Stable, so results keep the same order as on the parallel path.
+			Results->RemoveAll(
+				[this, &Pred](const PassedKey Key)
 				{
-					if (!Eval<Invert>(Pred(*It, Lookup(*It))))
+					if constexpr (TIsPredicate<Predicate, bool>::IsKeyPredicate)
 					{
-						It.RemoveCurrentSwap();
+						return !Eval<Invert>(Pred(Key));
 					}
-				}
-			}
+					else if constexpr (TIsPredicate<Predicate, bool>::IsValuePredicate)
+					{
+						return !Eval<Invert>(Pred(Lookup(Key)));
+					}
+					else
+					{
+						return !Eval<Invert>(Pred(Key, Lookup(Key)));
+					}
+				});
 
 			return AsType();
 		}
@@ -227,19 +356,7 @@ namespace Heart::Query
 		QueryType& Filter_UObject(UserClass* InUserObject,
 			typename FFilter::template TMethodPtr<UserClass, VarTypes...> InFunc, VarTypes... Vars)
 		{
-			FFilter Delegate = FFilter::CreateUObject(InUserObject, InFunc, Forward<VarTypes>(Vars)...);
-
-			InitResults();
-
-			for (auto It = Results.GetValue().CreateIterator(); It; ++It)
-			{
-				if (!Eval<Invert>(Delegate.Execute(Lookup(*It))))
-				{
-					It.RemoveCurrentSwap();
-				}
-			}
-
-			return AsType();
+			return FilterDelegate<Invert>(FFilter::CreateUObject(InUserObject, InFunc, Forward<VarTypes>(Vars)...));
 		}
 
 		/**
@@ -252,19 +369,7 @@ namespace Heart::Query
 		QueryType& Filter_UObject(UserClass* InUserObject,
 			typename FFilter::template TConstMethodPtr<UserClass, VarTypes...> InFunc, VarTypes... Vars)
 		{
-			FFilter Delegate = FFilter::CreateUObject(InUserObject, InFunc, Forward<VarTypes>(Vars)...);
-
-			InitResults();
-
-			for (auto It = Results.GetValue().CreateIterator(); It; ++It)
-			{
-				if (!Eval<Invert>(Delegate.Execute(Lookup(*It))))
-				{
-					It.RemoveCurrentSwap();
-				}
-			}
-
-			return AsType();
+			return FilterDelegate<Invert>(FFilter::CreateUObject(InUserObject, InFunc, Forward<VarTypes>(Vars)...));
 		}
 
 		/**
@@ -276,6 +381,11 @@ namespace Heart::Query
 		{
 			if (InInvert == EInvert::Invert)
 			{
+				if (HasPending())
+				{
+					InitResults();
+				}
+
 				// Results not being set is implicitly equal to the entire dataset, so the inversion is empty.
 				// Likewise, if the Num in both arrays match, then they contain the same data as well.
 				if (!Results.IsSet() || Results->Num() == RefNum())
@@ -291,25 +401,20 @@ namespace Heart::Query
 					return AsType();
 				}
 
-				// Otherwise, manually flip the values.
+				// Otherwise, manually flip the values, by keeping every key in the source data not in the results.
+				const TSet<KeyType> CurrentResults(Results.GetValue());
 
-				// Create a new array from source data...
 				FStorage NewResults;
-				NewResults.Reserve(RefNum());
+				NewResults.Reserve(RefNum() - CurrentResults.Num());
 				for (auto&& Element : FQueryRange(this))
 				{
-					NewResults.Emplace(Element.Key);
-				}
-
-				// ... remove all elements currently in the result...
-				ForEach([&NewResults](const PassedKey Key)
+					if (!CurrentResults.Contains(Element.Key))
 					{
-						NewResults.RemoveSingleSwap(Key);
-					});
-				NewResults.Shrink();
+						NewResults.Emplace(Element.Key);
+					}
+				}
 
-				// ...and assign.
-				Results = NewResults;
+				Results = MoveTemp(NewResults);
 			}
 
 			return AsType();
@@ -324,48 +429,34 @@ namespace Heart::Query
 		>
 		QueryType& ForEach(Predicate Pred)
 		{
-			if (Results.IsSet())
+			// A pending sort needs to see every result before the first one can be given out.
+			if (PendingSort)
 			{
-				for (auto&& Key : Results.GetValue())
-				{
-					if constexpr (TIsPredicate<Predicate>::IsKeyPredicate)
-					{
-						Pred(Key);
-					}
-
-					if constexpr (TIsPredicate<Predicate>::IsValuePredicate)
-					{
-						Pred(Lookup(Key));
-					}
-
-					if constexpr (TIsPredicate<Predicate>::IsKeyValuePredicate)
-					{
-						Pred(Key, Lookup(Key));
-					}
-				}
+				InitResults();
 			}
-			else
+
+			// Check against an upper bound first, so small queries don't resolve anything pending just to find out.
+			if (ShouldRunParallel(Results.IsSet() ? Results->Num() : RefNum()))
 			{
-				for (auto&& Element : FQueryRange(this))
+				InitResults();
+				if (ShouldRunParallel(Results->Num()))
 				{
-					if constexpr (TIsPredicate<Predicate>::IsKeyPredicate)
-					{
-						Pred(Element.Key);
-					}
-
-					if constexpr (TIsPredicate<Predicate>::IsValuePredicate)
-					{
-						Pred(Element.Value);
-					}
-
-					if constexpr (TIsPredicate<Predicate>::IsKeyValuePredicate)
-					{
-						Pred(Element.Key, Element.Value);
-					}
+					const FStorage& Keys = Results.GetValue();
+					ParallelFor(FMath::DivideAndRoundUp(Keys.Num(), ParallelChunkSize),
+						[&](const int32 Chunk)
+						{
+							const int32 End = FMath::Min((Chunk + 1) * ParallelChunkSize, Keys.Num());
+							for (int32 Index = Chunk * ParallelChunkSize; Index < End; ++Index)
+							{
+								auto GetValue = [this, &Key = Keys[Index]]() -> decltype(auto) { return Lookup(Key); };
+								InvokePredicate(Pred, Keys[Index], GetValue);
+							}
+						});
+					return AsType();
 				}
 			}
 
-			return AsType();
+			return ForEachSerial(Pred);
 		}
 
 		using FCallback = TDelegate<void(PassedValue)>;
@@ -378,23 +469,7 @@ namespace Heart::Query
 			typename FCallback::template TMethodPtr<UserClass, VarTypes...> InFunc, VarTypes... Vars)
 		{
 			FCallback Delegate = FCallback::CreateUObject(InUserObject, InFunc, Forward<VarTypes>(Vars)...);
-
-			if (Results.IsSet())
-			{
-				for (auto&& Key : Results.GetValue())
-				{
-					Delegate.Execute(Lookup(Key));
-				}
-			}
-			else
-			{
-				for (auto&& Element : FQueryRange(this))
-				{
-					Delegate.Execute(Element.Value);
-				}
-			}
-
-			return AsType();
+			return ForEachSerial([&Delegate](const PassedValue Value) { Delegate.Execute(Value); });
 		}
 
 		/**
@@ -405,50 +480,67 @@ namespace Heart::Query
 			typename FCallback::template TConstMethodPtr<UserClass, VarTypes...> InFunc, VarTypes... Vars)
 		{
 			FCallback Delegate = FCallback::CreateUObject(InUserObject, InFunc, Forward<VarTypes>(Vars)...);
-
-			if (Results.IsSet())
-			{
-				for (auto&& Key : Results.GetValue())
-				{
-					Delegate.Execute(Lookup(Key));
-				}
-			}
-			else
-			{
-				for (auto&& Element : FQueryRange(this))
-				{
-					Delegate.Execute(Element.Value);
-				}
-			}
-
-			return AsType();
+			return ForEachSerial([&Delegate](const PassedValue Value) { Delegate.Execute(Value); });
 		}
 
+		/**
+		 * Returns the first result that passes a predicate. Doesn't resolve anything pending in a lazy query, and unless
+		 * a sort is pending, stops at the first match.
+		 */
 		template <typename Predicate>
 		TOptional<KeyType> Find(Predicate Pred) const
 		{
-			if (Results.IsSet())
+			TOptional<KeyType> Found;
+
+			if (!PendingSort)
 			{
-				for (auto&& Key : Results.GetValue())
-				{
-					if (Pred(Lookup(Key)))
+				int32 Remaining = PendingLimit;
+				Scan([&](const PassedKey Key, auto& GetValue)
 					{
-						return Key;
-					}
-				}
+						if (Remaining == 0)
+						{
+							return false;
+						}
+						--Remaining;
+
+						if (Pred(GetValue()))
+						{
+							Found = Key;
+							return false;
+						}
+						return true;
+					});
+
+				return Found;
 			}
-			else
-			{
-				for (auto&& Element : FQueryRange(this))
+
+			// With a sort pending, the first match is the lowest ranked match, which can be found without sorting.
+			Scan([&](const PassedKey Key, auto& GetValue)
 				{
-					if (Pred(Element.Value))
+					if ((!Found.IsSet() || PendingSort(Key, Found.GetValue())) && Pred(GetValue()))
 					{
-						return Element.Key;
+						Found = Key;
 					}
+					return true;
+				});
+
+			// If the results are limited, the match must also be ranked within the limit.
+			if (Found.IsSet() && PendingLimit != INDEX_NONE)
+			{
+				int32 RankedBefore = 0;
+				Scan([&](const PassedKey Key, auto&)
+					{
+						RankedBefore += PendingSort(Key, Found.GetValue());
+						return RankedBefore < PendingLimit;
+					});
+
+				if (RankedBefore >= PendingLimit)
+				{
+					Found.Reset();
 				}
 			}
 
-			return NullOpt;
+			return Found;
 		}
 
 		// Sort the results by their default order
@@ -458,6 +550,11 @@ namespace Heart::Query
 			{
 				AsType().CustomSort();
 			}
+			else if (EnumHasAnyFlags(Flags, Lazy))
+			{
+				ResolvePendingLimit();
+				PendingSort = [](const PassedKey A, const PassedKey B) { return A < B; };
+			}
 			else
 			{
 				InitResults();
@@ -473,6 +570,13 @@ namespace Heart::Query
 		>
 		QueryType& Sort(Predicate Pred)
 		{
+			if (EnumHasAnyFlags(Flags, Lazy))
+			{
+				ResolvePendingLimit();
+				PendingSort = [Pred](const PassedKey A, const PassedKey B) { return Pred(A, B); };
+				return AsType();
+			}
+
 			InitResults();
 			Algo::Sort(Results.GetValue(), Pred);
 			return AsType();
@@ -493,6 +597,14 @@ namespace Heart::Query
 		{
 			using RetType = std::invoke_result_t<ProjectionType, PassedKey>;
 
+			// The projection cache only lives as long as this call, so a cached sort can't be deferred.
+			if (EnumHasAnyFlags(Flags, Lazy) && !EnumHasAnyFlags(Flags, ProjectionCache))
+			{
+				ResolvePendingLimit();
+				PendingSort = [Proj, Pred](const PassedKey A, const PassedKey B) { return Pred(Proj(A), Proj(B)); };
+				return AsType();
+			}
+
 			InitResults();
 
 			if (EnumHasAnyFlags(Flags, ProjectionCache))
@@ -535,6 +647,35 @@ namespace Heart::Query
 			return bShouldSort ? SortBy(Forward<Args>(InArgs)...) : AsType();
 		}
 
+		/**
+		 * Keeps only the first Count results. In a lazy query following a sort, only the top Count results are ever
+		 * sorted, and without a sort, iteration stops once Count results have been found.
+		 */
+		QueryType& Limit(const int32 Count)
+		{
+			check(Count >= 0);
+
+			if (EnumHasAnyFlags(Flags, Lazy))
+			{
+				PendingLimit = PendingLimit == INDEX_NONE ? Count : FMath::Min(PendingLimit, Count);
+				return AsType();
+			}
+
+			InitResults();
+			if (Count < Results->Num())
+			{
+				Results->SetNum(Count);
+			}
+			return AsType();
+		}
+
+		// The number of results below which a Parallel query stays on the calling thread.
+		QueryType& SetParallelThreshold(const int32 Threshold)
+		{
+			ParallelThreshold = Threshold;
+			return AsType();
+		}
+
 		const FStorage& Get()
 		{
 			InitResults();
@@ -543,6 +684,22 @@ namespace Heart::Query
 
 		int32 Num() const
 		{
+			// Count without resolving what's pending, stopping early if there's a limit.
+			if (HasPending())
+			{
+				if (PendingLimit == 0)
+				{
+					return 0;
+				}
+
+				int32 Count = 0;
+				Scan([&](PassedKey, auto&)
+					{
+						return ++Count != PendingLimit;
+					});
+				return Count;
+			}
+
 			// If results has been initialized return that num
 			if (Results.IsSet())
 			{
@@ -554,23 +711,229 @@ namespace Heart::Query
 		}
 
 	private:
+		// Iterates over all results on the calling thread, in order.
+		template <typename Predicate>
+		QueryType& ForEachSerial(Predicate Pred)
+		{
+			// A pending sort needs to see every result before the first one can be given out.
+			if (PendingSort)
+			{
+				InitResults();
+			}
+
+			int32 Remaining = PendingLimit;
+			Scan([&](const PassedKey Key, auto& GetValue)
+				{
+					if (Remaining == 0)
+					{
+						return false;
+					}
+					--Remaining;
+
+					InvokePredicate(Pred, Key, GetValue);
+					return true;
+				});
+
+			return AsType();
+		}
+
+		template <EInvert Invert>
+		QueryType& FilterDelegate(FFilter&& Delegate)
+		{
+			if (EnumHasAnyFlags(Flags, Lazy))
+			{
+				ResolvePendingLimit();
+				HasPendingDelegateFilter = true;
+				ValueFilters.Emplace(
+					[Delegate = MoveTemp(Delegate)](PassedKey, const PassedValue Value)
+					{
+						return Eval<Invert>(Delegate.Execute(Value));
+					});
+				return AsType();
+			}
+
+			InitResults();
+
+			Results->RemoveAll(
+				[this, &Delegate](const PassedKey Key)
+				{
+					return !Eval<Invert>(Delegate.Execute(Lookup(Key)));
+				});
+
+			return AsType();
+		}
+
+		bool ShouldRunParallel(const int32 Count) const
+		{
+			return EnumHasAnyFlags(Flags, Parallel) && Count >= FMath::Max(ParallelThreshold, ParallelChunkSize);
+		}
+
+		/**
+		 * Removes results failing a predicate across worker threads. Each chunk is compacted in place, then the
+		 * surviving runs are moved down in chunk order, so results keep their order.
+		 */
+		template <typename KeepFunc>
+		void CompactParallel(const KeepFunc& Keep)
+		{
+			FStorage& Keys = Results.GetValue();
+			const int32 NumKeys = Keys.Num();
+			const int32 NumChunks = FMath::DivideAndRoundUp(NumKeys, ParallelChunkSize);
+
+			TArray<int32, TInlineAllocator<64>> ChunkKept;
+			ChunkKept.SetNumUninitialized(NumChunks);
+
+			ParallelFor(NumChunks,
+				[&](const int32 Chunk)
+				{
+					const int32 Begin = Chunk * ParallelChunkSize;
+					const int32 End = FMath::Min(Begin + ParallelChunkSize, NumKeys);
+
+					int32 Write = Begin;
+					for (int32 Read = Begin; Read < End; ++Read)
+					{
+						if (Keep(Keys[Read]))
+						{
+							if (Write != Read)
+							{
+								Keys[Write] = MoveTemp(Keys[Read]);
+							}
+							++Write;
+						}
+					}
+
+					ChunkKept[Chunk] = Write - Begin;
+				});
+
+			int32 Write = ChunkKept[0];
+			for (int32 Chunk = 1; Chunk < NumChunks; ++Chunk)
+			{
+				const int32 Begin = Chunk * ParallelChunkSize;
+				for (int32 Index = 0; Index < ChunkKept[Chunk]; ++Index)
+				{
+					Keys[Write++] = MoveTemp(Keys[Begin + Index]);
+				}
+			}
+
+			Keys.SetNum(Write, EAllowShrinking::No);
+		}
+
+		// Copies the keys of the reference data into Results.
+		void CopySourceKeys()
+		{
+			Results = FStorage();
+			Results->Reserve(RefNum());
+			for (auto&& Element : FQueryRange(this))
+			{
+				Results->Emplace(Element.Key);
+			}
+			checkSlow(Results->Num() == RefNum())
+		}
+
 		// This function makes a copy of the reference data, and stores it in Results, where it can be pruned down by
-		// filters, or re-ordered by sorting.
+		// filters, or re-ordered by sorting. Anything pending in a lazy query is resolved here, in a single pass.
 		void InitResults()
 		{
-			if (!Results.IsSet())
+			if (!HasPending())
 			{
-				Results = FStorage();
-				Results->Reserve(RefNum());
-				for (auto&& Element : FQueryRange(this))
+				if (!Results.IsSet())
+				{
+					CopySourceKeys();
+				}
+				return;
+			}
+
+			// Pending filters over enough results are run in parallel first, leaving just the sort and limit. Delegate
+			// filters keep the whole pass on the calling thread.
+			if ((!KeyFilters.IsEmpty() || !ValueFilters.IsEmpty()) && !HasPendingDelegateFilter &&
+				ShouldRunParallel(Results.IsSet() ? Results->Num() : RefNum()))
+			{
+				if (!Results.IsSet())
+				{
+					CopySourceKeys();
+				}
+
+				CompactParallel(
+					[this](const PassedKey Key)
+					{
+						auto GetValue = [this, &Key]() -> decltype(auto) { return Lookup(Key); };
+						return PassesFilters(Key, GetValue);
+					});
+
+				KeyFilters.Reset();
+				ValueFilters.Reset();
+
+				if (!HasPending())
 				{
-					Results->Emplace(Element.Key);
+					return;
 				}
-				checkSlow(Results->Num() = RefNum())
 			}
+
+			FStorage NewResults;
+
+			if (PendingSort && PendingLimit != INDEX_NONE)
+			{
+				// Partial sort: keep a heap of the best results so far, with the worst of them on top, so each key
+				// is compared against the top instead of sorting everything.
+				auto WorstFirst = [this](const KeyType& A, const KeyType& B) { return PendingSort(B, A); };
+
+				NewResults.Reserve(PendingLimit);
+				Scan([&](const PassedKey Key, auto&)
+					{
+						if (NewResults.Num() < PendingLimit)
+						{
+							NewResults.HeapPush(Key, WorstFirst);
+						}
+						else if (PendingLimit > 0 && PendingSort(Key, NewResults.HeapTop()))
+						{
+							NewResults.HeapPopDiscard(WorstFirst, EAllowShrinking::No);
+							NewResults.HeapPush(Key, WorstFirst);
+						}
+						return true;
+					});
+
+				Algo::Sort(NewResults, [this](const KeyType& A, const KeyType& B) { return PendingSort(A, B); });
+			}
+			else
+			{
+				NewResults.Reserve(Results.IsSet() ? Results->Num() : RefNum());
+				Scan([&](const PassedKey Key, auto&)
+					{
+						// Without a sort, the scan can stop as soon as the limit is reached.
+						if (NewResults.Num() == PendingLimit && !PendingSort)
+						{
+							return false;
+						}
+						NewResults.Add(Key);
+						return true;
+					});
+
+				if (PendingSort)
+				{
+					Algo::Sort(NewResults, [this](const KeyType& A, const KeyType& B) { return PendingSort(A, B); });
+				}
+			}
+
+			Results = MoveTemp(NewResults);
+			KeyFilters.Reset();
+			ValueFilters.Reset();
+			HasPendingDelegateFilter = false;
+			PendingSort = nullptr;
+			PendingLimit = INDEX_NONE;
 		}
 
 		TOptional<FStorage> Results;
-		EFlags Flags;
+		EFlags Flags = NoFlags;
+
+		// Operations recorded by a lazy query, waiting to be applied in a single pass.
+		TArray<TFunction<bool(PassedKey)>> KeyFilters;
+		TArray<TFunction<bool(PassedKey, PassedValue)>> ValueFilters;
+		TFunction<bool(PassedKey, PassedKey)> PendingSort;
+		int32 PendingLimit = INDEX_NONE;
+
+		// Set while a delegate is among the pending filters, which may not run off the calling thread.
+		bool HasPendingDelegateFilter = false;
+
+		static constexpr int32 ParallelChunkSize = 512;
+		int32 ParallelThreshold = 4096;
 	};
 }
\ No newline at end of file
@@ -14,7 +14,8 @@ struct FHeartDeleteNodeUndoData
 	UPROPERTY()
 	TObjectPtr<UHeartGraphNode> DeletedNode;
 
-	TMap<FHeartNodeGuid, Heart::API::FPinEdit::FMemento> Mementos;
+	// The links broken between the node and the rest of the graph.
+	Heart::API::FPinEdit::FDelta Delta;
 
 	bool Serialize(FArchive& Ar);
 };
@@ -14,7 +14,7 @@ struct FHeartDisconnectPinsUndoData
 	GENERATED_BODY()
 
 	TSoftObjectPtr<UHeartGraphNode> TargetNode;
-	TMap<FHeartNodeGuid, Heart::API::FPinEdit::FMemento> Mementos;
+	Heart::API::FPinEdit::FDelta Delta;
 
 	bool Serialize(FArchive& Ar);
 };
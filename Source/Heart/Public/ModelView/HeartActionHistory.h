@@ -101,6 +101,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHeartActionHistoryPointerChanged_BP
 
 /**
  * A record of recent actions performed on a graph.
+ * Records are kept in a ring buffer, so once the history is full, each new record replaces the oldest in place.
  */
 UCLASS()
 class HEART_API UHeartActionHistory : public UHeartGraphExtension
@@ -108,6 +109,10 @@ class HEART_API UHeartActionHistory : public UHeartGraphExtension
 	GENERATED_BODY()
 
 public:
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+
 	void AddRecord(const FHeartActionRecord& Record);
 
 	TConstStructView<FHeartActionRecord> RetrieveRecordPtr();
@@ -117,7 +122,7 @@ public:
 	TConstArrayView<FHeartActionRecord> RetrieveRecords(int32 Count);
 
 	// Grab the most recent N records without changing the ActionPointer.
-	TConstArrayView<FHeartActionRecord> ViewRecords(int32 Count) const;
+	TConstArrayView<FHeartActionRecord> ViewRecords(int32 Count);
 
 	FHeartActionHistoryRecordUpdate::RegistrationType& GetOnRecordsUpdated() { return OnRecordsUpdatedNative; }
 	FHeartActionHistoryPointerChanged::RegistrationType& GetOnPointerChanged() { return OnPointerChangedNative; }
@@ -131,6 +136,14 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintSetter, Category = "Heart|ActionHistory")
 	void SetMaxRecordedActions(int32 Count);
 
+	UFUNCTION(BlueprintCallable, BlueprintSetter, Category = "Heart|ActionHistory")
+	void SetMemoryBudget(int64 Bytes);
+
+	// Get the memory held by the undo data of all records. Packed records count their compressed size, or nothing once
+	// they have been spilled to disk.
+	UFUNCTION(BlueprintCallable, Category = "Heart|ActionHistory")
+	int64 GetMemoryUsage() const { return MemoryUsage; }
+
 	UFUNCTION(BlueprintCallable, Category = "Heart|ActionHistory")
 	bool Undo();
 
@@ -146,6 +159,30 @@ public:
 	bool GetRecordAllConnections() const { return RecordAllConnections; }
 
 private:
+	int32 GetSlot(const int32 Index) const { return (FirstAction + Index) % Actions.Num(); }
+
+	// Rotate the ring so that records are stored in order, starting at index 0.
+	void Linearize();
+
+	void ReleaseRecord(int32 Index);
+	void EvictOldest();
+	// Evict the oldest records until there is room for new ones.
+	void TrimToFit(int32 IncomingRecords, int64 IncomingSize);
+
+	// Serialize and compress a record, releasing its undo data from memory until it's needed again.
+	bool PackRecord(int32 Slot);
+
+	// Restore a packed record. Called whenever a record is retrieved, so packing is invisible outside the history.
+	void UnpackRecord(int32 Slot);
+
+	// Pack each record that's further back than UncompressedRecords.
+	void PackOldRecords();
+
+	void ReleasePackedRecord(int32 Slot);
+
+	struct FPackedRecord;
+	static bool ReadPackedRecord(const FPackedRecord& Packed, FHeartActionRecord& OutRecord);
+
 	void BroadcastPointer();
 	void BroadcastUpdate(int32 Index, int32 Count);
 
@@ -173,6 +210,26 @@ protected:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Heart|ActionHistory")
 	int32 MaxRecordedActions = 50;
 
+	// The oldest records are evicted once the serialized size of all undo data would go above this. 0 for no limit.
+	// The most recent record is always kept, even if it alone is larger than the budget.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Heart|ActionHistory", meta = (Units = "Bytes", ClampMin = 0))
+	int64 MemoryBudget = 0;
+
+	// Should records be serialized and compressed once they are older than UncompressedRecords?
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Heart|ActionHistory")
+	bool CompressOldRecords = false;
+
+	// The number of most recent records kept as they are, so undoing a few steps doesn't need to decompress anything.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Heart|ActionHistory", meta = (EditCondition = "CompressOldRecords", ClampMin = 0))
+	int32 UncompressedRecords = 10;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Heart|ActionHistory", meta = (EditCondition = "CompressOldRecords"))
+	FName CompressionFormat = NAME_Oodle;
+
+	// Should compressed records be written out to temp files, instead of being kept in memory?
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Heart|ActionHistory", meta = (EditCondition = "CompressOldRecords"))
+	bool SpillToDisk = false;
+
 	// Should we automatically create records for any node movement?
 	// This should be disabled if node positions change frequently, or do not matter for stateful-ness.
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Heart|ActionHistory")
@@ -189,6 +246,38 @@ private:
 	UPROPERTY()
 	int32 ActionPointer = INDEX_NONE;
 
+	// Ring buffer of records. Slots past NumRecords are released records, waiting to be reused.
 	UPROPERTY()
 	TArray<FHeartActionRecord> Actions;
+
+	// Memory held by each slot of Actions: the serialized size of unpacked records, and the compressed size of packed ones.
+	TArray<int64> RecordSizes;
+
+	// A record that has been serialized and compressed. Objects are referenced by path while packed, so they are not
+	// kept alive by the history.
+	struct FPackedRecord
+	{
+		TArray<uint8> Data;
+
+		// If set, Data has been written to this file instead.
+		FString SpillFile;
+
+		FName Format;
+		int32 UncompressedSize = 0;
+
+		// Size of the record before it was packed, restored when it's unpacked.
+		int64 RecordSize = 0;
+
+		bool IsSet() const { return UncompressedSize > 0; }
+	};
+
+	// Packed form of each slot of Actions. A slot is either packed or holds its record, never both.
+	TArray<FPackedRecord> PackedRecords;
+
+	// Slot of the oldest record.
+	int32 FirstAction = 0;
+
+	int32 NumRecords = 0;
+
+	int64 MemoryUsage = 0;
 };
\ No newline at end of file
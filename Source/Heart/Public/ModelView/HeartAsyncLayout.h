@@ -0,0 +1,83 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "HeartLayoutHelper.h"
+#include "Model/HeartGuids.h"
+#include <atomic>
+
+class UHeartGraph;
+struct FHeartNodeMoveEvent;
+
+namespace Heart::Layout
+{
+	/**
+	 * A layout running on a worker thread. Everything the layout reads from the graph is copied when the job is created,
+	 * so the work never touches UObjects. Positions published by the work are applied on the game thread, at most
+	 * PublishRate times per second. The job cancels itself if nodes or connections in the graph change, or a move of its
+	 * nodes is finished by anything else. Only one job runs per graph; starting another cancels the previous one.
+	 */
+	class HEART_API FAsyncLayoutJob : public TSharedFromThis<FAsyncLayoutJob>
+	{
+	public:
+		FAsyncLayoutJob(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& InNodes,
+						FHeartGraphAdjacencyList&& InAdjacencyList, float PublishRate);
+
+		/*		GAME THREAD		*/
+
+		void Start(FAsyncLayoutWork&& Work);
+
+		void Cancel();
+
+		bool IsRunning() const { return !Cancelled && !Finished; }
+
+		// Cancels the job running on a graph, if there is one. Used before restoring node locations, such as on undo.
+		static void CancelForGraph(const UHeartGraph* Graph);
+
+
+		/*		WORKER THREAD	*/
+
+		const TArray<FVector2D>& GetStartPositions() const { return StartPositions; }
+		const FHeartGraphAdjacencyList& GetAdjacencyList() const { return AdjacencyList; }
+
+		// Work should poll this regularly, and return early when set.
+		bool IsCancelled() const { return Cancelled; }
+
+		// Returns true once per publish interval. Check this before copying positions to publish.
+		bool ShouldPublish();
+
+		// Send intermediate positions to the game thread. Only the latest positions are applied if several are
+		// published before the game thread catches up.
+		void Publish(const TArray<FVector2D>& Positions);
+
+	private:
+		void PublishInternal(TArray<FVector2D>&& Positions, bool Final);
+
+		void ApplyPendingPositions();
+
+		void UnbindFromGraph();
+
+		void OnNodesMoved(const FHeartNodeMoveEvent& Event);
+
+		TWeakObjectPtr<UObject> InterfaceObject;
+		TWeakObjectPtr<UHeartGraph> Graph;
+
+		TArray<FHeartNodeGuid> Nodes;
+		TArray<FVector2D> StartPositions;
+		FHeartGraphAdjacencyList AdjacencyList;
+
+		const double PublishInterval;
+		double NextPublishTime = 0.0;
+
+		std::atomic<bool> Cancelled = false;
+		std::atomic<bool> Finished = false;
+
+		FCriticalSection PendingLock;
+		TArray<FVector2D> PendingPositions;
+		bool PendingFinal = false;
+		bool PublishQueued = false;
+
+		// Set while this job applies positions, so the move events it causes don't cancel it.
+		bool ApplyingPositions = false;
+	};
+}
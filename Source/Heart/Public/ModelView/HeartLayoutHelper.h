@@ -3,18 +3,28 @@
 #pragma once
 
 #include "UObject/Object.h"
+#include "Algorithms/Nodesoup.h"
 #include "HeartLayoutHelper.generated.h"
 
 struct FHeartNodeGuid;
 class IHeartGraphInterface;
 class UHeartGraphNode;
 
+namespace Heart::Layout
+{
+	class FAsyncLayoutJob;
+
+	// Work run on a worker thread by an async layout. Returns the final node positions.
+	using FAsyncLayoutWork = TUniqueFunction<TArray<FVector2D>(FAsyncLayoutJob&)>;
+}
+
 USTRUCT()
 struct FHeartGraphAdjacencyList
 {
 	GENERATED_BODY()
 
-	TArray<TArray<int32>> AdjacencyList;
+	// Output links of each node, by index into the node array the list was built from.
+	Nodesoup::FCompressedGraph AdjacencyList;
 };
 
 /**
@@ -40,11 +50,41 @@ public:
 	bool Layout(IHeartGraphInterface* Interface);
 	bool Layout(IHeartGraphInterface* Interface, float DeltaTime);
 
+	// Run the layout on a worker thread. Node positions and connections are copied now, and new positions are applied as
+	// the layout progresses. Any async layout previously started by this helper is cancelled. Helpers that don't
+	// implement CreateAsyncLayout run synchronously instead.
+	bool LayoutAsync(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes);
+
+	// Overload that calls LayoutAsync on all Nodes in the Graph.
+	bool LayoutAsync(IHeartGraphInterface* Interface);
+
+	UFUNCTION(BlueprintCallable, Category = "Heart|LayoutHelper")
+	void CancelAsyncLayout();
+
+	UFUNCTION(BlueprintPure, Category = "Heart|LayoutHelper")
+	bool IsAsyncLayoutRunning() const;
+
+	bool GetPreferAsync() const { return PreferAsync; }
+
 protected:
+	// Override to support LayoutAsync. Capture any config by value; the returned work must not touch UObjects.
+	virtual Heart::Layout::FAsyncLayoutWork CreateAsyncLayout() const { return nullptr; }
+
 	static FHeartGraphAdjacencyList GetGraphAdjacencyList(const IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes);
 
 	UFUNCTION(BlueprintCallable, Category = "Heart|LayoutHelper")
 	void ApplyNewPositions(const TScriptInterface<IHeartGraphInterface>& Interface, const TArray<FHeartNodeGuid>& Nodes, const TArray<FVector2D>& NewPositions) const;
+
+	// When run as a one-shot layout, such as by UHeartAction_AutoLayout, run on a worker thread if supported.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Async")
+	bool PreferAsync = false;
+
+	// How many times per second an async layout applies its intermediate positions to the graph.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Async", meta = (ClampMin = 1, UIMax = 120))
+	float AsyncPublishRate = 30.f;
+
+private:
+	TWeakPtr<Heart::Layout::FAsyncLayoutJob> ActiveAsyncJob;
 };
 
 UCLASS(Abstract, Blueprintable, MinimalAPI)
@@ -6,8 +6,22 @@
 #include "ModelView/HeartLayoutHelper.h"
 #include "HeartLayout_FruchtermanReingold.generated.h"
 
+class UHeartGraph;
+
+UENUM()
+enum class EHeartLayoutRepulsionMode : uint8
+{
+	// Test every pair of nodes. Cost grows quadratically with the number of nodes.
+	Exact,
+
+	// Bucket nodes into a grid, and only test nearby nodes. Much faster for large graphs, but approximate: nodes
+	// further apart than the repulsion cutoff never repel, and forces are summed in a different order, so layouts may
+	// differ slightly from Exact.
+	SpatialGrid
+};
+
 /**
- * An iterative layout implementation of Fruchterman-Reingold that runs on tick.
+ * An iterative layout implementation of Fruchterman-Reingold that runs on tick, or on a worker thread with LayoutAsync.
  */
 UCLASS(DisplayName = "Heart Layout Fruchterman-Reingold")
 class HEART_API UHeartLayout_FruchtermanReingold : public UHeartLayoutHelper
@@ -18,15 +32,54 @@ public:
 	virtual bool Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes, float DeltaTime) override;
 
 protected:
+	virtual Heart::Layout::FAsyncLayoutWork CreateAsyncLayout() const override;
+
+	Nodesoup::ERepulsionMode GetRepulsionMode() const;
+	Nodesoup::FExecutionSettings GetExecutionSettings() const;
+
+	// Hash of the config that Algorithm is created with, so changes made at runtime recreate it.
+	uint32 GetConfigHash() const;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
 	double Strength = 300.0;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (UIMin = 1, UIMax = 300))
 	int32 IterationsPerSecond = 60;
 
+	// Number of iterations run by LayoutAsync.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (ClampMin = 1, UIMax = 1000))
+	int32 AsyncIterations = 300;
+
+	// How to find pairs of nodes that repulse each other. SpatialGrid should be used for graphs with thousands of nodes.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	EHeartLayoutRepulsionMode RepulsionMode = EHeartLayoutRepulsionMode::Exact;
+
+	// Number of tasks to split force accumulation across. Results are deterministic for any given value.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config|Performance", meta = (ClampMin = 1, UIMax = 64))
+	int32 NumTasks = 1;
+
+	// Accumulate repulsion in single precision. Faster, but less accurate on very spread out graphs.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config|Performance")
+	bool SinglePrecision = false;
+
+	// Only used when laying out a subset of the graph's nodes.
 	FHeartGraphAdjacencyList AdjacencyList;
 
+	// Whether the graph's topology holds exactly the nodes being laid out, and the nodes and topology version that was
+	// decided from.
+	TWeakObjectPtr<UHeartGraph> CheckedGraph;
+	TArray<FHeartNodeGuid> CheckedNodes;
+	uint32 CheckedTopologyVersion = 0;
+	bool UsesTopology = false;
+
 	TOptional<Nodesoup::FruchtermanReingold> Algorithm;
 
+	// The graph, nodes, version of its topology, and config that Algorithm was last given. Vertex state in Algorithm
+	// is indexed by node order, so it is only kept while earlier nodes stay in place.
+	TWeakObjectPtr<UHeartGraph> LayoutGraph;
+	TArray<FHeartNodeGuid> AlgorithmNodes;
+	uint32 TopologyVersion = 0;
+	uint32 ConfigHash = 0;
+
 	float Accum = 0;
 };
\ No newline at end of file
@@ -6,7 +6,7 @@
 #include "HeartLayout_KamadaKawai.generated.h"
 
 /**
- * A simple layout implementation for a one-shot Kamada-Kawai run.
+ * A simple layout implementation for a one-shot Kamada-Kawai run. Supports LayoutAsync.
  */
 UCLASS(DisplayName = "Heart Layout Kamada-Kawai")
 class HEART_API UHeartLayout_KamadaKawai : public UHeartLayoutHelper
@@ -17,6 +17,8 @@ public:
 	virtual bool Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes) override;
 
 protected:
+	virtual Heart::Layout::FAsyncLayoutWork CreateAsyncLayout() const override;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
 	int32 Width = 200;
 
@@ -28,4 +30,8 @@ protected:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
 	double EnergyThreshold = 0.01;
+
+	// Number of tasks to split energy evaluation across. Results are identical for any value.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config|Performance", meta = (ClampMin = 1, UIMax = 64))
+	int32 NumTasks = 1;
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "ModelView/HeartLayoutHelper.h"
+#include "HeartLayout_Layered.generated.h"
+
+/**
+ * A one-shot layered (Sugiyama) layout for directed graphs, such as dialogue trees. Nodes are placed in columns flowing
+ * from output pins to input pins, ordered to minimize crossing connections. Deterministic, and far cheaper than the
+ * force-directed layouts.
+ */
+UCLASS(DisplayName = "Heart Layout Layered")
+class HEART_API UHeartLayout_Layered : public UHeartLayoutHelper
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes) override;
+
+protected:
+	// Distance between columns of nodes.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	double LayerSpacing = 400.0;
+
+	// Distance between nodes in the same column.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	double NodeSpacing = 200.0;
+
+	// Number of passes made reordering nodes to reduce crossing connections.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (ClampMin = 0, UIMax = 100))
+	int32 CrossingSweeps = 24;
+};
\ No newline at end of file
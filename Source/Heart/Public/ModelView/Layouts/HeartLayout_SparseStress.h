@@ -0,0 +1,39 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "ModelView/HeartLayoutHelper.h"
+#include "HeartLayout_SparseStress.generated.h"
+
+/**
+ * A one-shot layout using pivot-based sparse stress majorization. Produces layouts similar to Kamada-Kawai, but only
+ * stores distances to a few pivot nodes, so it scales to graphs with tens of thousands of nodes. Supports LayoutAsync.
+ */
+UCLASS(DisplayName = "Heart Layout Sparse Stress")
+class HEART_API UHeartLayout_SparseStress : public UHeartLayoutHelper
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool Layout(IHeartGraphInterface* Interface, const TArray<FHeartNodeGuid>& Nodes) override;
+
+protected:
+	virtual Heart::Layout::FAsyncLayoutWork CreateAsyncLayout() const override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	int32 Width = 200;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+	int32 Height = 200;
+
+	// Number of nodes used to approximate distances to the rest of the graph. More pivots are slower, but more accurate.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (ClampMin = 2, UIMax = 200))
+	int32 NumPivots = 50;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (ClampMin = 0, UIMax = 500))
+	int32 Iterations = 100;
+
+	// Number of tasks to split each iteration across. Results are identical for any value.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config|Performance", meta = (ClampMin = 1, UIMax = 64))
+	int32 NumTasks = 1;
+};
@@ -120,12 +120,42 @@ void UHeartPinConnectionDragDropOperation::DragCancelled_Implementation(const FP
 void UHeartPinConnectionDragDropOperation::Dragged_Implementation(const FPointerEvent& PointerEvent)
 {
 	Super::Dragged_Implementation(PointerEvent);
+
+	if (PinSnapDistance <= 0.f || !Canvas.IsValid() || !DraggedPin.IsValid())
+	{
+		return;
+	}
+
+	const FVector2D CursorLocation(Canvas->GetTickSpaceGeometry().AbsoluteToLocal(PointerEvent.GetScreenSpacePosition()));
+	const FHeartGraphPinReference NearestPin = Canvas->FindNearestPin(CursorLocation, PinSnapDistance);
+
+	UHeartGraphCanvasPin* PinWidget = nullptr;
+	if (NearestPin.IsValid() && NearestPin.NodeGuid != DraggedPin->GetPinReference().NodeGuid)
+	{
+		PinWidget = Canvas->ResolvePinReference(NearestPin);
+	}
+
+	if (PinWidget)
+	{
+		if (PinWidget != HoveredPin)
+		{
+			OnHoverPin(PinWidget);
+			HoverIsSnapped = true;
+		}
+	}
+	// Only clear hovers made by snapping; a pin hovered by the cursor is cleared when the cursor leaves it.
+	else if (HoverIsSnapped)
+	{
+		OnHoverCleared();
+	}
 }
 
 bool UHeartPinConnectionDragDropOperation::OnHoverPin(UHeartGraphCanvasPin* CanvasPin)
 {
 	if (ensure(IsValid(CanvasPin)))
 	{
+		HoverIsSnapped = false;
+
 		if (CanvasPin != HoveredPin)
 		{
 			if (HoveredPin.IsValid())
@@ -158,6 +188,7 @@ void UHeartPinConnectionDragDropOperation::OnHoverCleared()
 	}
 
 	HoveredPin = nullptr;
+	HoverIsSnapped = false;
 	Response = FHeartConnectPinsResponse();
 
 	if (DefaultDragVisual && DefaultDragVisual->Implements<UPinConnectionStatusInterface>())
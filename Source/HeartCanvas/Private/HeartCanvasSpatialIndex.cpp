@@ -0,0 +1,146 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "HeartCanvasSpatialIndex.h"
+
+namespace Heart::Canvas
+{
+	FNodeSpatialIndex::FNodeSpatialIndex(const float InCellSize)
+	  : CellSize(FMath::Max(InCellSize, 1.f))
+	{
+	}
+
+	void FNodeSpatialIndex::Update(const FHeartNodeGuid& Node, const FBox2f& Bounds)
+	{
+		const FIntRect NewRange = GetCellRange(Bounds);
+
+		FEntry* Entry = Entries.Find(Node);
+		if (Entry && Entry->CellRange == NewRange)
+		{
+			Entry->Bounds = Bounds;
+			Entry->Stamp = NextStamp++;
+			return;
+		}
+
+		if (Entry)
+		{
+			Remove(Node);
+		}
+
+		Entries.Add(Node, { Bounds, NewRange, NextStamp++ });
+
+		for (int32 Y = NewRange.Min.Y; Y <= NewRange.Max.Y; ++Y)
+		{
+			for (int32 X = NewRange.Min.X; X <= NewRange.Max.X; ++X)
+			{
+				Cells.FindOrAdd(FIntPoint(X, Y)).Add(Node);
+			}
+		}
+	}
+
+	void FNodeSpatialIndex::Remove(const FHeartNodeGuid& Node)
+	{
+		FEntry Entry;
+		if (!Entries.RemoveAndCopyValue(Node, Entry))
+		{
+			return;
+		}
+
+		for (int32 Y = Entry.CellRange.Min.Y; Y <= Entry.CellRange.Max.Y; ++Y)
+		{
+			for (int32 X = Entry.CellRange.Min.X; X <= Entry.CellRange.Max.X; ++X)
+			{
+				const FIntPoint Cell(X, Y);
+				if (TArray<FHeartNodeGuid>* CellNodes = Cells.Find(Cell))
+				{
+					CellNodes->RemoveSingleSwap(Node, EAllowShrinking::No);
+					if (CellNodes->IsEmpty())
+					{
+						Cells.Remove(Cell);
+					}
+				}
+			}
+		}
+	}
+
+	void FNodeSpatialIndex::Reset()
+	{
+		Entries.Reset();
+		Cells.Reset();
+	}
+
+	const FBox2f* FNodeSpatialIndex::FindBounds(const FHeartNodeGuid& Node) const
+	{
+		if (const FEntry* Entry = Entries.Find(Node))
+		{
+			return &Entry->Bounds;
+		}
+		return nullptr;
+	}
+
+	void FNodeSpatialIndex::Query(const FBox2f& Area, TArray<FHeartNodeGuid>& OutNodes) const
+	{
+		const FIntRect Range = GetCellRange(Area);
+
+		// Nodes overlapping several cells are found once per cell. Only report them from the first cell that both the
+		// node and the area overlap, which avoids needing a set to dedupe.
+		for (int32 Y = Range.Min.Y; Y <= Range.Max.Y; ++Y)
+		{
+			for (int32 X = Range.Min.X; X <= Range.Max.X; ++X)
+			{
+				const TArray<FHeartNodeGuid>* CellNodes = Cells.Find(FIntPoint(X, Y));
+				if (!CellNodes)
+				{
+					continue;
+				}
+
+				for (auto&& Node : *CellNodes)
+				{
+					const FEntry& Entry = Entries.FindChecked(Node);
+
+					if (X != FMath::Max(Entry.CellRange.Min.X, Range.Min.X) ||
+						Y != FMath::Max(Entry.CellRange.Min.Y, Range.Min.Y))
+					{
+						continue;
+					}
+
+					if (Entry.Bounds.Intersect(Area))
+					{
+						OutNodes.Add(Node);
+					}
+				}
+			}
+		}
+	}
+
+	FHeartNodeGuid FNodeSpatialIndex::QueryPoint(const FVector2f& Point) const
+	{
+		const FIntPoint Cell(FMath::FloorToInt32(Point.X / CellSize), FMath::FloorToInt32(Point.Y / CellSize));
+
+		FHeartNodeGuid Found;
+		uint32 FoundStamp = 0;
+
+		if (const TArray<FHeartNodeGuid>* CellNodes = Cells.Find(Cell))
+		{
+			for (auto&& Node : *CellNodes)
+			{
+				const FEntry& Entry = Entries.FindChecked(Node);
+				if (Entry.Bounds.IsInsideOrOn(Point) && (!Found.IsValid() || Entry.Stamp > FoundStamp))
+				{
+					Found = Node;
+					FoundStamp = Entry.Stamp;
+				}
+			}
+		}
+
+		return Found;
+	}
+
+	FIntRect FNodeSpatialIndex::GetCellRange(const FBox2f& Bounds) const
+	{
+		return FIntRect(
+			FMath::FloorToInt32(Bounds.Min.X / CellSize),
+			FMath::FloorToInt32(Bounds.Min.Y / CellSize),
+			FMath::FloorToInt32(Bounds.Max.X / CellSize),
+			FMath::FloorToInt32(Bounds.Max.Y / CellSize));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,321 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Slate/SHeartCanvasConnectionLayer.h"
+#include "UMG/HeartGraphCanvas.h"
+
+#include "HeartCanvasPrivate.h"
+
+#include "Model/HeartGraph.h"
+#include "Model/HeartGraphNode.h"
+
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
+
+DECLARE_CYCLE_STAT(TEXT("ConnectionLayerTick"), STAT_ConnectionLayerTick, STATGROUP_HeartCanvas);
+DECLARE_CYCLE_STAT(TEXT("ConnectionLayerPaint"), STAT_ConnectionLayerPaint, STATGROUP_HeartCanvas);
+
+SHeartCanvasConnectionLayer::~SHeartCanvasConnectionLayer()
+{
+	BindGraph(nullptr);
+}
+
+void SHeartCanvasConnectionLayer::Construct(const FArguments& InArgs)
+{
+	SetStyle(InArgs._Color, InArgs._Thickness, InArgs._TangentLength, InArgs._Segments, InArgs._Brush);
+}
+
+void SHeartCanvasConnectionLayer::SetCanvas(UHeartGraphCanvas* InCanvas)
+{
+	if (Canvas != InCanvas)
+	{
+		Canvas = InCanvas;
+		InvalidateAll();
+	}
+}
+
+void SHeartCanvasConnectionLayer::SetStyle(const FLinearColor& InColor, const float InThickness, const float InTangentLength,
+										   const int32 InSegments, const FSlateBrush* InBrush)
+{
+	const int32 NewSegments = FMath::Clamp(InSegments, 1, 64);
+	const bool ShapeChanged = TangentLength != InTangentLength || Segments != NewSegments;
+
+	Color = InColor;
+	Thickness = InThickness;
+	TangentLength = InTangentLength;
+	Segments = NewSegments;
+
+	if (!InBrush || InBrush->GetDrawType() == ESlateBrushDrawType::NoDrawType)
+	{
+		InBrush = FCoreStyle::Get().GetBrush("WhiteBrush");
+	}
+
+	if (FSlateApplication::IsInitialized())
+	{
+		ResourceHandle = FSlateApplication::Get().GetRenderer()->GetResourceHandle(*InBrush);
+	}
+
+	if (ShapeChanged)
+	{
+		InvalidateAll();
+	}
+
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SHeartCanvasConnectionLayer::InvalidateAll()
+{
+	Edges.Empty();
+	NodeEdges.Empty();
+	VisibleEdges.Empty();
+	DirtyNodes.Empty();
+	EdgesDirty = true;
+}
+
+void SHeartCanvasConnectionLayer::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ConnectionLayerTick)
+
+	SLeafWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	const UHeartGraphCanvas* CanvasPtr = Canvas.Get();
+	BindGraph(IsValid(CanvasPtr) ? CanvasPtr->GetGraph() : nullptr);
+
+	if (!Graph.IsValid())
+	{
+		VisibleEdges.Reset();
+		return;
+	}
+
+	if (EdgesDirty)
+	{
+		GatherEdges();
+		EdgesDirty = false;
+	}
+	else
+	{
+		for (auto&& Node : DirtyNodes)
+		{
+			if (const TArray<int32>* EdgeIndices = NodeEdges.Find(Node))
+			{
+				for (const int32 EdgeIndex : *EdgeIndices)
+				{
+					UpdateEdge(Edges[EdgeIndex]);
+				}
+			}
+		}
+	}
+	DirtyNodes.Reset();
+
+	// This layer isn't required to be inside the canvas, only to cover it.
+	const FGeometry& CanvasGeometry = CanvasPtr->GetTickSpaceGeometry();
+	CanvasOffset = AllottedGeometry.AbsoluteToLocal(CanvasGeometry.LocalToAbsolute(FVector2f::ZeroVector));
+
+	const FVector2f ViewOffset(CanvasPtr->GetViewOffset());
+	const float Zoom = CanvasPtr->GetZoom();
+	const FBox2f ViewBox(
+		-ViewOffset - CanvasOffset / Zoom,
+		-ViewOffset + (AllottedGeometry.GetLocalSize() - CanvasOffset) / Zoom);
+
+	VisibleEdges.Reset();
+	for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); ++EdgeIndex)
+	{
+		FEdge& Edge = Edges[EdgeIndex];
+		if (!Edge.Bounds.Intersect(ViewBox))
+		{
+			continue;
+		}
+
+		// Pin widgets in view may have been laid out since the last tick, so check that their endpoints still match.
+		UpdateEdge(Edge);
+		VisibleEdges.Add(EdgeIndex);
+	}
+
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+int32 SHeartCanvasConnectionLayer::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry,
+										   const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
+										   const int32 LayerId, const FWidgetStyle& InWidgetStyle, const bool bParentEnabled) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ConnectionLayerPaint)
+
+	// While showing proxies, the canvas draws its own connections between them.
+	const UHeartGraphCanvas* CanvasPtr = Canvas.Get();
+	if (!IsValid(CanvasPtr) || CanvasPtr->IsShowingNodeProxies() || VisibleEdges.IsEmpty())
+	{
+		return LayerId;
+	}
+
+	const FVector2f ViewOffset(CanvasPtr->GetViewOffset());
+	const float Zoom = CanvasPtr->GetZoom();
+	const float HalfThickness = Thickness * 0.5f;
+	const FColor VertexColor = (Color * InWidgetStyle.GetColorAndOpacityTint()).ToFColor(true);
+	const FSlateRenderTransform& RenderTransform = AllottedGeometry.GetAccumulatedRenderTransform();
+
+	Vertices.Reset();
+	Indices.Reset();
+
+	for (const int32 EdgeIndex : VisibleEdges)
+	{
+		const FEdge& Edge = Edges[EdgeIndex];
+		const SlateIndex Base = static_cast<SlateIndex>(Vertices.Num());
+
+		for (int32 i = 0; i < Edge.Points.Num(); ++i)
+		{
+			const FVector2f Point = (ViewOffset + Edge.Points[i]) * Zoom + CanvasOffset;
+			const FVector2f Offset = Edge.Normals[i] * HalfThickness;
+			Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, Point + Offset, FVector2f(0.f, 0.f), VertexColor));
+			Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, Point - Offset, FVector2f(0.f, 1.f), VertexColor));
+		}
+
+		for (int32 i = 0; i + 1 < Edge.Points.Num(); ++i)
+		{
+			const SlateIndex A = Base + i * 2;
+			Indices.Append({ A, A + 1, A + 2, A + 2, A + 1, A + 3 });
+		}
+	}
+
+	FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, ResourceHandle, Vertices, Indices, nullptr, 0, 0);
+
+	return LayerId;
+}
+
+FVector2D SHeartCanvasConnectionLayer::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
+
+void SHeartCanvasConnectionLayer::BindGraph(UHeartGraph* NewGraph)
+{
+	if (Graph == NewGraph)
+	{
+		return;
+	}
+
+	if (Graph.IsValid())
+	{
+		Graph->GetOnBatchEvent().RemoveAll(this);
+	}
+
+	Graph = NewGraph;
+	InvalidateAll();
+
+	if (Graph.IsValid())
+	{
+		Graph->GetOnBatchEvent().AddSP(this, &SHeartCanvasConnectionLayer::OnGraphBatchEvent);
+	}
+}
+
+void SHeartCanvasConnectionLayer::OnGraphBatchEvent(const FHeartGraphBatchEvent& Event)
+{
+	// Changes to the set of connections are rare, and regathering keeps the tessellation of unchanged edges.
+	if (!Event.Added.NewNodes.IsEmpty() ||
+		!Event.Removed.AffectedNodes.IsEmpty() ||
+		!Event.Connections.AffectedNodes.IsEmpty())
+	{
+		EdgesDirty = true;
+	}
+
+	for (auto&& Node : Event.Moved.AffectedNodes)
+	{
+		if (IsValid(Node))
+		{
+			DirtyNodes.Add(Node->GetGuid());
+		}
+	}
+}
+
+void SHeartCanvasConnectionLayer::GatherEdges()
+{
+	// Keep the existing edges around, so connections that still exist don't need to be tessellated again.
+	TMap<TTuple<FHeartGraphPinReference, FHeartGraphPinReference>, FEdge> OldEdges;
+	OldEdges.Reserve(Edges.Num());
+	for (FEdge& Edge : Edges)
+	{
+		OldEdges.Add({ Edge.From, Edge.To }, MoveTemp(Edge));
+	}
+
+	Edges.Reset();
+	NodeEdges.Reset();
+
+	Graph->ForEachNode(
+		[&](const UHeartGraphNode* Node)
+		{
+			Node->FindPinsByDirection(EHeartPinDirection::Output)
+				.ForEach(
+				[&](const FHeartPinGuid PinGuid)
+				{
+					auto&& LinksView = Node->ViewConnections(PinGuid);
+					if (!LinksView.IsValid())
+					{
+						return;
+					}
+
+					const FHeartGraphPinReference From = Node->GetPinReference(PinGuid);
+
+					for (auto&& Link : LinksView.Get().GetLinks())
+					{
+						FEdge Edge;
+						if (!OldEdges.RemoveAndCopyValue({ From, Link }, Edge))
+						{
+							Edge.From = From;
+							Edge.To = Link;
+						}
+
+						const int32 EdgeIndex = Edges.Add(MoveTemp(Edge));
+						NodeEdges.FindOrAdd(From.NodeGuid).Add(EdgeIndex);
+						if (Link.NodeGuid != From.NodeGuid)
+						{
+							NodeEdges.FindOrAdd(Link.NodeGuid).Add(EdgeIndex);
+						}
+					}
+				});
+			return true;
+		});
+
+	for (FEdge& Edge : Edges)
+	{
+		UpdateEdge(Edge);
+	}
+}
+
+void SHeartCanvasConnectionLayer::UpdateEdge(FEdge& Edge) const
+{
+	const UHeartGraphCanvas* CanvasPtr = Canvas.Get();
+
+	const FVector2f Start = CanvasPtr->UnscalePositionToCanvasZoom_2f(FVector2f(CanvasPtr->ResolvePinLocation(Edge.From)));
+	const FVector2f End = CanvasPtr->UnscalePositionToCanvasZoom_2f(FVector2f(CanvasPtr->ResolvePinLocation(Edge.To)));
+
+	if (!Edge.Points.IsEmpty() && Start.Equals(Edge.Start, 0.01f) && End.Equals(Edge.End, 0.01f))
+	{
+		return;
+	}
+
+	Edge.Start = Start;
+	Edge.End = End;
+	Tessellate(Edge);
+}
+
+void SHeartCanvasConnectionLayer::Tessellate(FEdge& Edge) const
+{
+	const FVector2f Tangent(TangentLength, 0.f);
+
+	Edge.Points.SetNumUninitialized(Segments + 1, EAllowShrinking::No);
+	Edge.Normals.SetNumUninitialized(Segments + 1, EAllowShrinking::No);
+
+	Edge.Bounds = FBox2f(ForceInit);
+	for (int32 i = 0; i <= Segments; ++i)
+	{
+		const float Alpha = static_cast<float>(i) / Segments;
+		Edge.Points[i] = FMath::CubicInterp(Edge.Start, Tangent, Edge.End, Tangent, Alpha);
+		Edge.Bounds += Edge.Points[i];
+	}
+
+	for (int32 i = 0; i <= Segments; ++i)
+	{
+		// Normals at inner points bisect the two neighboring segments, which keeps the strip from pinching at joints.
+		const FVector2f Direction = (Edge.Points[FMath::Min(i + 1, Segments)] - Edge.Points[FMath::Max(i - 1, 0)]).GetSafeNormal();
+		Edge.Normals[i] = FVector2f(-Direction.Y, Direction.X);
+	}
+}
\ No newline at end of file
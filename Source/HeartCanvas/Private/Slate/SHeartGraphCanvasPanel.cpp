@@ -0,0 +1,23 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Slate/SHeartGraphCanvasPanel.h"
+#include "UMG/HeartGraphCanvas.h"
+
+void SHeartGraphCanvasPanel::SetCanvas(UHeartGraphCanvas* InCanvas)
+{
+	Canvas = InCanvas;
+}
+
+int32 SHeartGraphCanvasPanel::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry,
+									  const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
+									  int32 LayerId, const FWidgetStyle& InWidgetStyle, const bool bParentEnabled) const
+{
+	if (const UHeartGraphCanvas* CanvasPtr = Canvas.Get();
+		IsValid(CanvasPtr) && CanvasPtr->IsShowingNodeProxies())
+	{
+		CanvasPtr->PaintNodeProxies(AllottedGeometry, OutDrawElements, LayerId);
+		++LayerId;
+	}
+
+	return SConstraintCanvas::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "UMG/HeartGraphCanvasNode.h"
 #include "UMG/HeartGraphCanvasPin.h"
 #include "UMG/HeartGraphCanvasConnection.h"
+#include "UMG/HeartGraphCanvasConnectionLayer.h"
 
 #include "HeartCanvasPrivate.h"
 
@@ -17,7 +18,12 @@
 #include "General/HeartMath.h"
 
 #include "Components/CanvasPanel.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
 #include "Components/CanvasPanelSlot.h"
+#include "Components/OverlaySlot.h"
+#include "Blueprint/WidgetTree.h"
 #include "ModelView/HeartGraphSchema.h"
 #include "ModelView/HeartLayoutHelper.h"
 
@@ -39,6 +45,7 @@ UHeartGraphCanvas::UHeartGraphCanvas()
 {
 	View = {0.f, 0.f, 1.f};
 	TargetView = {0.f, 0.f, 1.f};
+	LayoutView = {0.f, 0.f, 1.f};
 	ViewMovementScalar = {1.f, 1.f, 0.1f};
 	ViewBounds.Min = { -10000.f, -10000.f, 0.1f };
 	ViewBounds.Max = { 10000.f, 10000.f, 10.f };
@@ -52,6 +59,23 @@ bool UHeartGraphCanvas::Initialize()
 
 	BindingContainer.SetupLinker(this);
 
+	// The node layer's render transform is relative to its corner, like node positions.
+	if (IsValid(NodeCanvas))
+	{
+		NodeCanvas->SetRenderTransformPivot(FVector2D::ZeroVector);
+		NodeCanvas->SetGraphCanvas(this);
+	}
+
+	if (!PopupCanvas && !IsDesignTime())
+	{
+		CreatePopupCanvas();
+	}
+
+	if (ConnectionLayer)
+	{
+		ConnectionLayer->SetCanvas(this);
+	}
+
 	return Super;
 }
 
@@ -78,7 +102,6 @@ void UHeartGraphCanvas::NativeTick(const FGeometry& MyGeometry, const float InDe
 	if (TargetView.Z != View.Z)
 	{
 		SetZoom(FMath::FInterpTo(View.Z, TargetView.Z, InDeltaTime, ZoomInterpSpeed));
-		UpdateAllCanvasNodesZoom();
 	}
 
 	if (TargetView != View)
@@ -86,15 +109,39 @@ void UHeartGraphCanvas::NativeTick(const FGeometry& MyGeometry, const float InDe
 		SetViewOffset(Vector2fInterpTo(FVector2f(View), FVector2f(TargetView), InDeltaTime, DraggingInterpSpeed));
 	}
 
+	if (const bool WantsProxies = ProxyZoomThreshold > 0.f && View.Z < ProxyZoomThreshold;
+		WantsProxies != ShowingNodeProxies)
+	{
+		SetShowingNodeProxies(WantsProxies);
+	}
+
 	if (RunLayoutOnTick && IsValid(Layout))
 	{
 		Layout->Layout(this, InDeltaTime);
 	}
 
-	if (NeedsToUpdatePositions)
+	if (UseVirtualization && (NeedsToUpdateView || NeedsToUpdateVirtualization))
+	{
+		UpdateVirtualizedNodes(MyGeometry);
+		NeedsToUpdateVirtualization = false;
+	}
+
+	if (ShowingNodeProxies && (NeedsToUpdateView || NeedsToUpdateProxies))
 	{
-		UpdateAllPositionsOnCanvas();
-		NeedsToUpdatePositions = false;
+		UpdateNodeProxies(MyGeometry);
+		NeedsToUpdateProxies = false;
+	}
+
+	if (NeedsToUpdateView)
+	{
+		UpdateNodeLayerTransform(MyGeometry);
+		NeedsToUpdateView = false;
+	}
+
+	// Hidden widgets are repositioned when proxies are turned off.
+	if (!ShowingNodeProxies && !DirtyNodePositions.IsEmpty())
+	{
+		UpdateDirtyNodePositions();
 	}
 }
 
@@ -272,6 +319,7 @@ void UHeartGraphCanvas::SetNodeLocation(const FHeartNodeGuid& Node, const FVecto
 		else
 		{
 			NodeLocations.FindOrAdd(Node) = ProxiedLocation;
+			UpdateSpatialIndex(DisplayedGraph->GetNode(Node));
 			InvalidateNodeDisplay(Node, EHeartGraphCanvasInvalidateType::NodeLocation);
 		}
 	}
@@ -283,11 +331,22 @@ void UHeartGraphCanvas::Reset()
 
 	for (auto&& DisplayedNode : DisplayedNodes)
 	{
-		DisplayedNode.Value->GraphNode->GetOnNodeLocationChanged().RemoveAll(this);
+		if (DisplayedNode.Value->GraphNode.IsValid())
+		{
+			DisplayedNode.Value->GraphNode->GetOnNodeLocationChanged().RemoveAll(this);
+		}
 		DisplayedNode.Value->RemoveFromParent();
 	}
 
 	DisplayedNodes.Empty();
+	DirtyNodePositions.Empty();
+	NodeWidgetPools.Empty();
+	NodePlaceholders.Empty();
+	SpatialIndex.Reset();
+	ProxyConnections.Empty();
+	VisibleProxies.Empty();
+	VisibleProxyConnections.Empty();
+	ProxyConnectionsDirty = true;
 	SelectedNodes.Empty();
 	PreviewConnectionPin = FHeartGraphPinReference();
 }
@@ -307,6 +366,22 @@ void UHeartGraphCanvas::Refresh()
 
 	TArray<UHeartGraphNode*> GraphNodes;
 	DisplayedGraph->GetNodeArray(GraphNodes);
+
+	for (auto&& GraphNode : GraphNodes)
+	{
+		if (IsValid(GraphNode))
+		{
+			UpdateSpatialIndex(GraphNode);
+		}
+	}
+
+	// Widgets are created on the next tick, once the view size is known.
+	if (UseVirtualization)
+	{
+		NeedsToUpdateVirtualization = true;
+		return;
+	}
+
 	DisplayedNodes.Reserve(GraphNodes.Num());
 	for (auto&& GraphNode : GraphNodes)
 	{
@@ -322,18 +397,43 @@ void UHeartGraphCanvas::Refresh()
 	}
 }
 
-void UHeartGraphCanvas::UpdateAllPositionsOnCanvas()
+void UHeartGraphCanvas::UpdateDirtyNodePositions()
 {
-	for (auto&& DisplayedNode : DisplayedNodes)
+	for (auto&& NodeGuid : DirtyNodePositions)
 	{
-		UpdateNodePositionOnCanvas(DisplayedNode.Value);
+		if (auto&& CanvasNode = DisplayedNodes.Find(NodeGuid))
+		{
+			UpdateNodePositionOnCanvas(*CanvasNode);
+		}
 	}
+
+	DirtyNodePositions.Reset();
 }
 
 void UHeartGraphCanvas::UpdateNodePositionOnCanvas(const UHeartGraphCanvasNode* CanvasNode)
 {
-	auto&& Node = CanvasNode->GetGraphNode();
+	const FVector2D NodeLocation = GetDisplayLocation(CanvasNode->GetGraphNode());
+
+	auto&& CanvasSlot = Cast<UCanvasPanelSlot>(CanvasNode->Slot);
+
+	if (!ensure(IsValid(CanvasSlot)))
+	{
+		UE_LOG(LogHeartGraphCanvas, Error, TEXT("HeartGraphCanvasNodes must be added to a canvas"))
+		return;
+	}
+
+	// Slots are positioned for the layout view, the render transform on the node layer takes care of the rest.
+	const FVector2D Position = (FVector2D(LayoutView.X, LayoutView.Y) + NodeLocation) * LayoutView.Z;
+	//const FVector2D ProxiedPosition = LocationModifiers->LocationToProxy(Position);
+
+	CanvasSlot->SetPosition(Position);
 
+	// Keep the indexed bounds in step with the widget's laid out size.
+	UpdateSpatialIndex(CanvasNode->GetGraphNode());
+}
+
+FVector2D UHeartGraphCanvas::GetDisplayLocation(const UHeartGraphNode* Node) const
+{
 	FVector2D NodeLocation;
 
 	if (!SyncNodeLocationsWithGraph && NodeLocations.Contains(Node->GetGuid()))
@@ -350,26 +450,423 @@ void UHeartGraphCanvas::UpdateNodePositionOnCanvas(const UHeartGraphCanvasNode*
 		NodeLocation = FVector2D::ZeroVector;
 	}
 
-	auto&& CanvasSlot = Cast<UCanvasPanelSlot>(CanvasNode->Slot);
+	return NodeLocation;
+}
 
-	if (!ensure(IsValid(CanvasSlot)))
+FBox2f UHeartGraphCanvas::GetNodeBounds(const UHeartGraphNode* Node) const
+{
+	const FHeartNodeGuid NodeGuid = Node->GetGuid();
+
+	FVector2f Size(EstimatedNodeSize);
+	if (auto&& CanvasNode = DisplayedNodes.Find(NodeGuid);
+		CanvasNode && !(*CanvasNode)->GetDesiredSize().IsNearlyZero())
+	{
+		Size = FVector2f((*CanvasNode)->GetDesiredSize()) / LayoutView.Z;
+	}
+	else if (auto&& Placeholder = NodePlaceholders.Find(NodeGuid))
+	{
+		Size = Placeholder->Size;
+	}
+
+	const FVector2f Location(GetDisplayLocation(Node));
+	return FBox2f(Location, Location + Size);
+}
+
+void UHeartGraphCanvas::UpdateSpatialIndex(const UHeartGraphNode* Node)
+{
+	if (IsValid(Node))
+	{
+		SpatialIndex.Update(Node->GetGuid(), GetNodeBounds(Node));
+	}
+}
+
+void UHeartGraphCanvas::UpdateVirtualizedNodes(const FGeometry& Geometry)
+{
+	if (!DisplayedGraph.IsValid())
 	{
-		UE_LOG(LogHeartGraphCanvas, Error, TEXT("HeartGraphCanvasNodes must be added to a canvas"))
 		return;
 	}
 
-	const FVector2D Position = ScalePositionToCanvasZoom(NodeLocation);
-	//const FVector2D ProxiedPosition = LocationModifiers->LocationToProxy(Position);
+	const FVector2f ViewSize = Geometry.GetLocalSize();
+	const FBox2f ViewBox(
+		UnscalePositionToCanvasZoom_2f(ViewSize * -VirtualizationGuardBand),
+		UnscalePositionToCanvasZoom_2f(ViewSize * (1.f + VirtualizationGuardBand)));
 
-	CanvasSlot->SetPosition(Position);
+	// While showing proxies, no node needs a widget.
+	TArray<FHeartNodeGuid> NodesInView;
+	if (!ShowingNodeProxies)
+	{
+		SpatialIndex.Query(ViewBox, NodesInView);
+	}
+
+	TSet<FHeartNodeGuid> WantedNodes(NodesInView);
+
+	// Connection widgets belong to their output node, so keep the sources of connections into the view as well. A
+	// connection layer draws connections without widgets, so it doesn't need this.
+	if (!HasConnectionLayer())
+	{
+		TArray<FHeartNodeGuid> ConnectedSources;
+		for (auto&& NodeGuid : WantedNodes)
+		{
+			const UHeartGraphNode* Node = DisplayedGraph->GetNode(NodeGuid);
+			if (!IsValid(Node))
+			{
+				continue;
+			}
+
+			Node->FindPinsByDirection(EHeartPinDirection::Input)
+				.ForEach(
+				[&](const FHeartPinGuid PinGuid)
+				{
+					auto&& LinksView = Node->ViewConnections(PinGuid);
+					if (!LinksView.IsValid())
+					{
+						return;
+					}
+
+					for (auto&& Link : LinksView.Get().GetLinks())
+					{
+						ConnectedSources.Add(Link.NodeGuid);
+					}
+				});
+		}
+		WantedNodes.Append(ConnectedSources);
+	}
+
+	TArray<FHeartNodeGuid> UnwantedNodes;
+	for (auto&& DisplayedNode : DisplayedNodes)
+	{
+		if (!WantedNodes.Contains(DisplayedNode.Key))
+		{
+			UnwantedNodes.Add(DisplayedNode.Key);
+		}
+	}
+
+	for (auto&& NodeGuid : UnwantedNodes)
+	{
+		RemoveNodeFromDisplay(NodeGuid);
+	}
+
+	TArray<UHeartGraphCanvasNode*> NewWidgets;
+	for (auto&& NodeGuid : WantedNodes)
+	{
+		if (DisplayedNodes.Contains(NodeGuid))
+		{
+			continue;
+		}
+
+		if (UHeartGraphNode* Node = DisplayedGraph->GetNode(NodeGuid))
+		{
+			AddNodeToDisplay(Node, false);
+			if (auto&& CanvasNode = DisplayedNodes.Find(NodeGuid))
+			{
+				NewWidgets.Add(*CanvasNode);
+			}
+		}
+	}
+
+	// Init only once all new widgets exist, so connections between them can resolve.
+	for (auto&& Widget : NewWidgets)
+	{
+		Widget->PostInitNode();
+	}
+}
+
+UHeartGraphCanvasNode* UHeartGraphCanvas::AcquireNodeWidget(const TSubclassOf<UHeartGraphCanvasNode> VisualizerClass)
+{
+	if (auto&& Pool = NodeWidgetPools.Find(VisualizerClass))
+	{
+		while (!Pool->Widgets.IsEmpty())
+		{
+			if (UHeartGraphCanvasNode* Widget = Pool->Widgets.Pop(EAllowShrinking::No))
+			{
+				return Widget;
+			}
+		}
+	}
+
+	return CreateWidget<UHeartGraphCanvasNode>(this, VisualizerClass);
+}
+
+void UHeartGraphCanvas::ReleaseNodeWidget(const FHeartNodeGuid& NodeGuid, UHeartGraphCanvasNode* Widget)
+{
+	if (!UseVirtualization)
+	{
+		Widget->RemoveFromParent();
+		return;
+	}
+
+	CaptureNodePlaceholder(NodeGuid, Widget);
+
+	Widget->ResetForPool();
+	NodeWidgetPools.FindOrAdd(Widget->GetClass()).Widgets.Add(Widget);
+}
+
+void UHeartGraphCanvas::CaptureNodePlaceholder(const FHeartNodeGuid& NodeGuid, const UHeartGraphCanvasNode* Widget)
+{
+	const FGeometry& NodeGeometry = Widget->GetCachedGeometry();
+
+	// Widgets that were never laid out have nothing to remember.
+	if (NodeGeometry.GetLocalSize().IsNearlyZero())
+	{
+		return;
+	}
+
+	const float InvZoom = 1.f / LayoutView.Z;
+
+	FHeartCanvasNodePlaceholder& Placeholder = NodePlaceholders.FindOrAdd(NodeGuid);
+	Placeholder.Size = NodeGeometry.GetLocalSize() * InvZoom;
+	Placeholder.PinOffsets.Reset();
+
+	for (auto&& PinWidget : Widget->GetPinWidgets())
+	{
+		const FVector2f PinCenter = PinWidget->GetCachedGeometry().GetAbsolutePositionAtCoordinates(FVector2f(0.5f));
+		Placeholder.PinOffsets.Add(PinWidget->GetPinGuid(), NodeGeometry.AbsoluteToLocal(PinCenter) * InvZoom);
+	}
+
+	// Widgets only know their real size after layout, so this is the best time to correct the indexed bounds.
+	UpdateSpatialIndex(Widget->GetGraphNode());
 }
 
 void UHeartGraphCanvas::UpdateAllCanvasNodesZoom()
 {
 	for (auto&& DisplayedNode : DisplayedNodes)
 	{
-		DisplayedNode.Value->OnZoomSet(View.Z);
+		DisplayedNode.Value->OnZoomSet(LayoutView.Z);
+	}
+}
+
+void UHeartGraphCanvas::CreatePopupCanvas()
+{
+	if (!IsValid(NodeCanvas) || !IsValid(WidgetTree))
+	{
+		return;
+	}
+
+	UPanelWidget* NodeLayerParent = NodeCanvas->GetParent();
+	if (!IsValid(NodeLayerParent))
+	{
+		return;
+	}
+
+	PopupCanvas = WidgetTree->ConstructWidget<UCanvasPanel>(UCanvasPanel::StaticClass(), TEXT("CANVAS_Popups"));
+
+	// Only the popups themselves should take input.
+	PopupCanvas->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+
+	// Cover the same area as the node canvas, so popup locations mean the same thing on either.
+	UPanelSlot* PopupSlot = NodeLayerParent->AddChild(PopupCanvas);
+	if (UCanvasPanelSlot* PopupCanvasSlot = Cast<UCanvasPanelSlot>(PopupSlot))
+	{
+		if (const UCanvasPanelSlot* NodeCanvasSlot = Cast<UCanvasPanelSlot>(NodeCanvas->Slot))
+		{
+			PopupCanvasSlot->SetLayout(NodeCanvasSlot->GetLayout());
+			PopupCanvasSlot->SetZOrder(NodeCanvasSlot->GetZOrder() + 1);
+		}
+	}
+	else if (UOverlaySlot* PopupOverlaySlot = Cast<UOverlaySlot>(PopupSlot))
+	{
+		PopupOverlaySlot->SetHorizontalAlignment(HAlign_Fill);
+		PopupOverlaySlot->SetVerticalAlignment(VAlign_Fill);
+	}
+}
+
+UCanvasPanel* UHeartGraphCanvas::GetPopupPanel() const
+{
+	return PopupCanvas ? PopupCanvas.Get() : NodeCanvas.Get();
+}
+
+void UHeartGraphCanvas::UpdateNodeLayerTransform(const FGeometry& Geometry)
+{
+	if (!IsValid(NodeCanvas))
+	{
+		return;
+	}
+
+	const FVector2f Translation = (FVector2f(View) - FVector2f(LayoutView)) * View.Z;
+
+	// Once the view stops moving, lay nodes out again if the zoom changed, so they are not drawn scaled, or if the
+	// layer has drifted far enough that nodes are placed well outside of it.
+	if (TargetView == View)
+	{
+		const FVector2f MaxDrift = Geometry.GetLocalSize();
+		if (View.Z != LayoutView.Z || FMath::Abs(Translation.X) > MaxDrift.X || FMath::Abs(Translation.Y) > MaxDrift.Y)
+		{
+			RebaseNodeLayer();
+			return;
+		}
+	}
+
+	NodeCanvas->SetRenderTransform(FWidgetTransform(FVector2D(Translation), FVector2D(View.Z / LayoutView.Z), FVector2D::ZeroVector, 0.f));
+}
+
+void UHeartGraphCanvas::RebaseNodeLayer()
+{
+	const bool ZoomChanged = LayoutView.Z != View.Z;
+
+	LayoutView = View;
+	NodeCanvas->SetRenderTransform(FWidgetTransform());
+
+	if (ZoomChanged)
+	{
+		UpdateAllCanvasNodesZoom();
+	}
+
+	for (auto&& DisplayedNode : DisplayedNodes)
+	{
+		DirtyNodePositions.Add(DisplayedNode.Key);
+	}
+}
+
+void UHeartGraphCanvas::SetShowingNodeProxies(const bool Value)
+{
+	ShowingNodeProxies = Value;
+
+	for (auto&& DisplayedNode : DisplayedNodes)
+	{
+		DisplayedNode.Value->SetShownAsProxy(ShowingNodeProxies);
+	}
+
+	// Virtualized canvases release every widget while showing proxies.
+	NeedsToUpdateVirtualization = true;
+	NeedsToUpdateProxies = true;
+	NeedsToUpdateView = true;
+}
+
+void UHeartGraphCanvas::UpdateNodeProxies(const FGeometry& Geometry)
+{
+	if (ProxyConnectionsDirty)
+	{
+		GatherProxyConnections();
+		ProxyConnectionsDirty = false;
+	}
+
+	const FBox2f ViewBox(
+		UnscalePositionToCanvasZoom_2f(FVector2f::ZeroVector),
+		UnscalePositionToCanvasZoom_2f(Geometry.GetLocalSize()));
+
+	TArray<FHeartNodeGuid> NodesInView;
+	SpatialIndex.Query(ViewBox, NodesInView);
+
+	VisibleProxies.Reset(NodesInView.Num());
+	for (auto&& NodeGuid : NodesInView)
+	{
+		VisibleProxies.Add({ NodeGuid, *SpatialIndex.FindBounds(NodeGuid) });
+	}
+
+	VisibleProxyConnections.Reset();
+	for (auto&& Connection : ProxyConnections)
+	{
+		const FBox2f* FromBounds = SpatialIndex.FindBounds(Connection.Key);
+		const FBox2f* ToBounds = SpatialIndex.FindBounds(Connection.Value);
+		if (!FromBounds || !ToBounds)
+		{
+			continue;
+		}
+
+		const FVector2f Start = FromBounds->GetCenter();
+		const FVector2f End = ToBounds->GetCenter();
+		if (FBox2f(FVector2f::Min(Start, End), FVector2f::Max(Start, End)).Intersect(ViewBox))
+		{
+			VisibleProxyConnections.Add({ Start, End });
+		}
+	}
+}
+
+void UHeartGraphCanvas::GatherProxyConnections()
+{
+	ProxyConnections.Reset();
+
+	if (!DisplayedGraph.IsValid())
+	{
+		return;
+	}
+
+	// Many pin connections between the same two nodes are drawn as one line.
+	TSet<TPair<FHeartNodeGuid, FHeartNodeGuid>> UniqueConnections;
+
+	DisplayedGraph->ForEachNode(
+		[&](const UHeartGraphNode* Node)
+		{
+			Node->FindPinsByDirection(EHeartPinDirection::Output)
+				.ForEach(
+				[&](const FHeartPinGuid PinGuid)
+				{
+					auto&& LinksView = Node->ViewConnections(PinGuid);
+					if (!LinksView.IsValid())
+					{
+						return;
+					}
+
+					for (auto&& Link : LinksView.Get().GetLinks())
+					{
+						if (Link.NodeGuid != Node->GetGuid())
+						{
+							UniqueConnections.Add({ Node->GetGuid(), Link.NodeGuid });
+						}
+					}
+				});
+			return true;
+		});
+
+	ProxyConnections = UniqueConnections.Array();
+}
+
+void UHeartGraphCanvas::PaintNodeProxies(const FGeometry& AllottedGeometry, FSlateWindowElementList& OutDrawElements,
+										 const int32 LayerId) const
+{
+	const FSlateRenderTransform& RenderTransform = AllottedGeometry.GetAccumulatedRenderTransform();
+
+	auto AddQuad = [this, &RenderTransform](const FVector2f& A, const FVector2f& B, const FVector2f& C, const FVector2f& D, const FColor& Color)
+		{
+			const SlateIndex Base = static_cast<SlateIndex>(ProxyVertices.Num());
+			ProxyVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, A, FVector2f(0.f, 0.f), Color));
+			ProxyVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, B, FVector2f(1.f, 0.f), Color));
+			ProxyVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, C, FVector2f(1.f, 1.f), Color));
+			ProxyVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, D, FVector2f(0.f, 1.f), Color));
+			ProxyIndices.Append({ Base, Base + 1, Base + 2, Base, Base + 2, Base + 3 });
+		};
+
+	// The node canvas is laid out for LayoutView, and its render transform covers the rest, same as node slots.
+	auto ToNodeLayer = [this](const FVector2f& Position)
+		{
+			return (FVector2f(LayoutView) + Position) * LayoutView.Z;
+		};
+
+	ProxyVertices.Reset();
+	ProxyIndices.Reset();
+
+	// Connections are added first, so boxes are drawn over them. Thickness is undone from the render transform's
+	// scale, so it stays constant on screen.
+	const FColor ConnectionColor = ProxyConnectionColor.ToFColor(true);
+	const float HalfThickness = ProxyConnectionThickness * 0.5f * LayoutView.Z / View.Z;
+	for (auto&& Connection : VisibleProxyConnections)
+	{
+		const FVector2f Start = ToNodeLayer(Connection.Key);
+		const FVector2f End = ToNodeLayer(Connection.Value);
+		const FVector2f Direction = (End - Start).GetSafeNormal();
+		const FVector2f Offset = FVector2f(-Direction.Y, Direction.X) * HalfThickness;
+		AddQuad(Start + Offset, End + Offset, End - Offset, Start - Offset, ConnectionColor);
 	}
+
+	const FColor NodeColor = ProxyNodeColor.ToFColor(true);
+	const FColor SelectedNodeColor = ProxySelectedNodeColor.ToFColor(true);
+	for (auto&& Proxy : VisibleProxies)
+	{
+		const FVector2f Min = ToNodeLayer(Proxy.Value.Min);
+		const FVector2f Max = ToNodeLayer(Proxy.Value.Max);
+		AddQuad(Min, FVector2f(Max.X, Min.Y), Max, FVector2f(Min.X, Max.Y),
+			SelectedNodes.Contains(Proxy.Key) ? SelectedNodeColor : NodeColor);
+	}
+
+	if (ProxyIndices.IsEmpty())
+	{
+		return;
+	}
+
+	const FSlateResourceHandle ResourceHandle =
+		FSlateApplication::Get().GetRenderer()->GetResourceHandle(*FCoreStyle::Get().GetBrush("WhiteBrush"));
+	FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, ResourceHandle, ProxyVertices, ProxyIndices, nullptr, 0, 0);
 }
 
 void UHeartGraphCanvas::UpdateAfterSelectionChanged()
@@ -379,23 +876,25 @@ void UHeartGraphCanvas::UpdateAfterSelectionChanged()
 		!SelectedNodes.IsEmpty())
 	{
 		FVector2f AverageNodePosition = FVector2f::ZeroVector;
+		int32 NumSummed = 0;
 
+		// Focus on the center of each node, not the corner. The spatial index has bounds for every node, including
+		// ones culled by virtualization.
 		for (const FHeartNodeGuid& SelectedNode : SelectedNodes)
 		{
-			if (auto&& Node = DisplayedNodes.Find(SelectedNode))
+			if (const FBox2f* Bounds = SpatialIndex.FindBounds(SelectedNode))
 			{
-				if (const TObjectPtr<UHeartGraphCanvasNode> CanvasNode = *Node)
-				{
-					// Add the canonical location of the graph node.
-					AverageNodePosition += FVector2f(CanvasNode->GetGraphNode()->GetLocation());
-
-					// Add half the size of the node. We are focusing on the center of the node, not the corner
-					AverageNodePosition += CanvasNode->GetCachedGeometry().GetLocalSize() * 0.5f * (1.0f / static_cast<float>(View.Z));
-				}
+				AverageNodePosition += Bounds->GetCenter();
+				++NumSummed;
 			}
 		}
 
-		AverageNodePosition *= 1.f / SelectedNodes.Num();
+		if (NumSummed == 0)
+		{
+			return;
+		}
+
+		AverageNodePosition *= 1.f / NumSummed;
 
 		if (PanToSelectionSettings.EnablePanToSelection)
 		{
@@ -445,7 +944,7 @@ void UHeartGraphCanvas::AddNodeToDisplay(UHeartGraphNode* Node, const bool InitN
 
 	if (const TSubclassOf<UHeartGraphCanvasNode> VisualizerClass = GetVisualClassForNode(Node))
 	{
-		auto&& Widget = CreateWidget<UHeartGraphCanvasNode>(this, VisualizerClass);
+		auto&& Widget = AcquireNodeWidget(VisualizerClass);
 		check(Widget);
 
 		Widget->GraphCanvas = this;
@@ -456,9 +955,17 @@ void UHeartGraphCanvas::AddNodeToDisplay(UHeartGraphNode* Node, const bool InitN
 		NodeSlot->SetZOrder(Heart::Canvas::NodeZOrder);
 		NodeSlot->SetAutoSize(true);
 
-		Widget->OnZoomSet(View.Z);
+		Widget->OnZoomSet(LayoutView.Z);
 		UpdateNodePositionOnCanvas(Widget);
 
+		// Virtualized nodes can be materialized again while selected.
+		if (SelectedNodes.Contains(Node->GetGuid()))
+		{
+			Widget->SetNodeSelectedFromGraph(true);
+		}
+
+		Widget->SetShownAsProxy(ShowingNodeProxies);
+
 		if (InitNodeWidget)
 		{
 			Widget->PostInitNode();
@@ -475,13 +982,29 @@ void UHeartGraphCanvas::AddNodeToDisplay(UHeartGraphNode* Node, const bool InitN
 	}
 }
 
+void UHeartGraphCanvas::RemoveNodeFromDisplay(const FHeartNodeGuid& NodeGuid)
+{
+	if (DisplayedNodes.Contains(NodeGuid))
+	{
+		auto&& Value = DisplayedNodes.FindAndRemoveChecked(NodeGuid);
+
+		if (Value->GraphNode.IsValid())
+		{
+			Value->GraphNode->GetOnNodeLocationChanged().RemoveAll(this);
+		}
+
+		ReleaseNodeWidget(NodeGuid, Value);
+		DirtyNodePositions.Remove(NodeGuid);
+	}
+}
+
 void UHeartGraphCanvas::SetViewOffset(const FVector2f& Value)
 {
 	if (Value.X != View.X || Value.Y != View.Y)
 	{
 		View.X = Value.X;
 		View.Y = Value.Y;
-		NeedsToUpdatePositions = true;
+		NeedsToUpdateView = true;
 		OnGraphViewChanged.Broadcast();
 	}
 }
@@ -491,7 +1014,7 @@ void UHeartGraphCanvas::AddToViewOffset(const FVector2f& Value)
 	if (!Value.IsZero())
 	{
 		View += Value;
-		NeedsToUpdatePositions = true;
+		NeedsToUpdateView = true;
 		OnGraphViewChanged.Broadcast();
 	}
 }
@@ -536,7 +1059,7 @@ void UHeartGraphCanvas::SetZoom(const float Value)
 		default: ;
 		}
 
-		NeedsToUpdatePositions = true;
+		NeedsToUpdateView = true;
 		OnGraphViewChanged.Broadcast();
 	}
 }
@@ -664,8 +1187,48 @@ bool UHeartGraphCanvas::IsNodeCulled(const UHeartGraphCanvasNode* GraphNode, con
 	//}
 }
 
+void UHeartGraphCanvas::OnGraphBatch(const FHeartGraphBatchEvent& BatchEvent)
+{
+	for (auto&& Node : BatchEvent.Removed.AffectedNodes)
+	{
+		if (IsValid(Node))
+		{
+			OnNodeRemovedFromGraph(Node);
+		}
+	}
+
+	for (auto&& NodeGuid : BatchEvent.Added.NewNodes)
+	{
+		if (UHeartGraphNode* Node = DisplayedGraph->GetNode(NodeGuid))
+		{
+			OnNodeAddedToGraph(Node);
+		}
+	}
+
+	if (!BatchEvent.Moved.AffectedNodes.IsEmpty())
+	{
+		OnNodesMoved(BatchEvent.Moved);
+	}
+
+	if (!BatchEvent.Connections.AffectedNodes.IsEmpty() || !BatchEvent.Connections.AffectedPins.IsEmpty())
+	{
+		OnNodeConnectionsChanged(BatchEvent.Connections);
+	}
+}
+
 void UHeartGraphCanvas::OnNodeAddedToGraph(UHeartGraphNode* Node)
 {
+	UpdateSpatialIndex(Node);
+	ProxyConnectionsDirty = true;
+	NeedsToUpdateProxies = true;
+
+	if (UseVirtualization)
+	{
+		// The node is given a widget on the next tick, if it is in view.
+		NeedsToUpdateVirtualization = true;
+		return;
+	}
+
 	if (IsValid(Node))
 	{
 		AddNodeToDisplay(Node, true);
@@ -688,25 +1251,42 @@ void UHeartGraphCanvas::OnNodeRemovedFromGraph(UHeartGraphNode* Node)
 		UnselectNode(NodeGuid);
 	}
 
-	if (DisplayedNodes.Contains(NodeGuid))
-	{
-		auto&& Value = DisplayedNodes.FindAndRemoveChecked(NodeGuid);
-
-		if (Value->GraphNode.IsValid())
-		{
-			Value->GraphNode->GetOnNodeLocationChanged().RemoveAll(this);
-		}
+	RemoveNodeFromDisplay(NodeGuid);
+	NodePlaceholders.Remove(NodeGuid);
+	SpatialIndex.Remove(NodeGuid);
+	ProxyConnectionsDirty = true;
+	NeedsToUpdateProxies = true;
+}
 
-		Value->RemoveFromParent();
+void UHeartGraphCanvas::OnNodeLocationChanged(UHeartGraphNode* Node, const FVector2D& Location)
+{
+	if (DisplayedNodes.Contains(Node->GetGuid()))
+	{
+		DirtyNodePositions.Add(Node->GetGuid());
 	}
 }
 
-void UHeartGraphCanvas::OnNodeLocationChanged(UHeartGraphNode* Node, const FVector2D& Location)
+void UHeartGraphCanvas::OnNodesMoved(const FHeartNodeMoveEvent& Event)
 {
-	if (auto&& GraphNode = DisplayedNodes.Find(Node->GetGuid()))
+	// Nodes without widgets have no location binding, so this is how their moves are noticed.
+	for (auto&& Node : Event.AffectedNodes)
+	{
+		UpdateSpatialIndex(Node);
+	}
+
+	// Moved nodes might have entered or left the view.
+	if (UseVirtualization)
 	{
-		UpdateNodePositionOnCanvas(*GraphNode);
+		NeedsToUpdateVirtualization = true;
 	}
+
+	NeedsToUpdateProxies = true;
+}
+
+void UHeartGraphCanvas::OnNodeConnectionsChanged(const FHeartGraphConnectionEvent& Event)
+{
+	ProxyConnectionsDirty = true;
+	NeedsToUpdateProxies = true;
 }
 
 FVector2f UHeartGraphCanvas::ScalePositionToCanvasZoom_2f(const FVector2f& Position) const
@@ -749,9 +1329,9 @@ void UHeartGraphCanvas::InvalidateNodeDisplay(const FHeartNodeGuid& NodeGuid, co
 		}
 		break;
 	case EHeartGraphCanvasInvalidateType::NodeLocation:
-		if (auto&& CanvasNode = GetCanvasNode(NodeGuid))
+		if (DisplayedNodes.Contains(NodeGuid))
 		{
-			UpdateNodePositionOnCanvas(CanvasNode);
+			DirtyNodePositions.Add(NodeGuid);
 		}
 		break;
 	case EHeartGraphCanvasInvalidateType::Connections:
@@ -779,6 +1359,102 @@ UHeartGraphCanvasPin* UHeartGraphCanvas::ResolvePinReference(const FHeartGraphPi
 	return nullptr;
 }
 
+FVector2D UHeartGraphCanvas::ResolvePinLocation(const FHeartGraphPinReference& PinReference) const
+{
+	if (const UHeartGraphCanvasPin* PinWidget = ResolvePinReference(PinReference))
+	{
+		const FVector2f PinCenter = PinWidget->GetTickSpaceGeometry().GetAbsolutePositionAtCoordinates(FVector2f(0.5f));
+		return FVector2D(GetTickSpaceGeometry().AbsoluteToLocal(PinCenter));
+	}
+
+	if (!DisplayedGraph.IsValid())
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	const UHeartGraphNode* GraphNode = DisplayedGraph->GetNode(PinReference.NodeGuid);
+	if (!IsValid(GraphNode))
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	// Without a widget, fall back to where the pin was the last time the node had one.
+	FVector2f Location(GetDisplayLocation(GraphNode));
+	if (auto&& Placeholder = NodePlaceholders.Find(PinReference.NodeGuid))
+	{
+		if (auto&& PinOffset = Placeholder->PinOffsets.Find(PinReference.PinGuid))
+		{
+			Location += *PinOffset;
+		}
+	}
+
+	return FVector2D(ScalePositionToCanvasZoom_2f(Location));
+}
+
+TArray<FHeartNodeGuid> UHeartGraphCanvas::FindNodesInCanvasRect(const FVector2D& CanvasMin, const FVector2D& CanvasMax) const
+{
+	// Allow rects dragged in any direction.
+	const FVector2f GraphA = UnscalePositionToCanvasZoom_2f(FVector2f(CanvasMin));
+	const FVector2f GraphB = UnscalePositionToCanvasZoom_2f(FVector2f(CanvasMax));
+
+	TArray<FHeartNodeGuid> Nodes;
+	SpatialIndex.Query(FBox2f(FVector2f::Min(GraphA, GraphB), FVector2f::Max(GraphA, GraphB)), Nodes);
+	return Nodes;
+}
+
+FHeartNodeGuid UHeartGraphCanvas::FindNodeAtCanvasLocation(const FVector2D& CanvasLocation) const
+{
+	return SpatialIndex.QueryPoint(UnscalePositionToCanvasZoom_2f(FVector2f(CanvasLocation)));
+}
+
+FHeartGraphPinReference UHeartGraphCanvas::FindNearestPin(const FVector2D& CanvasLocation, const float MaxDistance) const
+{
+	FHeartGraphPinReference Nearest;
+
+	if (!DisplayedGraph.IsValid())
+	{
+		return Nearest;
+	}
+
+	const FVector2f GraphLocation = UnscalePositionToCanvasZoom_2f(FVector2f(CanvasLocation));
+	const float GraphDistance = MaxDistance / View.Z;
+
+	TArray<FHeartNodeGuid> Candidates;
+	SpatialIndex.Query(FBox2f(GraphLocation - GraphDistance, GraphLocation + GraphDistance), Candidates);
+
+	double NearestDistanceSqr = FMath::Square(static_cast<double>(MaxDistance));
+
+	auto TestPin = [&](const FHeartGraphPinReference& Pin)
+		{
+			const double DistanceSqr = FVector2D::DistSquared(ResolvePinLocation(Pin), CanvasLocation);
+			if (DistanceSqr <= NearestDistanceSqr)
+			{
+				NearestDistanceSqr = DistanceSqr;
+				Nearest = Pin;
+			}
+		};
+
+	for (auto&& NodeGuid : Candidates)
+	{
+		if (auto&& CanvasNode = DisplayedNodes.Find(NodeGuid))
+		{
+			for (auto&& PinWidget : (*CanvasNode)->GetPinWidgets())
+			{
+				TestPin(PinWidget->GetPinReference());
+			}
+		}
+		else if (auto&& Placeholder = NodePlaceholders.Find(NodeGuid))
+		{
+			for (auto&& PinOffset : Placeholder->PinOffsets)
+			{
+				TestPin({ NodeGuid, PinOffset.Key });
+			}
+		}
+	}
+
+	return Nearest;
+}
+
 UHeartGraphCanvasNode* UHeartGraphCanvas::GetCanvasNode(const FHeartNodeGuid& NodeGuid)
 {
 	if (auto&& Node = DisplayedNodes.Find(NodeGuid))
@@ -811,8 +1487,7 @@ void UHeartGraphCanvas::SetGraph(UHeartGraph* Graph)
 			return;
 		}
 
-		DisplayedGraph->GetOnNodeAdded().RemoveAll(this);
-		DisplayedGraph->GetOnNodeRemoved().RemoveAll(this);
+		DisplayedGraph->GetOnBatchEvent().RemoveAll(this);
 		Reset();
 	}
 
@@ -820,8 +1495,7 @@ void UHeartGraphCanvas::SetGraph(UHeartGraph* Graph)
 
 	if (DisplayedGraph.IsValid())
 	{
-		DisplayedGraph->GetOnNodeAdded().AddUObject(this, &ThisClass::OnNodeAddedToGraph);
-		DisplayedGraph->GetOnNodeRemoved().AddUObject(this, &ThisClass::OnNodeRemovedFromGraph);
+		DisplayedGraph->GetOnBatchEvent().AddUObject(this, &ThisClass::OnGraphBatch);
 		Refresh();
 	}
 }
@@ -929,7 +1603,8 @@ UCanvasPanelSlot* UHeartGraphCanvas::AddWidgetToPopups(UWidget* Widget, const FV
 
 	Popups.Add(Widget);
 
-	UCanvasPanelSlot* CanvasSlot = NodeCanvas->AddChildToCanvas(Widget);
+	// Popups are kept off the node canvas, which is panned and zoomed by a render transform.
+	UCanvasPanelSlot* CanvasSlot = GetPopupPanel()->AddChildToCanvas(Widget);
 	CanvasSlot->SetPosition(Location);
 	CanvasSlot->SetAutoSize(true);
 	CanvasSlot->SetZOrder(Heart::Canvas::PopUpZOrder);
@@ -942,7 +1617,7 @@ bool UHeartGraphCanvas::RemoveWidgetFromPopups(UWidget* Widget)
 
 	Popups.Remove(Widget);
 
-	return NodeCanvas->RemoveChild(Widget);
+	return GetPopupPanel()->RemoveChild(Widget);
 }
 
 void UHeartGraphCanvas::ClearPopups()
@@ -0,0 +1,78 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "UMG/HeartGraphCanvasConnectionLayer.h"
+#include "UMG/HeartGraphCanvas.h"
+#include "Slate/SHeartCanvasConnectionLayer.h"
+
+#include "HeartCanvasPaletteCategory.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HeartGraphCanvasConnectionLayer)
+
+UHeartGraphCanvasConnectionLayer::UHeartGraphCanvasConnectionLayer()
+{
+	Color = FLinearColor::White;
+	Thickness = 2.f;
+	TangentLength = 100.f;
+	Segments = 16;
+	Brush.DrawAs = ESlateBrushDrawType::NoDrawType;
+
+	// Connections don't take input, so pins and nodes underneath remain clickable.
+	SetVisibilityInternal(ESlateVisibility::HitTestInvisible);
+}
+
+void UHeartGraphCanvasConnectionLayer::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+
+	if (MyLayer.IsValid())
+	{
+		MyLayer->SetStyle(Color, Thickness, TangentLength, Segments, &Brush);
+		MyLayer->SetCanvas(GraphCanvas.Get());
+	}
+}
+
+void UHeartGraphCanvasConnectionLayer::ReleaseSlateResources(const bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+
+	MyLayer.Reset();
+}
+
+#if WITH_EDITOR
+const FText UHeartGraphCanvasConnectionLayer::GetPaletteCategory()
+{
+	return Heart::Canvas::PaletteCategory::Default;
+}
+#endif
+
+TSharedRef<SWidget> UHeartGraphCanvasConnectionLayer::RebuildWidget()
+{
+	MyLayer = SNew(SHeartCanvasConnectionLayer)
+		.Color(Color)
+		.Thickness(Thickness)
+		.TangentLength(TangentLength)
+		.Segments(Segments)
+		.Brush(&Brush);
+
+	MyLayer->SetCanvas(GraphCanvas.Get());
+
+	return MyLayer.ToSharedRef();
+}
+
+void UHeartGraphCanvasConnectionLayer::SetCanvas(UHeartGraphCanvas* InCanvas)
+{
+	GraphCanvas = InCanvas;
+
+	if (MyLayer.IsValid())
+	{
+		MyLayer->SetCanvas(InCanvas);
+	}
+}
+
+void UHeartGraphCanvasConnectionLayer::InvalidateAllConnections()
+{
+	if (MyLayer.IsValid())
+	{
+		MyLayer->InvalidateAll();
+	}
+}
\ No newline at end of file
@@ -59,6 +59,68 @@ void UHeartGraphCanvasNode::SetNodeSelectedFromGraph(const bool Selected)
 	}
 }
 
+void UHeartGraphCanvasNode::ResetForPool()
+{
+	RemoveFromParent();
+
+	if (ShownAsProxy)
+	{
+		ShownAsProxy = false;
+		SetVisibility(VisibilityBeforeProxy);
+	}
+
+	for (auto&& Element : ConnectionWidgets)
+	{
+		Element->RemoveFromParent();
+	}
+	ConnectionWidgets.Empty();
+
+	for (auto&& PinWidget : PinWidgets)
+	{
+		PinWidget->RemoveFromParent();
+	}
+	PinWidgets.Empty();
+
+	if (GraphNode.IsValid())
+	{
+		GraphNode->GetOnPinConnectionsChanged().RemoveAll(this);
+	}
+
+	GraphNode.Reset();
+	NodeSelected = false;
+}
+
+void UHeartGraphCanvasNode::SetShownAsProxy(const bool AsProxy)
+{
+	if (ShownAsProxy == AsProxy)
+	{
+		return;
+	}
+
+	ShownAsProxy = AsProxy;
+
+	if (ShownAsProxy)
+	{
+		VisibilityBeforeProxy = GetVisibility();
+		SetVisibility(ESlateVisibility::Collapsed);
+
+		for (auto&& Element : ConnectionWidgets)
+		{
+			Element->RemoveFromParent();
+		}
+		ConnectionWidgets.Empty();
+	}
+	else
+	{
+		SetVisibility(VisibilityBeforeProxy);
+
+		if (GraphNode.IsValid())
+		{
+			RebuildAllPinConnections();
+		}
+	}
+}
+
 void UHeartGraphCanvasNode::SetNodeSelected(const bool Selected)
 {
 	if (Selected)
@@ -98,6 +160,9 @@ void UHeartGraphCanvasNode::RebuildPinConnections(const FHeartPinGuid& Pin)
 		}
 	}
 
+	// The canvas draws connections instead, either with its connection layer, or between proxies.
+	if (ShownAsProxy || GraphCanvas->HasConnectionLayer()) return;
+
 	const FHeartGraphPinDesc& ThisDesc = GraphNode->GetPinDescChecked(Pin);
 
 	if (ThisDesc.Direction != EHeartPinDirection::Output) return;
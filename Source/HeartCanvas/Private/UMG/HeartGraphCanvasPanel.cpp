@@ -2,6 +2,8 @@
 
 #include "UMG/HeartGraphCanvasPanel.h"
 #include "HeartCanvasPaletteCategory.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Slate/SHeartGraphCanvasPanel.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartGraphCanvasPanel)
 
@@ -19,4 +21,33 @@ const FText UHeartGraphCanvasPanel::GetPaletteCategory()
 {
 	return Heart::Canvas::PaletteCategory::Default;
 }
-#endif
\ No newline at end of file
+#endif
+
+void UHeartGraphCanvasPanel::SetGraphCanvas(UHeartGraphCanvas* InGraphCanvas)
+{
+	GraphCanvas = InGraphCanvas;
+
+	if (MyCanvas.IsValid())
+	{
+		StaticCastSharedPtr<SHeartGraphCanvasPanel>(MyCanvas)->SetCanvas(InGraphCanvas);
+	}
+}
+
+TSharedRef<SWidget> UHeartGraphCanvasPanel::RebuildWidget()
+{
+	// Same as UCanvasPanel, but with a canvas that can paint node proxies.
+	TSharedRef<SHeartGraphCanvasPanel> Panel = SNew(SHeartGraphCanvasPanel);
+	Panel->SetCanvas(GraphCanvas.Get());
+	MyCanvas = Panel;
+
+	for (UPanelSlot* PanelSlot : Slots)
+	{
+		if (UCanvasPanelSlot* TypedSlot = Cast<UCanvasPanelSlot>(PanelSlot))
+		{
+			TypedSlot->Parent = this;
+			TypedSlot->BuildSlot(Panel);
+		}
+	}
+
+	return Panel;
+}
\ No newline at end of file
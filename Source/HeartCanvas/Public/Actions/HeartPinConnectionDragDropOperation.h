@@ -24,6 +24,11 @@ public:
 	virtual void OnHoverCleared() override;
 
 protected:
+	// Hover the nearest pin within this distance of the cursor, in canvas space, even if the cursor isn't over it.
+	// Zero disables snapping.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PinConnection", meta = (ClampMin = 0))
+	float PinSnapDistance = 0.f;
+
 	UPROPERTY()
 	TWeakObjectPtr<UHeartGraphCanvas> Canvas;
 
@@ -34,4 +39,7 @@ protected:
 	TWeakObjectPtr<UHeartGraphCanvasPin> HoveredPin;
 
 	FHeartConnectPinsResponse Response;
+
+	// Was HoveredPin set by snapping, rather than by the cursor hovering its widget?
+	bool HoverIsSnapped = false;
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Model/HeartGuids.h"
+
+namespace Heart::Canvas
+{
+	/**
+	 * A uniform grid over node bounds, in graph space. Nodes are bucketed in every cell their bounds overlap, so area
+	 * queries only visit nodes near the queried area, instead of every node in the graph.
+	 */
+	class HEARTCANVAS_API FNodeSpatialIndex
+	{
+	public:
+		explicit FNodeSpatialIndex(float InCellSize = 512.f);
+
+		// Add a node, or update its bounds. Only touches the grid if the node changed cells.
+		void Update(const FHeartNodeGuid& Node, const FBox2f& Bounds);
+
+		void Remove(const FHeartNodeGuid& Node);
+
+		void Reset();
+
+		bool Contains(const FHeartNodeGuid& Node) const { return Entries.Contains(Node); }
+		int32 Num() const { return Entries.Num(); }
+
+		const FBox2f* FindBounds(const FHeartNodeGuid& Node) const;
+
+		// Find each node whose bounds intersect the area.
+		void Query(const FBox2f& Area, TArray<FHeartNodeGuid>& OutNodes) const;
+
+		// Find the node whose bounds contain the point. Ties pick the node added or moved most recently.
+		FHeartNodeGuid QueryPoint(const FVector2f& Point) const;
+
+	private:
+		FIntRect GetCellRange(const FBox2f& Bounds) const;
+
+		struct FEntry
+		{
+			FBox2f Bounds;
+			FIntRect CellRange;
+
+			// Increases every time the node is updated, used to favor recently moved nodes, as they are drawn on top.
+			uint32 Stamp;
+		};
+
+		float CellSize;
+		uint32 NextStamp = 0;
+
+		TMap<FHeartNodeGuid, FEntry> Entries;
+		TMap<FIntPoint, TArray<FHeartNodeGuid>> Cells;
+	};
+}
\ No newline at end of file
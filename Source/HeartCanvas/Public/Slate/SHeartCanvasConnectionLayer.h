@@ -0,0 +1,104 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Model/HeartGraphPinReference.h"
+#include "Rendering/RenderingCommon.h"
+#include "Widgets/SLeafWidget.h"
+
+struct FHeartGraphBatchEvent;
+class UHeartGraph;
+class UHeartGraphCanvas;
+
+/**
+ * Draws every connection of a graph canvas as a single batch of custom verts. Connections are tessellated in graph
+ * space and cached, so panning and zooming never re-tessellate, and only connections touching moved nodes are
+ * rebuilt. Connections whose bounds miss the view are not drawn.
+ */
+class HEARTCANVAS_API SHeartCanvasConnectionLayer : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SHeartCanvasConnectionLayer)
+	  : _Color(FLinearColor::White),
+		_Thickness(2.f),
+		_TangentLength(100.f),
+		_Segments(16),
+		_Brush(nullptr)
+	{}
+		SLATE_ARGUMENT(FLinearColor, Color)
+		SLATE_ARGUMENT(float, Thickness)
+		SLATE_ARGUMENT(float, TangentLength)
+		SLATE_ARGUMENT(int32, Segments)
+		SLATE_ARGUMENT(const FSlateBrush*, Brush)
+	SLATE_END_ARGS()
+
+	virtual ~SHeartCanvasConnectionLayer() override;
+
+	void Construct(const FArguments& InArgs);
+
+	void SetCanvas(UHeartGraphCanvas* InCanvas);
+
+	void SetStyle(const FLinearColor& InColor, float InThickness, float InTangentLength, int32 InSegments, const FSlateBrush* InBrush);
+
+	// Throw away every cached connection, and gather them again from the graph.
+	void InvalidateAll();
+
+	/** SWidget */
+	virtual void Tick(const FGeometry& AllottedGeometry, double InCurrentTime, float InDeltaTime) override;
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+						  FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle,
+						  bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	/** SWidget */
+
+private:
+	struct FEdge
+	{
+		FHeartGraphPinReference From;
+		FHeartGraphPinReference To;
+
+		// Endpoints, in graph space, that Points was tessellated for.
+		FVector2f Start = FVector2f::ZeroVector;
+		FVector2f End = FVector2f::ZeroVector;
+
+		FBox2f Bounds = FBox2f(ForceInit);
+
+		// Points along the curve, and the unit normal at each, in graph space. Normals are unchanged by panning and
+		// zooming, so the strip can be extruded to any zoom without re-tessellating.
+		TArray<FVector2f> Points;
+		TArray<FVector2f> Normals;
+	};
+
+	void BindGraph(UHeartGraph* NewGraph);
+	void OnGraphBatchEvent(const FHeartGraphBatchEvent& Event);
+
+	void GatherEdges();
+	void UpdateEdge(FEdge& Edge) const;
+	void Tessellate(FEdge& Edge) const;
+
+	TWeakObjectPtr<UHeartGraphCanvas> Canvas;
+	TWeakObjectPtr<UHeartGraph> Graph;
+
+	FLinearColor Color;
+	float Thickness = 2.f;
+	float TangentLength = 100.f;
+	int32 Segments = 16;
+	FSlateResourceHandle ResourceHandle;
+
+	TArray<FEdge> Edges;
+	TMap<FHeartNodeGuid, TArray<int32>> NodeEdges;
+
+	// Nodes moved since the last tick. Their connections are re-tessellated, even if out of view, to keep bounds valid.
+	TSet<FHeartNodeGuid> DirtyNodes;
+	bool EdgesDirty = true;
+
+	// Edges intersecting the view on the last tick.
+	TArray<int32> VisibleEdges;
+
+	// Offset from canvas space to the space of this widget.
+	FVector2f CanvasOffset = FVector2f::ZeroVector;
+
+	// Reused between paints, to avoid reallocating the batch each frame.
+	mutable TArray<FSlateVertex> Vertices;
+	mutable TArray<SlateIndex> Indices;
+};
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Widgets/Layout/SConstraintCanvas.h"
+
+class UHeartGraphCanvas;
+
+/**
+ * Constraint canvas that holds the nodes of a graph canvas. Node proxies are painted under its children, so anything
+ * layered above the node canvas, like popups, stays on top of them.
+ */
+class HEARTCANVAS_API SHeartGraphCanvasPanel : public SConstraintCanvas
+{
+public:
+	void SetCanvas(UHeartGraphCanvas* InCanvas);
+
+	/** SWidget */
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+						  FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle,
+						  bool bParentEnabled) const override;
+	/** SWidget */
+
+private:
+	TWeakObjectPtr<UHeartGraphCanvas> Canvas;
+};
\ No newline at end of file
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "HeartGraphWidgetBase.h"
+#include "HeartCanvasSpatialIndex.h"
 
 #include "Input/HeartWidgetInputBindingContainer.h"
 
@@ -12,10 +13,12 @@
 #include "ModelView/HeartNodeLocationModifier.h"
 
 #include "General/VectorBounds.h"
+#include "Rendering/RenderingCommon.h"
 
 #include "HeartGraphCanvas.generated.h"
 
 class UHeartLayoutHelper;
+class UCanvasPanel;
 class UCanvasPanelSlot;
 
 class UHeartGraph;
@@ -23,6 +26,9 @@ class UHeartGraphCanvasPanel;
 class UHeartGraphCanvasNode;
 class UHeartGraphCanvasPin;
 class UHeartGraphCanvasConnection;
+class UHeartGraphCanvasConnectionLayer;
+struct FHeartNodeMoveEvent;
+struct FHeartGraphConnectionEvent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogHeartGraphCanvas, Log, All)
 
@@ -90,6 +96,26 @@ struct FHeartPanToSelectionSettings
 	float ZoomDistance = 1.f;
 };
 
+// Unused node widgets of one visualizer class, kept for reuse by virtualized canvases.
+USTRUCT()
+struct FHeartCanvasNodeWidgetPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UHeartGraphCanvasNode>> Widgets;
+};
+
+// What is remembered about a node after its widget is released, so its pins can still be located without a widget.
+struct FHeartCanvasNodePlaceholder
+{
+	// Size of the node widget, in graph units.
+	FVector2f Size = FVector2f::ZeroVector;
+
+	// Center of each pin widget, relative to the node's location, in graph units.
+	TMap<FHeartPinGuid, FVector2f> PinOffsets;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnGraphViewChanged);
 
 /**
@@ -128,6 +154,9 @@ public:
 
 	UCanvasPanelSlot* AddConnectionWidget(UHeartGraphCanvasConnection* ConnectionWidget);
 
+	// When a connection layer is bound, it draws all connections, and nodes don't create connection widgets.
+	bool HasConnectionLayer() const { return ConnectionLayer != nullptr; }
+
 	/**
 	 * Get the class used to display a node on the Canvas Graph. This has a default implementation that fetches a
 	 * visualizer from the Runtime Subsystem Registry for the graph. Override to provide alternate/custom behavior.
@@ -156,17 +185,46 @@ protected:
 
 	void Refresh();
 
-	/** Update the position of every node on the canvas. */
-	void UpdateAllPositionsOnCanvas();
+	/** Update the position of nodes that have moved since they were last placed on the canvas. */
+	void UpdateDirtyNodePositions();
 	void UpdateNodePositionOnCanvas(const UHeartGraphCanvasNode* CanvasNode);
 
+	// Pan and zoom the node layer with a render transform, until the view settles and it is laid out again.
+	void UpdateNodeLayerTransform(const FGeometry& Geometry);
+	void RebaseNodeLayer();
+
+	// Creates PopupCanvas next to the node canvas, if the widget blueprint didn't bind one.
+	void CreatePopupCanvas();
+
+	// Panel popups are added to. Falls back to the node canvas if there is no popup canvas.
+	UCanvasPanel* GetPopupPanel() const;
+
 	void UpdateAllCanvasNodesZoom();
 
+	// Switch every node between its widget and a box drawn by the canvas.
+	void SetShowingNodeProxies(bool Value);
+	void UpdateNodeProxies(const FGeometry& Geometry);
+	void GatherProxyConnections();
+
 	void UpdateAfterSelectionChanged();
 
 	void CreatePreviewConnection();
 
 	void AddNodeToDisplay(UHeartGraphNode* Node, bool InitNodeWidget);
+	void RemoveNodeFromDisplay(const FHeartNodeGuid& NodeGuid);
+
+	FVector2D GetDisplayLocation(const UHeartGraphNode* Node) const;
+
+	// Bounds of the node in graph space, from its widget if it has one, or its placeholder, or EstimatedNodeSize.
+	FBox2f GetNodeBounds(const UHeartGraphNode* Node) const;
+	void UpdateSpatialIndex(const UHeartGraphNode* Node);
+
+	// Materialize widgets for nodes in view, and release the rest. Only used when UseVirtualization is enabled.
+	void UpdateVirtualizedNodes(const FGeometry& Geometry);
+
+	UHeartGraphCanvasNode* AcquireNodeWidget(TSubclassOf<UHeartGraphCanvasNode> VisualizerClass);
+	void ReleaseNodeWidget(const FHeartNodeGuid& NodeGuid, UHeartGraphCanvasNode* Widget);
+	void CaptureNodePlaceholder(const FHeartNodeGuid& NodeGuid, const UHeartGraphCanvasNode* Widget);
 
 	void SetViewOffset(const FVector2f& Value);
 	void AddToViewOffset(const FVector2f& Value);
@@ -174,9 +232,13 @@ protected:
 	void SetZoom(float Value);
 	void AddToZoom(float Value);
 
+	// Graph edits are received as batches, and dispatched to the handlers below.
+	void OnGraphBatch(const FHeartGraphBatchEvent& BatchEvent);
 	void OnNodeAddedToGraph(UHeartGraphNode* Node);
 	void OnNodeRemovedFromGraph(UHeartGraphNode* Node);
 	void OnNodeLocationChanged(UHeartGraphNode* Node, const FVector2D& Location);
+	void OnNodesMoved(const FHeartNodeMoveEvent& Event);
+	void OnNodeConnectionsChanged(const FHeartGraphConnectionEvent& Event);
 
 
 	/*----------------------
@@ -206,6 +268,13 @@ public:
 
 	const FHeartDragIntoViewSettings& GetDragIntoViewSettings() const { return DragIntoViewSettings; }
 
+	// Are nodes drawn as proxy boxes, because the zoom is below ProxyZoomThreshold?
+	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
+	bool IsShowingNodeProxies() const { return ShowingNodeProxies; }
+
+	// Paints node proxies into the geometry of the node canvas. Called by the node canvas, under its children.
+	void PaintNodeProxies(const FGeometry& AllottedGeometry, FSlateWindowElementList& OutDrawElements, int32 LayerId) const;
+
 
 	/*----------------------
 			UTILITIES
@@ -228,6 +297,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
 	UHeartGraphCanvasPin* ResolvePinReference(const FHeartGraphPinReference& PinReference) const;
 
+	// Get the center of a pin, in canvas space. Works for nodes culled by virtualization, which have no pin widgets.
+	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
+	FVector2D ResolvePinLocation(const FHeartGraphPinReference& PinReference) const;
+
+	// Find the nodes overlapping a rectangle in canvas space, e.g., for marquee selection.
+	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
+	TArray<FHeartNodeGuid> FindNodesInCanvasRect(const FVector2D& CanvasMin, const FVector2D& CanvasMax) const;
+
+	// Find the topmost node under a location in canvas space.
+	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
+	FHeartNodeGuid FindNodeAtCanvasLocation(const FVector2D& CanvasLocation) const;
+
+	// Find the pin closest to a location in canvas space, within MaxDistance. Only pins with a known location are
+	// considered, i.e., those on nodes that have, or have had, a widget.
+	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
+	FHeartGraphPinReference FindNearestPin(const FVector2D& CanvasLocation, float MaxDistance) const;
+
 	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvas")
 	UHeartGraphCanvasNode* GetCanvasNode(const FHeartNodeGuid& NodeGuid);
 
@@ -301,6 +387,17 @@ protected:
 	UPROPERTY(BlueprintReadOnly, meta = (BindWidget, DisplayName = "CANVAS_Nodes"), Category = "Widgets")
 	TObjectPtr<UHeartGraphCanvasPanel> NodeCanvas;
 
+	/**
+	 * Canvas that popups are added to. It must not be transformed with the nodes. If not bound, one is created on top of
+	 * the node canvas, in the same parent panel.
+	 */
+	UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional, DisplayName = "CANVAS_Popups"), Category = "Widgets")
+	TObjectPtr<UCanvasPanel> PopupCanvas;
+
+	/** Optional layer to draw all connections in one batch. */
+	UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Widgets")
+	TObjectPtr<UHeartGraphCanvasConnectionLayer> ConnectionLayer;
+
 	UPROPERTY()
 	TWeakObjectPtr<UHeartGraph> DisplayedGraph;
 
@@ -371,13 +468,73 @@ protected:
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config")
 	bool RunLayoutOnTick = false;
 
+	// Only create widgets for nodes in or near the view, and recycle widgets of the same class while panning. Connection
+	// widgets are owned by their output node, so without a ConnectionLayer, nodes with connections into the view are kept.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config")
+	bool UseVirtualization = false;
+
+	// Extra area around the view, as a fraction of its size, where nodes are kept materialized.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (EditCondition = "UseVirtualization", ClampMin = 0))
+	float VirtualizationGuardBand = 0.25f;
+
+	// Size assumed for nodes that haven't had a widget yet, in graph units.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (EditCondition = "UseVirtualization"))
+	FVector2D EstimatedNodeSize = FVector2D(200.0, 100.0);
+
+	// Below this zoom, nodes are drawn by the canvas as plain boxes instead of their widgets, and connections as a
+	// single line between each pair of connected nodes. Zero disables proxies.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (ClampMin = 0))
+	float ProxyZoomThreshold = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (EditCondition = "ProxyZoomThreshold > 0"))
+	FLinearColor ProxyNodeColor = FLinearColor(0.2f, 0.2f, 0.2f);
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (EditCondition = "ProxyZoomThreshold > 0"))
+	FLinearColor ProxySelectedNodeColor = FLinearColor(1.f, 0.6f, 0.f);
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (EditCondition = "ProxyZoomThreshold > 0"))
+	FLinearColor ProxyConnectionColor = FLinearColor(0.6f, 0.6f, 0.6f);
+
+	// Width of proxy connections, in canvas space.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config", meta = (EditCondition = "ProxyZoomThreshold > 0", ClampMin = 0))
+	float ProxyConnectionThickness = 1.f;
+
 	// @todo temp until everything is moved over to use connection widgets
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config")
 	bool UseDeprecatedPaintMethodToDrawConnections = false;
 
 private:
+	UPROPERTY()
+	TMap<TSubclassOf<UHeartGraphCanvasNode>, FHeartCanvasNodeWidgetPool> NodeWidgetPools;
+
+	TMap<FHeartNodeGuid, FHeartCanvasNodePlaceholder> NodePlaceholders;
+
+	// Bounds of every node in the graph, including those without a widget.
+	Heart::Canvas::FNodeSpatialIndex SpatialIndex;
+
+	// Each pair of connected nodes, gathered while showing proxies.
+	TArray<TPair<FHeartNodeGuid, FHeartNodeGuid>> ProxyConnections;
+
+	// Proxies and proxy connections in view, in graph space.
+	TArray<TPair<FHeartNodeGuid, FBox2f>> VisibleProxies;
+	TArray<TPair<FVector2f, FVector2f>> VisibleProxyConnections;
+
+	// Reused between paints, to avoid reallocating the batch each frame.
+	mutable TArray<FSlateVertex> ProxyVertices;
+	mutable TArray<SlateIndex> ProxyIndices;
+
+	// Nodes whose slots need to be repositioned next tick.
+	TSet<FHeartNodeGuid> DirtyNodePositions;
+
 	FVector3f View;
 	FVector3f TargetView;
 
-	bool NeedsToUpdatePositions = false;
+	// The view that node slots were last positioned at. The node layer's render transform covers the difference to View.
+	FVector3f LayoutView;
+
+	bool NeedsToUpdateView = false;
+	bool NeedsToUpdateVirtualization = false;
+	bool NeedsToUpdateProxies = false;
+	bool ProxyConnectionsDirty = true;
+	bool ShowingNodeProxies = false;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Components/Widget.h"
+#include "HeartGraphCanvasConnectionLayer.generated.h"
+
+class SHeartCanvasConnectionLayer;
+class UHeartGraphCanvas;
+
+/**
+ * Draws all connections of a graph canvas in a single batch, instead of a widget per connection. Bind it to a graph
+ * canvas by naming it ConnectionLayer, and place it covering the same area as the node canvas, underneath it.
+ */
+UCLASS()
+class HEARTCANVAS_API UHeartGraphCanvasConnectionLayer : public UWidget
+{
+	GENERATED_BODY()
+
+public:
+	UHeartGraphCanvasConnectionLayer();
+
+	/** UWidget */
+	virtual void SynchronizeProperties() override;
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+#if WITH_EDITOR
+	virtual const FText GetPaletteCategory() override;
+#endif
+	/** UWidget */
+
+protected:
+	/** UWidget */
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+	/** UWidget */
+
+public:
+	void SetCanvas(UHeartGraphCanvas* InCanvas);
+
+	// Throw away every cached connection, and gather them again from the graph.
+	UFUNCTION(BlueprintCallable, Category = "Heart|GraphCanvasConnectionLayer")
+	void InvalidateAllConnections();
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance")
+	FLinearColor Color;
+
+	// Width of connections, in canvas space. Unaffected by zoom.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance", meta = (ClampMin = 0))
+	float Thickness;
+
+	// Horizontal tangent at both ends of each connection, in graph space.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance")
+	float TangentLength;
+
+	// Number of segments each connection is tessellated into.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance", meta = (ClampMin = 1, ClampMax = 64))
+	int32 Segments;
+
+	// Texture sampled along connections, across their width. Defaults to solid white.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance")
+	FSlateBrush Brush;
+
+	TWeakObjectPtr<UHeartGraphCanvas> GraphCanvas;
+
+private:
+	TSharedPtr<SHeartCanvasConnectionLayer> MyLayer;
+};
\ No newline at end of file
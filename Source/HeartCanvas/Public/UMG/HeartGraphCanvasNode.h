@@ -38,10 +38,18 @@ protected:
 
 	virtual void SetNodeSelectedFromGraph(bool Selected);
 
+	// Clear everything bound to the current node, so the canvas can reuse this widget for another node of the same
+	// class. Pooled widgets are constructed again when reused, so pin widgets should be created on Construct.
+	virtual void ResetForPool();
+
+	// While shown as a proxy, the canvas draws this node, so the widget and its connection widgets are hidden.
+	virtual void SetShownAsProxy(bool AsProxy);
+
 public:
 	UHeartGraphNode* GetGraphNode() const { return GraphNode.Get(); }
 	UHeartGraphCanvas* GetCanvas() const { return GraphCanvas.Get(); }
 	bool IsNodeSelected() const { return NodeSelected; }
+	bool IsShownAsProxy() const { return ShownAsProxy; }
 
 	void SetNodeSelected(bool Selected);
 
@@ -89,4 +97,10 @@ protected:
 
 	UPROPERTY(BlueprintReadOnly, Category = "State")
 	bool NodeSelected = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "State")
+	bool ShownAsProxy = false;
+
+private:
+	ESlateVisibility VisibilityBeforeProxy = ESlateVisibility::Visible;
 };
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include "Components/CanvasPanel.h"
 #include "HeartGraphCanvasPanel.generated.h"
 
+class UHeartGraphCanvas;
+class SHeartGraphCanvasPanel;
+
 /**
  *
  */
@@ -21,4 +24,14 @@ public:
 	virtual const FText GetPaletteCategory() override;
 #endif
 	/** UWidget */
+
+	// Set by the graph canvas that owns this panel, so node proxies can be painted under the nodes.
+	void SetGraphCanvas(UHeartGraphCanvas* InGraphCanvas);
+
+protected:
+	/** UWidget */
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+	/** UWidget */
+
+	TWeakObjectPtr<UHeartGraphCanvas> GraphCanvas;
 };
@@ -1,47 +1,57 @@
 // Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
 
 #include "Algorithms/FruchtermanReingold.h"
+#include "Async/ParallelFor.h"
 
 namespace Nodesoup
 {
-    FruchtermanReingold::FruchtermanReingold(FGraphView InGraph, const double InStrength)
+    // With cells the size of the cutoff, any pair close enough to repel is in the same or an adjacent cell.
+    static FIntPoint GetCell(const FVector2D& Position)
+    {
+        return FIntPoint(FMath::FloorToInt32(Position.X / FruchtermanReingold::RepulsionCutoff),
+                         FMath::FloorToInt32(Position.Y / FruchtermanReingold::RepulsionCutoff));
+    }
+
+    FruchtermanReingold::FruchtermanReingold(FGraphView InGraph, const double InStrength, const ERepulsionMode InRepulsionMode,
+                                             const FExecutionSettings& InExecution)
         : Graph(InGraph)
         , Strength(InStrength)
         , StrengthSqr(Strength * Strength)
+        , RepulsionMode(InRepulsionMode)
+        , Execution(InExecution)
         , Temperature(10 * FMath::Sqrt(static_cast<double>(Graph.Num())))
     {
         Movements.SetNumZeroed(Graph.Num());
     }
 
+    void FruchtermanReingold::SetGraph(const FGraphView InGraph)
+    {
+        Graph = InGraph;
+        Movements.SetNumZeroed(Graph.Num());
+    }
+
     void FruchtermanReingold::operator()(TArray<FVector2D>& Positions)
     {
-        for (int32 Node = 0; Node < Graph.Num(); Node++)
+        // Repulsion force between vertex pairs
+        if (Execution.SinglePrecision)
         {
-            // Repulsion force between vertex pairs
-            for (int32 Adj = Node + 1; Adj < Graph.Num(); Adj++)
-            {
-                if (Node == Adj)
-                {
-                    continue;
-                }
-
-                FVector2D Delta = Positions[Node] - Positions[Adj];
-                const double Distance = Delta.Size();
-                // TODO: handle distance == 0.0
-
-                // > 1000.0: not worth computing
-                if (Distance > 1000.0)
-                {
-                    continue;
-                }
-
-                const double Repulsion = StrengthSqr / Distance;
-
-                const FVector2D Movement = Delta / Distance * Repulsion;
-                Movements[Node] += Movement;
-                Movements[Adj] -= Movement;
-            }
+            RepulseParallel(Positions, FloatBuffers);
+        }
+        else if (Execution.NumTasks > 1)
+        {
+            RepulseParallel(Positions, DoubleBuffers);
+        }
+        else if (RepulsionMode == ERepulsionMode::SpatialGrid)
+        {
+            RepulseSpatialGrid(Positions);
+        }
+        else
+        {
+            RepulseExact(Positions);
+        }
 
+        for (int32 Node = 0; Node < Graph.Num(); Node++)
+        {
             // Attraction force between edges
             for (const int32 Adj : Graph[Node])
             {
@@ -90,4 +100,196 @@ namespace Nodesoup
             Temperature = 1.5;
         }
     }
+
+    FORCEINLINE void FruchtermanReingold::Repulse(const int32 Node, const int32 Adj, const TConstArrayView<FVector2D> Positions)
+    {
+        FVector2D Delta = Positions[Node] - Positions[Adj];
+        const double Distance = Delta.Size();
+
+        // == 0: coincident nodes have no direction to push apart in, so skip the pair, as the parallel path does
+        // > RepulsionCutoff: not worth computing
+        if (FMath::IsNearlyZero(Distance) || Distance > RepulsionCutoff)
+        {
+            return;
+        }
+
+        const double Repulsion = StrengthSqr / Distance;
+
+        const FVector2D Movement = Delta / Distance * Repulsion;
+        Movements[Node] += Movement;
+        Movements[Adj] -= Movement;
+    }
+
+    void FruchtermanReingold::RepulseExact(const TConstArrayView<FVector2D> Positions)
+    {
+        for (int32 Node = 0; Node < Graph.Num(); Node++)
+        {
+            for (int32 Adj = Node + 1; Adj < Graph.Num(); Adj++)
+            {
+                Repulse(Node, Adj, Positions);
+            }
+        }
+    }
+
+    void FruchtermanReingold::RepulseSpatialGrid(const TConstArrayView<FVector2D> Positions)
+    {
+        BuildSpatialGrid(Positions);
+
+        for (int32 Node = 0; Node < Graph.Num(); Node++)
+        {
+            const FIntPoint Cell = GetCell(Positions[Node]);
+
+            for (int32 OffsetY = -1; OffsetY <= 1; OffsetY++)
+            {
+                for (int32 OffsetX = -1; OffsetX <= 1; OffsetX++)
+                {
+                    const int32* Head = CellHeads.Find(Cell + FIntPoint(OffsetX, OffsetY));
+                    if (!Head)
+                    {
+                        continue;
+                    }
+
+                    for (int32 Adj = *Head; Adj != INDEX_NONE; Adj = CellNext[Adj])
+                    {
+                        // Every pair is found from both sides, only handle it once.
+                        if (Adj > Node)
+                        {
+                            Repulse(Node, Adj, Positions);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void FruchtermanReingold::BuildSpatialGrid(const TConstArrayView<FVector2D> Positions)
+    {
+        CellHeads.Reset();
+        CellNext.SetNumUninitialized(Graph.Num(), EAllowShrinking::No);
+
+        for (int32 Node = 0; Node < Graph.Num(); Node++)
+        {
+            int32& Head = CellHeads.FindOrAdd(GetCell(Positions[Node]), INDEX_NONE);
+            CellNext[Node] = Head;
+            Head = Node;
+        }
+    }
+
+    template <typename T>
+    void FruchtermanReingold::RepulseParallel(const TConstArrayView<FVector2D> Positions, TForceBuffers<T>& Buffers)
+    {
+        const int32 Num = Graph.Num();
+        const int32 NumTasks = FMath::Clamp(Execution.NumTasks, 1, FMath::Max(Num, 1));
+
+        Buffers.X.SetNumUninitialized(Num, EAllowShrinking::No);
+        Buffers.Y.SetNumUninitialized(Num, EAllowShrinking::No);
+        for (int32 Node = 0; Node < Num; Node++)
+        {
+            Buffers.X[Node] = static_cast<T>(Positions[Node].X);
+            Buffers.Y[Node] = static_cast<T>(Positions[Node].Y);
+        }
+
+        Buffers.TaskMovementsX.SetNum(NumTasks);
+        Buffers.TaskMovementsY.SetNum(NumTasks);
+
+        if (RepulsionMode == ERepulsionMode::SpatialGrid)
+        {
+            BuildSpatialGrid(Positions);
+        }
+
+        const T* RESTRICT X = Buffers.X.GetData();
+        const T* RESTRICT Y = Buffers.Y.GetData();
+        const T CutoffSqr = static_cast<T>(RepulsionCutoff * RepulsionCutoff);
+        const T StrengthSqrT = static_cast<T>(StrengthSqr);
+
+        ParallelFor(NumTasks,
+            [&](const int32 Task)
+            {
+                TArray<T>& TaskX = Buffers.TaskMovementsX[Task];
+                TArray<T>& TaskY = Buffers.TaskMovementsY[Task];
+                TaskX.SetNumUninitialized(Num, EAllowShrinking::No);
+                TaskY.SetNumUninitialized(Num, EAllowShrinking::No);
+                FMemory::Memzero(TaskX.GetData(), Num * sizeof(T));
+                FMemory::Memzero(TaskY.GetData(), Num * sizeof(T));
+
+                T* RESTRICT MoveX = TaskX.GetData();
+                T* RESTRICT MoveY = TaskY.GetData();
+
+                // Repulsion along the normalized delta is StrengthSqr / Distance, so the scale applied to the raw delta
+                // is StrengthSqr / DistanceSqr. The cutoff is a select instead of a branch, to keep the loop vectorizable.
+                auto Scale = [CutoffSqr, StrengthSqrT](const T DistanceSqr)
+                    {
+                        return DistanceSqr <= CutoffSqr && DistanceSqr > T(0) ? StrengthSqrT / DistanceSqr : T(0);
+                    };
+
+                // Vertices are interleaved across tasks, which keeps the triangular pair loop evenly balanced.
+                for (int32 Node = Task; Node < Num; Node += NumTasks)
+                {
+                    const T NodeX = X[Node];
+                    const T NodeY = Y[Node];
+                    T SumX = 0;
+                    T SumY = 0;
+
+                    if (RepulsionMode == ERepulsionMode::SpatialGrid)
+                    {
+                        const FIntPoint Cell = GetCell(Positions[Node]);
+
+                        for (int32 OffsetY = -1; OffsetY <= 1; OffsetY++)
+                        {
+                            for (int32 OffsetX = -1; OffsetX <= 1; OffsetX++)
+                            {
+                                const int32* Head = CellHeads.Find(Cell + FIntPoint(OffsetX, OffsetY));
+                                if (!Head)
+                                {
+                                    continue;
+                                }
+
+                                for (int32 Adj = *Head; Adj != INDEX_NONE; Adj = CellNext[Adj])
+                                {
+                                    if (Adj > Node)
+                                    {
+                                        const T DeltaX = NodeX - X[Adj];
+                                        const T DeltaY = NodeY - Y[Adj];
+                                        const T Factor = Scale(DeltaX * DeltaX + DeltaY * DeltaY);
+                                        SumX += DeltaX * Factor;
+                                        SumY += DeltaY * Factor;
+                                        MoveX[Adj] -= DeltaX * Factor;
+                                        MoveY[Adj] -= DeltaY * Factor;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    else
+                    {
+                        for (int32 Adj = Node + 1; Adj < Num; Adj++)
+                        {
+                            const T DeltaX = NodeX - X[Adj];
+                            const T DeltaY = NodeY - Y[Adj];
+                            const T Factor = Scale(DeltaX * DeltaX + DeltaY * DeltaY);
+                            SumX += DeltaX * Factor;
+                            SumY += DeltaY * Factor;
+                            MoveX[Adj] -= DeltaX * Factor;
+                            MoveY[Adj] -= DeltaY * Factor;
+                        }
+                    }
+
+                    MoveX[Node] += SumX;
+                    MoveY[Node] += SumY;
+                }
+            },
+            NumTasks > 1 ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+        // Sum task movements in a fixed order, so results are identical no matter which worker ran which task.
+        for (int32 Task = 0; Task < NumTasks; Task++)
+        {
+            const TArray<T>& TaskX = Buffers.TaskMovementsX[Task];
+            const TArray<T>& TaskY = Buffers.TaskMovementsY[Task];
+            for (int32 Node = 0; Node < Num; Node++)
+            {
+                Movements[Node].X += TaskX[Node];
+                Movements[Node].Y += TaskY[Node];
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Algorithms/GraphDistance.h"
+
+namespace Nodesoup
+{
+    FUndirectedGraph::FUndirectedGraph(FGraphView Graph)
+    {
+        // Count degrees first, so the edges can be written straight into place.
+        Offsets.SetNumZeroed(Graph.Num() + 1);
+        for (int32 Vertex = 0; Vertex < Graph.Num(); Vertex++)
+        {
+            for (const int32 Adjacent : Graph[Vertex])
+            {
+                if (Adjacent != Vertex)
+                {
+                    Offsets[Vertex + 1]++;
+                    Offsets[Adjacent + 1]++;
+                }
+            }
+        }
+
+        for (int32 Vertex = 0; Vertex < Graph.Num(); Vertex++)
+        {
+            Offsets[Vertex + 1] += Offsets[Vertex];
+        }
+
+        TArray<int32> Cursor(Offsets.GetData(), Graph.Num());
+        Indices.SetNumUninitialized(Offsets.Last());
+        for (int32 Vertex = 0; Vertex < Graph.Num(); Vertex++)
+        {
+            for (const int32 Adjacent : Graph[Vertex])
+            {
+                if (Adjacent != Vertex)
+                {
+                    Indices[Cursor[Vertex]++] = Adjacent;
+                    Indices[Cursor[Adjacent]++] = Vertex;
+                }
+            }
+        }
+    }
+
+    void BreadthFirstDistances(const FUndirectedGraph& Graph, const int32 Source, TArrayView<int32> OutDistances, TArray<int32>& Queue)
+    {
+        check(OutDistances.Num() == Graph.Num());
+
+        for (int32& Distance : OutDistances)
+        {
+            Distance = INDEX_NONE;
+        }
+
+        Queue.Reset(Graph.Num());
+        Queue.Add(Source);
+        OutDistances[Source] = 0;
+
+        // The queue is never popped from, only read with a cursor, so it doubles as the visit order.
+        for (int32 Head = 0; Head < Queue.Num(); Head++)
+        {
+            const int32 Vertex = Queue[Head];
+            const int32 NextDistance = OutDistances[Vertex] + 1;
+
+            for (const int32 Adjacent : Graph.Neighbors(Vertex))
+            {
+                if (OutDistances[Adjacent] == INDEX_NONE)
+                {
+                    OutDistances[Adjacent] = NextDistance;
+                    Queue.Add(Adjacent);
+                }
+            }
+        }
+    }
+}
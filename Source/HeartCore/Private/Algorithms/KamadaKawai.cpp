@@ -1,89 +1,80 @@
 // Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
 
 #include "Algorithms/KamadaKawai.h"
+#include "Algorithms/GraphDistance.h"
+#include "Async/ParallelFor.h"
 
 namespace Nodesoup
 {
-    KamadaKawai::KamadaKawai(FGraphView InGraph, const double Strength, const double InEnergyThreshold)
+    KamadaKawai::KamadaKawai(FGraphView InGraph, const double Strength, const double InEnergyThreshold,
+                             const FExecutionSettings& InExecution)
         : Graph(InGraph)
         , EnergyThreshold(InEnergyThreshold)
+        , Execution(InExecution)
     {
-        const FTwoDimIntArray Distances = FloydWarshall(Graph);
-
-        // find the biggest distance
-        size_t BiggestDistance = 0;
-        for (int32 i = 0; i < Graph.Num(); i++)
+        const int32 Num = Graph.Num();
+        if (!ensureMsgf(CanLayout(Num), TEXT("Kamada-Kawai cannot layout %i vertices, the limit is %i"), Num, MaxVertices))
         {
-            for (int32 j = 0; j < Graph.Num(); j++)
+            return;
+        }
+        Springs.SetNumZeroed(static_cast<int64>(Num) * Num);
+
+        // Breadth-first search from every vertex gives the same distances as Floyd-Warshall for an unweighted graph, in
+        // O(N*E) instead of O(N³). The raw distances are written into the spring lengths, and converted below.
+        const FUndirectedGraph Undirected(Graph);
+        const int32 NumTasks = FMath::Clamp(Execution.NumTasks, 1, FMath::Max(Num, 1));
+        const int32 ChunkSize = FMath::DivideAndRoundUp(Num, NumTasks);
+
+        ParallelFor(NumTasks,
+            [&](const int32 Task)
             {
-                if (Distances[i][j] > BiggestDistance)
+                TArray<int32> Distances;
+                Distances.SetNumUninitialized(Num);
+                TArray<int32> Queue;
+
+                const int32 End = FMath::Min((Task + 1) * ChunkSize, Num);
+                for (int32 i = Task * ChunkSize; i < End; i++)
                 {
-                    BiggestDistance = Distances[i][j];
+                    BreadthFirstDistances(Undirected, i, Distances, Queue);
+                    for (int32 j = 0; j < Num; j++)
+                    {
+                        Springs[static_cast<int64>(i) * Num + j].Length = Distances[j];
+                    }
                 }
-            }
+            },
+            NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+        // find the biggest distance
+        double BiggestDistance = 1.0;
+        for (const FSpring& Spring : Springs)
+        {
+            BiggestDistance = FMath::Max(BiggestDistance, Spring.Length);
         }
 
+        // Disconnected vertices are treated as being just beyond the furthest connected pair.
+        const double DisconnectedDistance = BiggestDistance + 1.0;
+
         // Ideal length for all edges. We don't really care, the layout is going to be scaled.
         // Let's choose 1.0 as the initial positions will be on a radius 1.0 circle, so we're
         // on the same order of magnitude
         const double Length = 1.0 / BiggestDistance;
 
-        // init springs lengths and strengths matrices
-        for (int32 i = 0; i < Graph.Num(); i++)
+        // init springs lengths and strengths
+        for (int32 i = 0; i < Num; i++)
         {
-            TArray<FSpring> VertexSprings;
-
-            for (int32 j = 0; j < Graph.Num(); j++)
+            for (int32 j = 0; j < Num; j++)
             {
-                FSpring& Spring = VertexSprings.AddDefaulted_GetRef();
+                FSpring& Spring = Springs[static_cast<int64>(i) * Num + j];
                 if (i != j)
                 {
-                    const size_t Distance = Distances[i][j];
+                    const double Distance = Spring.Length == INDEX_NONE ? DisconnectedDistance : Spring.Length;
                     Spring.Length = Distance * Length;
                     Spring.Strength = Strength / (Distance * Distance);
                 }
             }
-            Springs.Add(VertexSprings);
         }
     }
 
-    FTwoDimIntArray KamadaKawai::FloydWarshall(FGraphView Graph)
-    {
-        // build adjacency matrix (infinity = no edge, 1 = edge)
-        constexpr uint32 Infinity = TNumericLimits<uint32>::Max() / 2;
-        TArray<int32> InnerArray;
-        FTwoDimIntArray Distances;
-        InnerArray.Init(Infinity, Graph.Num());
-        Distances.Init(InnerArray, Graph.Num());
-
-        for (int32 Vertex = 0; Vertex < Graph.Num(); Vertex++)
-        {
-            Distances[Vertex][Vertex] = 0;
-            for (const int32 Adjacent : Graph[Vertex])
-            {
-                if (Adjacent > Vertex)
-                {
-                    Distances[Vertex][Adjacent] = 1;
-                    Distances[Adjacent][Vertex] = 1;
-                }
-            }
-        }
-
-        // floyd warshall itself, find length of the shortest path for each pair of vertices
-        for (int32 k = 0; k < Graph.Num(); k++)
-        {
-            for (int32 i = 0; i < Graph.Num(); i++)
-            {
-                for (int32 j = 0; j < Graph.Num(); j++)
-                {
-                    Distances[i][j] = FMath::Min(Distances[i][j], Distances[i][k] + Distances[k][j]);
-                }
-            }
-        }
-
-        return Distances;
-    }
-
     #define MAX_VERTEX_ITERS_COUNT 50
     #define MAX_STEADY_ENERGY_ITERS_COUNT 50
 
@@ -93,6 +84,16 @@ namespace Nodesoup
     */
     void KamadaKawai::operator()(TArray<FVector2D>& Positions) const
     {
+        (*this)(Positions, [](TConstArrayView<FVector2D>) { return true; });
+    }
+
+    void KamadaKawai::operator()(TArray<FVector2D>& Positions, const FGraphProgressCallback& Progress) const
+    {
+        if (!CanLayout(Graph.Num()) || Graph.Num() < 2)
+        {
+            return;
+        }
+
         int32 Vertex;
         uint32 SteadyEnergyCount = 0;
         double MaxVertexEnergy = FindMaxVertexEnergy(Positions, Vertex);
@@ -108,6 +109,11 @@ namespace Nodesoup
                 VertexCount++;
             } while (ComputeVertexEnergy(Vertex, Positions) > EnergyThreshold && VertexCount < MAX_VERTEX_ITERS_COUNT);
 
+            if (!Progress(Positions))
+            {
+                return;
+            }
+
             const double MaxVertexEnergyPrev = MaxVertexEnergy;
             MaxVertexEnergy = FindMaxVertexEnergy(Positions, Vertex);
             if (FMath::Abs(MaxVertexEnergy - MaxVertexEnergyPrev) < 1e-20)
@@ -127,16 +133,54 @@ namespace Nodesoup
     */
     double KamadaKawai::FindMaxVertexEnergy(const TConstArrayView<FVector2D> Positions, int32& MaxEnergyVertex) const
     {
+        const int32 NumTasks = FMath::Clamp(Execution.NumTasks, 1, FMath::Max(Graph.Num(), 1));
+
         double MaxEnergy = -1.0;
-        for (int32 i = 0; i < Graph.Num(); i++)
+
+        if (NumTasks > 1)
         {
-            const double Energy = ComputeVertexEnergy(i, Positions);
-            if (Energy > MaxEnergy)
+            // Each task finds the max of a contiguous range of vertices. Reducing them in order with the same strict
+            // comparison picks the same vertex as the serial loop.
+            TArray<TPair<double, int32>> TaskMax;
+            TaskMax.Init({ -1.0, INDEX_NONE }, NumTasks);
+            const int32 ChunkSize = FMath::DivideAndRoundUp(Graph.Num(), NumTasks);
+
+            ParallelFor(NumTasks,
+                [&](const int32 Task)
+                {
+                    const int32 End = FMath::Min((Task + 1) * ChunkSize, Graph.Num());
+                    for (int32 i = Task * ChunkSize; i < End; i++)
+                    {
+                        const double Energy = ComputeVertexEnergy(i, Positions);
+                        if (Energy > TaskMax[Task].Key)
+                        {
+                            TaskMax[Task] = { Energy, i };
+                        }
+                    }
+                });
+
+            for (const TPair<double, int32>& Max : TaskMax)
             {
-                MaxEnergyVertex = i;
-                MaxEnergy = Energy;
+                if (Max.Key > MaxEnergy)
+                {
+                    MaxEnergyVertex = Max.Value;
+                    MaxEnergy = Max.Key;
+                }
             }
         }
+        else
+        {
+            for (int32 i = 0; i < Graph.Num(); i++)
+            {
+                const double Energy = ComputeVertexEnergy(i, Positions);
+                if (Energy > MaxEnergy)
+                {
+                    MaxEnergyVertex = i;
+                    MaxEnergy = Energy;
+                }
+            }
+        }
+
         ensure(MaxEnergy != -1.0);
         return MaxEnergy;
     }
@@ -156,7 +200,7 @@ namespace Nodesoup
             const FVector2D Delta = Positions[Vertex] - Positions[i];
             const double Distance = Delta.Size();
 
-            const FSpring& Spring = Springs[Vertex][i];
+            const FSpring& Spring = GetSpring(Vertex, i);
             Energy += Delta * (Spring.Strength * (1.0 - Spring.Length / Distance));
         }
 
@@ -186,7 +230,7 @@ namespace Nodesoup
             const double Distance = Delta.Size();
             const double CubedDistance = FMath::Cube(Distance);
 
-            const FSpring& Spring = Springs[Vertex][i];
+            const FSpring& Spring = GetSpring(Vertex, i);
 
             Energy += Delta * (Spring.Strength * (1.0 - Spring.Length / Distance));
             XEnergy.Y += Spring.Strength * Spring.Length * Delta.X * Delta.Y / CubedDistance;
@@ -0,0 +1,595 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Algorithms/LayeredLayout.h"
+#include "Algo/Reverse.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+
+namespace Nodesoup
+{
+    LayeredLayout::LayeredLayout(const FGraphView Graph, const int32 CrossingSweeps)
+        : NumVertices(Graph.Num())
+    {
+        BreakCycles(Graph);
+        AssignLayers();
+        InsertDummies();
+        OrderLayers(CrossingSweeps);
+        MarkTypeOneConflicts();
+        AssignCoordinates();
+    }
+
+    void LayeredLayout::operator()(TArray<FVector2D>& Positions) const
+    {
+        Positions.SetNumUninitialized(NumVertices);
+        for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+        {
+            Positions[Vertex] = FVector2D(Layer[Vertex], Coordinates[Vertex]);
+        }
+    }
+
+    void LayeredLayout::AssignCoordinates()
+    {
+        const int32 NumAll = Layer.Num();
+
+        // Brandes-Koepf: align each vertex with the median of its neighbors above and below, from the left and from the
+        // right, then balance the four candidate coordinates.
+        TArray<double> Candidates[4];
+        TArray<TArray<int32>> Ordering;
+        for (int32 Variant = 0; Variant < 4; Variant++)
+        {
+            const bool AlignToSuccessors = (Variant & 1) != 0;
+            const bool RightToLeft = (Variant & 2) != 0;
+
+            Ordering = Layers;
+            if (AlignToSuccessors)
+            {
+                Algo::Reverse(Ordering);
+            }
+            if (RightToLeft)
+            {
+                for (TArray<int32>& LayerVertices : Ordering)
+                {
+                    Algo::Reverse(LayerVertices);
+                }
+            }
+
+            AlignAndCompact(Ordering, AlignToSuccessors ? Successors : Predecessors, Candidates[Variant]);
+
+            if (RightToLeft)
+            {
+                for (double& X : Candidates[Variant])
+                {
+                    X = -X;
+                }
+            }
+        }
+
+        // Shift every candidate to line up with the narrowest one, on the side it was compacted toward.
+        double MinX[4];
+        double MaxX[4];
+        int32 Narrowest = 0;
+        for (int32 Variant = 0; Variant < 4; Variant++)
+        {
+            MinX[Variant] = NumAll ? FMath::Min(Candidates[Variant]) : 0.0;
+            MaxX[Variant] = NumAll ? FMath::Max(Candidates[Variant]) : 0.0;
+            if (MaxX[Variant] - MinX[Variant] < MaxX[Narrowest] - MinX[Narrowest])
+            {
+                Narrowest = Variant;
+            }
+        }
+
+        for (int32 Variant = 0; Variant < 4; Variant++)
+        {
+            const bool RightToLeft = (Variant & 2) != 0;
+            const double Shift = RightToLeft ? MaxX[Narrowest] - MaxX[Variant] : MinX[Narrowest] - MinX[Variant];
+            for (double& X : Candidates[Variant])
+            {
+                X += Shift;
+            }
+        }
+
+        Coordinates.SetNumUninitialized(NumVertices);
+        for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+        {
+            double Sorted[4] = { Candidates[0][Vertex], Candidates[1][Vertex], Candidates[2][Vertex], Candidates[3][Vertex] };
+            Algo::Sort(Sorted);
+            Coordinates[Vertex] = (Sorted[1] + Sorted[2]) * 0.5;
+        }
+
+        if (!Coordinates.IsEmpty())
+        {
+            const double Offset = FMath::Min(Coordinates);
+            for (double& Coordinate : Coordinates)
+            {
+                Coordinate -= Offset;
+            }
+        }
+    }
+
+    void LayeredLayout::BreakCycles(const FGraphView Graph)
+    {
+        // Depth-first search, reversing edges that point back to a vertex still on the stack. What remains is acyclic.
+        enum : uint8 { Unvisited, Active, Finished };
+
+        TArray<uint8> State;
+        State.SetNumZeroed(NumVertices);
+
+        // Vertex, and the index of the next edge of it to follow.
+        TArray<TPair<int32, int32>> Stack;
+
+        for (int32 Root = 0; Root < NumVertices; Root++)
+        {
+            if (State[Root] != Unvisited)
+            {
+                continue;
+            }
+
+            State[Root] = Active;
+            Stack.Emplace(Root, 0);
+
+            while (!Stack.IsEmpty())
+            {
+                const int32 Vertex = Stack.Last().Key;
+                const TConstArrayView<int32> Adjacent = Graph[Vertex];
+
+                if (Stack.Last().Value == Adjacent.Num())
+                {
+                    State[Vertex] = Finished;
+                    Stack.Pop(EAllowShrinking::No);
+                    continue;
+                }
+
+                const int32 Target = Adjacent[Stack.Last().Value++];
+                if (Target == Vertex)
+                {
+                    continue;
+                }
+
+                if (State[Target] == Active)
+                {
+                    Edges.Emplace(Target, Vertex);
+                    continue;
+                }
+
+                Edges.Emplace(Vertex, Target);
+                if (State[Target] == Unvisited)
+                {
+                    State[Target] = Active;
+                    Stack.Emplace(Target, 0);
+                }
+            }
+        }
+
+        // Drop parallel edges, including those created by reversing one side of a two-vertex cycle.
+        Edges.Sort();
+        Edges.SetNum(Algo::Unique(Edges));
+    }
+
+    void LayeredLayout::AssignLayers()
+    {
+        // Edges are sorted by source, so the out edges of each vertex are contiguous.
+        TArray<int32> FirstEdge;
+        FirstEdge.SetNumZeroed(NumVertices + 1);
+        TArray<int32> InDegree;
+        InDegree.SetNumZeroed(NumVertices);
+        for (const TPair<int32, int32>& Edge : Edges)
+        {
+            FirstEdge[Edge.Key + 1]++;
+            InDegree[Edge.Value]++;
+        }
+        for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+        {
+            FirstEdge[Vertex + 1] += FirstEdge[Vertex];
+        }
+
+        TArray<int32> Order;
+        Order.Reserve(NumVertices);
+        for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+        {
+            if (InDegree[Vertex] == 0)
+            {
+                Order.Add(Vertex);
+            }
+        }
+        const int32 NumSources = Order.Num();
+
+        // Longest path layering: every vertex goes one layer past its deepest predecessor, in topological order.
+        Layer.SetNumZeroed(NumVertices);
+        for (int32 Head = 0; Head < Order.Num(); Head++)
+        {
+            const int32 Vertex = Order[Head];
+            for (int32 i = FirstEdge[Vertex]; i < FirstEdge[Vertex + 1]; i++)
+            {
+                const int32 Target = Edges[i].Value;
+                Layer[Target] = FMath::Max(Layer[Target], Layer[Vertex] + 1);
+                if (--InDegree[Target] == 0)
+                {
+                    Order.Add(Target);
+                }
+            }
+        }
+        check(Order.Num() == NumVertices);
+
+        // Longest path puts every source in the first layer. Move them down next to their closest successor instead,
+        // so they don't drag long edges across the layout.
+        for (int32 i = 0; i < NumSources; i++)
+        {
+            const int32 Source = Order[i];
+            if (FirstEdge[Source] == FirstEdge[Source + 1])
+            {
+                continue;
+            }
+
+            int32 ClosestLayer = MAX_int32;
+            for (int32 Edge = FirstEdge[Source]; Edge < FirstEdge[Source + 1]; Edge++)
+            {
+                ClosestLayer = FMath::Min(ClosestLayer, Layer[Edges[Edge].Value]);
+            }
+            Layer[Source] = ClosestLayer - 1;
+        }
+    }
+
+    void LayeredLayout::InsertDummies()
+    {
+        Predecessors.SetNum(NumVertices);
+        Successors.SetNum(NumVertices);
+
+        for (const TPair<int32, int32>& Edge : Edges)
+        {
+            int32 Previous = Edge.Key;
+            for (int32 DummyLayer = Layer[Edge.Key] + 1; DummyLayer < Layer[Edge.Value]; DummyLayer++)
+            {
+                const int32 Dummy = Layer.Add(DummyLayer);
+                Predecessors.AddDefaulted();
+                Successors.AddDefaulted();
+
+                Successors[Previous].Add(Dummy);
+                Predecessors[Dummy].Add(Previous);
+                Previous = Dummy;
+            }
+
+            Successors[Previous].Add(Edge.Value);
+            Predecessors[Edge.Value].Add(Previous);
+        }
+    }
+
+    void LayeredLayout::OrderLayers(const int32 CrossingSweeps)
+    {
+        const int32 NumAll = Layer.Num();
+
+        Layers.SetNum(NumAll ? FMath::Max(Layer) + 1 : 0);
+        Position.SetNumUninitialized(NumAll);
+        Barycenters.SetNumUninitialized(NumAll);
+
+        // Initial order from a depth-first search, which keeps connected vertices close together.
+        TBitArray<> Visited(false, NumAll);
+        TArray<int32> Stack;
+        for (int32 Root = 0; Root < NumVertices; Root++)
+        {
+            if (!Predecessors[Root].IsEmpty())
+            {
+                continue;
+            }
+
+            Stack.Add(Root);
+            while (!Stack.IsEmpty())
+            {
+                const int32 Vertex = Stack.Pop(EAllowShrinking::No);
+                if (Visited[Vertex])
+                {
+                    continue;
+                }
+
+                Visited[Vertex] = true;
+                Position[Vertex] = Layers[Layer[Vertex]].Add(Vertex);
+
+                for (int32 i = Successors[Vertex].Num() - 1; i >= 0; i--)
+                {
+                    if (!Visited[Successors[Vertex][i]])
+                    {
+                        Stack.Add(Successors[Vertex][i]);
+                    }
+                }
+            }
+        }
+
+        int64 BestCrossings = CountCrossings();
+        TArray<TArray<int32>> BestLayers = Layers;
+
+        for (int32 Sweep = 0; Sweep < CrossingSweeps && BestCrossings > 0; Sweep++)
+        {
+            // Alternate between ordering each layer by the one above it, and by the one below it.
+            if (Sweep % 2 == 0)
+            {
+                for (int32 i = 1; i < Layers.Num(); i++)
+                {
+                    SortByBarycenter(Layers[i], Predecessors);
+                }
+            }
+            else
+            {
+                for (int32 i = Layers.Num() - 2; i >= 0; i--)
+                {
+                    SortByBarycenter(Layers[i], Successors);
+                }
+            }
+
+            if (const int64 Crossings = CountCrossings();
+                Crossings < BestCrossings)
+            {
+                BestCrossings = Crossings;
+                BestLayers = Layers;
+            }
+        }
+
+        Layers = MoveTemp(BestLayers);
+        for (const TArray<int32>& LayerVertices : Layers)
+        {
+            for (int32 i = 0; i < LayerVertices.Num(); i++)
+            {
+                Position[LayerVertices[i]] = i;
+            }
+        }
+    }
+
+    void LayeredLayout::SortByBarycenter(TArray<int32>& LayerVertices, const TArray<TArray<int32>>& Neighbors)
+    {
+        // Vertices without neighbors on the other layer keep their current position.
+        for (const int32 Vertex : LayerVertices)
+        {
+            if (Neighbors[Vertex].IsEmpty())
+            {
+                Barycenters[Vertex] = Position[Vertex];
+                continue;
+            }
+
+            double Sum = 0.0;
+            for (const int32 Neighbor : Neighbors[Vertex])
+            {
+                Sum += Position[Neighbor];
+            }
+            Barycenters[Vertex] = Sum / Neighbors[Vertex].Num();
+        }
+
+        LayerVertices.StableSort(
+            [this](const int32 A, const int32 B)
+            {
+                return Barycenters[A] < Barycenters[B];
+            });
+
+        for (int32 i = 0; i < LayerVertices.Num(); i++)
+        {
+            Position[LayerVertices[i]] = i;
+        }
+    }
+
+    int64 LayeredLayout::CountCrossings() const
+    {
+        // Accumulator tree from Barth, Juenger & Mutzel, "Simple and Efficient Bilayer Cross Counting", 2002.
+        int64 Crossings = 0;
+        TArray<int32> Targets;
+        TArray<int32> Tree;
+
+        for (int32 i = 0; i + 1 < Layers.Num(); i++)
+        {
+            const int32 NumLower = Layers[i + 1].Num();
+
+            // Positions of edge targets, ordered by source position, then by target position.
+            Targets.Reset();
+            for (const int32 Vertex : Layers[i])
+            {
+                const int32 First = Targets.Num();
+                for (const int32 Successor : Successors[Vertex])
+                {
+                    Targets.Add(Position[Successor]);
+                }
+                Algo::Sort(MakeArrayView(Targets).Slice(First, Targets.Num() - First));
+            }
+
+            int32 FirstIndex = 1;
+            while (FirstIndex < NumLower)
+            {
+                FirstIndex *= 2;
+            }
+            Tree.Reset();
+            Tree.SetNumZeroed(2 * FirstIndex - 1);
+            FirstIndex -= 1;
+
+            // Every edge crosses the edges already inserted that end further right than it does.
+            for (const int32 Target : Targets)
+            {
+                int32 Index = Target + FirstIndex;
+                Tree[Index]++;
+                while (Index > 0)
+                {
+                    if (Index % 2)
+                    {
+                        Crossings += Tree[Index + 1];
+                    }
+                    Index = (Index - 1) / 2;
+                    Tree[Index]++;
+                }
+            }
+        }
+
+        return Crossings;
+    }
+
+    void LayeredLayout::MarkTypeOneConflicts()
+    {
+        // An inner segment is an edge between two dummies, ie: the middle of a long edge. Edges crossing one are marked,
+        // so alignment prefers keeping long edges straight over aligning short ones.
+        for (int32 i = 0; i + 1 < Layers.Num(); i++)
+        {
+            const TArray<int32>& Upper = Layers[i];
+            const TArray<int32>& Lower = Layers[i + 1];
+
+            int32 K0 = 0;
+            int32 Scan = 0;
+            for (int32 L1 = 0; L1 < Lower.Num(); L1++)
+            {
+                const int32 Vertex = Lower[L1];
+                const bool Inner = IsDummy(Vertex) && IsDummy(Predecessors[Vertex][0]);
+
+                if (L1 == Lower.Num() - 1 || Inner)
+                {
+                    const int32 K1 = Inner ? Position[Predecessors[Vertex][0]] : Upper.Num() - 1;
+
+                    for (; Scan <= L1; Scan++)
+                    {
+                        for (const int32 Predecessor : Predecessors[Lower[Scan]])
+                        {
+                            if (Position[Predecessor] < K0 || Position[Predecessor] > K1)
+                            {
+                                Conflicts.Add(EdgeKey(Predecessor, Lower[Scan]));
+                            }
+                        }
+                    }
+
+                    K0 = K1;
+                }
+            }
+        }
+    }
+
+    void LayeredLayout::AlignAndCompact(const TArray<TArray<int32>>& Ordering, const TArray<TArray<int32>>& Neighbors,
+                                        TArray<double>& OutX) const
+    {
+        const int32 NumAll = Layer.Num();
+
+        TArray<int32> OrderPosition;
+        OrderPosition.SetNumUninitialized(NumAll);
+        for (const TArray<int32>& LayerVertices : Ordering)
+        {
+            for (int32 i = 0; i < LayerVertices.Num(); i++)
+            {
+                OrderPosition[LayerVertices[i]] = i;
+            }
+        }
+
+        // Vertical alignment: each vertex joins the block of its median neighbor in the previous layer, unless that
+        // would cross an alignment already made in this layer, or a marked conflict.
+        TArray<int32> Root;
+        TArray<int32> Align;
+        Root.SetNumUninitialized(NumAll);
+        Align.SetNumUninitialized(NumAll);
+        for (int32 Vertex = 0; Vertex < NumAll; Vertex++)
+        {
+            Root[Vertex] = Vertex;
+            Align[Vertex] = Vertex;
+        }
+
+        TArray<int32> Sorted;
+        for (int32 i = 1; i < Ordering.Num(); i++)
+        {
+            int32 Reached = INDEX_NONE;
+            for (const int32 Vertex : Ordering[i])
+            {
+                Sorted = Neighbors[Vertex];
+                const int32 Degree = Sorted.Num();
+                if (Degree == 0)
+                {
+                    continue;
+                }
+
+                Algo::SortBy(Sorted, [&OrderPosition](const int32 Neighbor) { return OrderPosition[Neighbor]; });
+
+                // With an even number of neighbors, there are two medians to try.
+                for (int32 Median = (Degree - 1) / 2; Median <= Degree / 2; Median++)
+                {
+                    const int32 Neighbor = Sorted[Median];
+                    if (Align[Vertex] == Vertex &&
+                        Reached < OrderPosition[Neighbor] &&
+                        !Conflicts.Contains(EdgeKey(Neighbor, Vertex)))
+                    {
+                        Align[Neighbor] = Vertex;
+                        Root[Vertex] = Root[Neighbor];
+                        Align[Vertex] = Root[Vertex];
+                        Reached = OrderPosition[Neighbor];
+                    }
+                }
+            }
+        }
+
+        // Horizontal compaction: blocks form a graph, with an edge from each block to the next block to its right in
+        // any layer. Blocks are placed as far left as possible, then pulled right toward their neighbors where there
+        // is room, which avoids the class shifting of the original paper.
+        TArray<TPair<int32, int32>> BlockEdges;
+        for (const TArray<int32>& LayerVertices : Ordering)
+        {
+            for (int32 i = 1; i < LayerVertices.Num(); i++)
+            {
+                BlockEdges.Emplace(Root[LayerVertices[i - 1]], Root[LayerVertices[i]]);
+            }
+        }
+        BlockEdges.Sort();
+        BlockEdges.SetNum(Algo::Unique(BlockEdges));
+
+        TArray<int32> FirstEdge;
+        FirstEdge.SetNumZeroed(NumAll + 1);
+        TArray<int32> InDegree;
+        InDegree.SetNumZeroed(NumAll);
+        for (const TPair<int32, int32>& Edge : BlockEdges)
+        {
+            FirstEdge[Edge.Key + 1]++;
+            InDegree[Edge.Value]++;
+        }
+        for (int32 Vertex = 0; Vertex < NumAll; Vertex++)
+        {
+            FirstEdge[Vertex + 1] += FirstEdge[Vertex];
+        }
+
+        TArray<int32> Order;
+        for (int32 Vertex = 0; Vertex < NumAll; Vertex++)
+        {
+            if (Root[Vertex] == Vertex && InDegree[Vertex] == 0)
+            {
+                Order.Add(Vertex);
+            }
+        }
+        for (int32 Head = 0; Head < Order.Num(); Head++)
+        {
+            const int32 Block = Order[Head];
+            for (int32 i = FirstEdge[Block]; i < FirstEdge[Block + 1]; i++)
+            {
+                if (--InDegree[BlockEdges[i].Value] == 0)
+                {
+                    Order.Add(BlockEdges[i].Value);
+                }
+            }
+        }
+
+        TArray<double> BlockX;
+        BlockX.SetNumZeroed(NumAll);
+        for (const int32 Block : Order)
+        {
+            for (int32 i = FirstEdge[Block]; i < FirstEdge[Block + 1]; i++)
+            {
+                const int32 Next = BlockEdges[i].Value;
+                BlockX[Next] = FMath::Max(BlockX[Next], BlockX[Block] + 1.0);
+            }
+        }
+
+        for (int32 i = Order.Num() - 1; i >= 0; i--)
+        {
+            const int32 Block = Order[i];
+            if (FirstEdge[Block] == FirstEdge[Block + 1])
+            {
+                continue;
+            }
+
+            double Limit = TNumericLimits<double>::Max();
+            for (int32 Edge = FirstEdge[Block]; Edge < FirstEdge[Block + 1]; Edge++)
+            {
+                Limit = FMath::Min(Limit, BlockX[BlockEdges[Edge].Value] - 1.0);
+            }
+            BlockX[Block] = FMath::Max(BlockX[Block], Limit);
+        }
+
+        OutX.SetNumUninitialized(NumAll);
+        for (int32 Vertex = 0; Vertex < NumAll; Vertex++)
+        {
+            OutX[Vertex] = BlockX[Root[Vertex]];
+        }
+    }
+}
\ No newline at end of file
@@ -3,24 +3,58 @@
 #include "Algorithms/Nodesoup.h"
 #include "Algorithms/FruchtermanReingold.h"
 #include "Algorithms/KamadaKawai.h"
+#include "Algorithms/LayeredLayout.h"
 #include "Algorithms/Layout.h"
+#include "Algorithms/SparseStress.h"
 
 namespace Nodesoup
 {
+    FCompressedGraph::FCompressedGraph()
+    {
+        Offsets.Add(0);
+    }
+
+    FCompressedGraph::FCompressedGraph(const FTwoDimIntArray& AdjacencyList)
+    {
+        int32 NumEdges = 0;
+        for (const TArray<int32>& Adjacent : AdjacencyList)
+        {
+            NumEdges += Adjacent.Num();
+        }
+
+        Offsets.Reserve(AdjacencyList.Num() + 1);
+        Indices.Reserve(NumEdges);
+        Offsets.Add(0);
+
+        for (const TArray<int32>& Adjacent : AdjacencyList)
+        {
+            Indices.Append(Adjacent);
+            FinishVertex();
+        }
+    }
+
+    void FCompressedGraph::Reset()
+    {
+        Offsets.Reset();
+        Indices.Reset();
+        Offsets.Add(0);
+    }
+
     TArray<FVector2D> fruchterman_reingold(
         FGraphView Graph,
         const FGraphIterationCallback& Callback,
         const uint32 Width,
         const uint32 Height,
         const uint32 Iterations,
-        const double Strength)
+        const double Strength,
+        const FExecutionSettings& Execution)
     {
         TArray<FVector2D> Positions;
         Positions.SetNumZeroed(Graph.Num());
         // Initial layout on a circle
         Circle(Positions);
 
-        FruchtermanReingold fr(Graph, Strength);
+        FruchtermanReingold fr(Graph, Strength, ERepulsionMode::Exact, Execution);
 
         for (uint32 i = 0; i < Iterations; i++)
         {
@@ -40,19 +74,60 @@ namespace Nodesoup
         const uint32 Width,
         const uint32 Height,
         const double Strength,
-        const double EnergyThreshold)
+        const double EnergyThreshold,
+        const FExecutionSettings& Execution)
     {
         TArray<FVector2D> Positions;
         Positions.SetNumZeroed(Graph.Num());
         // Initial layout on a circle
         Circle(Positions);
-        const KamadaKawai kk(Graph, Strength, EnergyThreshold);
+        const KamadaKawai kk(Graph, Strength, EnergyThreshold, Execution);
         kk(Positions);
         CenterAndScale(Width, Height, Positions);
 
         return Positions;
     }
 
+    TArray<FVector2D> sparse_stress(
+        FGraphView Graph,
+        const uint32 Width,
+        const uint32 Height,
+        const int32 NumPivots,
+        const uint32 Iterations,
+        const FExecutionSettings& Execution)
+    {
+        TArray<FVector2D> Positions;
+        SparseStress ss(Graph, NumPivots, Execution);
+        ss.Initialize(Positions);
+
+        for (uint32 i = 0; i < Iterations; i++)
+        {
+            ss(Positions);
+        }
+
+        CenterAndScale(Width, Height, Positions);
+        return Positions;
+    }
+
+    TArray<FVector2D> layered(
+        FGraphView Graph,
+        const double LayerSpacing,
+        const double VertexSpacing,
+        const int32 CrossingSweeps)
+    {
+        TArray<FVector2D> Positions;
+        const LayeredLayout ll(Graph, CrossingSweeps);
+        ll(Positions);
+
+        for (FVector2D& Position : Positions)
+        {
+            Position.X *= LayerSpacing;
+            Position.Y *= VertexSpacing;
+        }
+
+        return Positions;
+    }
+
     TArray<double> SizeRadii(FGraphView Graph, const double MinRadius, const double Strength)
     {
         TArray<double> Radii;
@@ -65,4 +140,35 @@ namespace Nodesoup
         }
         return Radii;
     }
+
+PRAGMA_DISABLE_DEPRECATION_WARNINGS
+    TArray<FVector2D> fruchterman_reingold(
+        const FTwoDimIntArray& Graph,
+        const FGraphIterationCallback& Callback,
+        const uint32 Width,
+        const uint32 Height,
+        const uint32 Iterations,
+        const double Strength)
+    {
+        const FCompressedGraph Compressed(Graph);
+        return fruchterman_reingold(Compressed, Callback, Width, Height, Iterations, Strength);
+    }
+
+    TArray<FVector2D> kamada_kawai(
+        const FTwoDimIntArray& Graph,
+        const uint32 Width,
+        const uint32 Height,
+        const double Strength,
+        const double EnergyThreshold)
+    {
+        const FCompressedGraph Compressed(Graph);
+        return kamada_kawai(Compressed, Width, Height, Strength, EnergyThreshold);
+    }
+
+    TArray<double> SizeRadii(const FTwoDimIntArray& Graph, const double MinRadius, const double Strength)
+    {
+        const FCompressedGraph Compressed(Graph);
+        return SizeRadii(Compressed, MinRadius, Strength);
+    }
+PRAGMA_ENABLE_DEPRECATION_WARNINGS
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "Algorithms/SparseStress.h"
+#include "Async/ParallelFor.h"
+
+namespace Nodesoup
+{
+    SparseStress::SparseStress(FGraphView InGraph, const int32 NumPivots, const FExecutionSettings& InExecution)
+        : Graph(InGraph)
+        , Execution(InExecution)
+    {
+        SelectPivots(NumPivots);
+    }
+
+    void SparseStress::SelectPivots(const int32 NumPivots)
+    {
+        const int32 Num = Graph.Num();
+        if (Num == 0)
+        {
+            return;
+        }
+
+        // At least two pivots are needed for Pivot MDS to produce two dimensions.
+        const int32 PivotCount = FMath::Clamp(NumPivots, FMath::Min(2, Num), Num);
+
+        Pivots.Reserve(PivotCount);
+        PivotDistances.SetNumUninitialized(PivotCount * Num);
+
+        TArray<int32> MinDistance;
+        MinDistance.Init(MAX_int32, Num);
+        TArray<int32> Queue;
+
+        // Max-min selection: each new pivot is the vertex furthest from all previous pivots. Vertices that no pivot can
+        // reach count as infinitely far, so every connected component gets a pivot before any gets a second one.
+        int32 Next = 0;
+        for (int32 p = 0; p < PivotCount; p++)
+        {
+            Pivots.Add(Next);
+            const TArrayView<int32> Row(PivotDistances.GetData() + p * Num, Num);
+            BreadthFirstDistances(Graph, Next, Row, Queue);
+
+            int32 Furthest = INDEX_NONE;
+            for (int32 i = 0; i < Num; i++)
+            {
+                if (Row[i] != INDEX_NONE)
+                {
+                    MinDistance[i] = FMath::Min(MinDistance[i], Row[i]);
+                }
+
+                if (MinDistance[i] > 0 && (Furthest == INDEX_NONE || MinDistance[i] > MinDistance[Furthest]))
+                {
+                    Furthest = i;
+                }
+            }
+
+            if (Furthest == INDEX_NONE)
+            {
+                break;
+            }
+            Next = Furthest;
+        }
+
+        // Fewer pivots than requested if every vertex became one.
+        PivotDistances.SetNum(Pivots.Num() * Num);
+
+        RegionSizes.SetNumZeroed(Pivots.Num());
+        for (int32 i = 0; i < Num; i++)
+        {
+            int32 Closest = INDEX_NONE;
+            for (int32 p = 0; p < Pivots.Num(); p++)
+            {
+                const int32 Distance = PivotDistances[p * Num + i];
+                if (Distance != INDEX_NONE && (Closest == INDEX_NONE || Distance < PivotDistances[Closest * Num + i]))
+                {
+                    Closest = p;
+                }
+            }
+
+            if (Closest != INDEX_NONE)
+            {
+                RegionSizes[Closest]++;
+            }
+        }
+    }
+
+    void SparseStress::Initialize(TArray<FVector2D>& Positions) const
+    {
+        const int32 Num = Graph.Num();
+        const int32 K = Pivots.Num();
+        Positions.SetNumZeroed(Num);
+
+        if (K == 0)
+        {
+            return;
+        }
+
+        int32 BiggestDistance = 0;
+        for (const int32 Distance : PivotDistances)
+        {
+            BiggestDistance = FMath::Max(BiggestDistance, Distance);
+        }
+
+        // Double-centered squared distances between pivots and vertices.
+        TArray<double> C;
+        C.SetNumUninitialized(K * Num);
+        for (int32 Index = 0; Index < K * Num; Index++)
+        {
+            const int32 Distance = PivotDistances[Index] == INDEX_NONE ? BiggestDistance + 1 : PivotDistances[Index];
+            C[Index] = static_cast<double>(Distance) * Distance;
+        }
+
+        TArray<double> RowMeans;
+        RowMeans.SetNumZeroed(K);
+        TArray<double> ColumnMeans;
+        ColumnMeans.SetNumZeroed(Num);
+        double GrandMean = 0.0;
+
+        for (int32 p = 0; p < K; p++)
+        {
+            for (int32 i = 0; i < Num; i++)
+            {
+                RowMeans[p] += C[p * Num + i];
+                ColumnMeans[i] += C[p * Num + i];
+            }
+            GrandMean += RowMeans[p];
+            RowMeans[p] /= Num;
+        }
+        for (double& Mean : ColumnMeans)
+        {
+            Mean /= K;
+        }
+        GrandMean /= static_cast<double>(K) * Num;
+
+        for (int32 p = 0; p < K; p++)
+        {
+            for (int32 i = 0; i < Num; i++)
+            {
+                C[p * Num + i] = -0.5 * (C[p * Num + i] - RowMeans[p] - ColumnMeans[i] + GrandMean);
+            }
+        }
+
+        // The two largest eigenvectors of C*Ct (only k by k) give the axes that best preserve the pivot distances.
+        TArray<double> B;
+        B.SetNumZeroed(K * K);
+        ParallelFor(K,
+            [&](const int32 a)
+            {
+                for (int32 b = 0; b < K; b++)
+                {
+                    double Sum = 0.0;
+                    for (int32 i = 0; i < Num; i++)
+                    {
+                        Sum += C[a * Num + i] * C[b * Num + i];
+                    }
+                    B[a * K + b] = Sum;
+                }
+            },
+            Execution.NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+        auto PowerIteration = [&B, K](TArray<double>& Vector)
+            {
+                TArray<double> Temp;
+                Temp.SetNumUninitialized(K);
+                double Eigenvalue = 0.0;
+
+                for (int32 Iteration = 0; Iteration < 100; Iteration++)
+                {
+                    for (int32 a = 0; a < K; a++)
+                    {
+                        double Sum = 0.0;
+                        for (int32 b = 0; b < K; b++)
+                        {
+                            Sum += B[a * K + b] * Vector[b];
+                        }
+                        Temp[a] = Sum;
+                    }
+
+                    double Length = 0.0;
+                    for (const double Value : Temp)
+                    {
+                        Length += Value * Value;
+                    }
+                    Length = FMath::Sqrt(Length);
+                    if (FMath::IsNearlyZero(Length))
+                    {
+                        break;
+                    }
+
+                    for (int32 a = 0; a < K; a++)
+                    {
+                        Vector[a] = Temp[a] / Length;
+                    }
+
+                    if (FMath::IsNearlyEqual(Length, Eigenvalue, 1e-9 * Length))
+                    {
+                        break;
+                    }
+                    Eigenvalue = Length;
+                }
+
+                return Eigenvalue;
+            };
+
+        // Fixed, distinct starting vectors keep the result deterministic.
+        TArray<double> First;
+        TArray<double> Second;
+        First.SetNumUninitialized(K);
+        Second.SetNumUninitialized(K);
+        for (int32 a = 0; a < K; a++)
+        {
+            First[a] = 1.0 + a;
+            Second[a] = a % 2 ? -1.0 : 1.0;
+        }
+
+        const double FirstEigenvalue = PowerIteration(First);
+
+        // Deflate, so the second iteration converges on the next eigenvector.
+        for (int32 a = 0; a < K; a++)
+        {
+            for (int32 b = 0; b < K; b++)
+            {
+                B[a * K + b] -= FirstEigenvalue * First[a] * First[b];
+            }
+        }
+        PowerIteration(Second);
+
+        for (int32 i = 0; i < Num; i++)
+        {
+            for (int32 p = 0; p < K; p++)
+            {
+                Positions[i].X += C[p * Num + i] * First[p];
+                Positions[i].Y += C[p * Num + i] * Second[p];
+            }
+        }
+
+        // Normalize so distances are on the same scale as graph distances.
+        double Scale = 0.0;
+        int32 Samples = 0;
+        for (int32 i = 0; i < Num; i++)
+        {
+            for (const int32 Adjacent : Graph.Neighbors(i))
+            {
+                Scale += FVector2D::Distance(Positions[i], Positions[Adjacent]);
+                Samples++;
+            }
+        }
+        if (Samples > 0 && !FMath::IsNearlyZero(Scale))
+        {
+            Scale = Samples / Scale;
+            for (FVector2D& Position : Positions)
+            {
+                Position *= Scale;
+            }
+        }
+    }
+
+    void SparseStress::operator()(TArray<FVector2D>& Positions)
+    {
+        const int32 Num = Graph.Num();
+        NextPositions.SetNumUninitialized(Num, EAllowShrinking::No);
+
+        const int32 NumTasks = FMath::Clamp(Execution.NumTasks, 1, FMath::Max(Num, 1));
+        const int32 ChunkSize = FMath::DivideAndRoundUp(Num, NumTasks);
+
+        // Each vertex moves to the weighted average of where each of its springs would like it to be. New positions are
+        // written to a separate buffer, so vertices can be processed in any order, and results don't depend on tasks.
+        ParallelFor(NumTasks,
+            [&](const int32 Task)
+            {
+                const int32 End = FMath::Min((Task + 1) * ChunkSize, Num);
+                for (int32 i = Task * ChunkSize; i < End; i++)
+                {
+                    FVector2D Sum = FVector2D::ZeroVector;
+                    double WeightSum = 0.0;
+
+                    auto AddSpring = [&](const int32 Other, const double Length, const double Weight)
+                        {
+                            const FVector2D Delta = Positions[i] - Positions[Other];
+                            const double Distance = Delta.Size();
+                            FVector2D Target = Positions[Other];
+                            if (!FMath::IsNearlyZero(Distance))
+                            {
+                                Target += Delta * (Length / Distance);
+                            }
+                            Sum += Target * Weight;
+                            WeightSum += Weight;
+                        };
+
+                    for (const int32 Adjacent : Graph.Neighbors(i))
+                    {
+                        AddSpring(Adjacent, 1.0, 1.0);
+                    }
+
+                    for (int32 p = 0; p < Pivots.Num(); p++)
+                    {
+                        // Neighbors and the pivot itself are already handled, or meaningless.
+                        const int32 Distance = PivotDistances[p * Num + i];
+                        if (Distance > 1)
+                        {
+                            AddSpring(Pivots[p], Distance, RegionSizes[p] / (static_cast<double>(Distance) * Distance));
+                        }
+                    }
+
+                    NextPositions[i] = WeightSum > 0.0 ? Sum / WeightSum : Positions[i];
+                }
+            },
+            NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+        Swap(Positions, NextPositions);
+    }
+}
@@ -5,6 +5,7 @@
 #include "Input/HeartInputHandlerAssetBase.h"
 #include "Input/HeartInputBindingAsset.h"
 
+#include "Algo/BinarySearch.h"
 #include "HeartCorePrivate.h"
 #include "Input/HeartInputActivation.h"
 #include "Input/HeartEvent.h"
@@ -19,25 +20,21 @@ using namespace Heart::Input;
 
 FCallbackQuery::FCallbackQuery(const UHeartInputLinkerBase* Linker, const FInputTrip& Trip)
 {
-	Linker->InputCallbackMappings.MultiFindPointer(Trip, Callbacks);
+	if (auto&& Found = Linker->InputCallbackMappings.Find(Trip))
+	{
+		Callbacks = *Found;
+	}
 }
 
 FCallbackQuery& FCallbackQuery::Sort()
 {
-	Algo::Sort(Callbacks,
-		[](const FSortableCallback* A, const FSortableCallback* B)
-		{
-			return *A < *B;
-		});
 	return *this;
 }
 
 FCallbackQuery& FCallbackQuery::ForEachWithBreak(const UObject* Target, const TFunctionRef<bool(const FSortableCallback&)>& Predicate)
 {
-	for (auto&& CallbackPtr : Callbacks)
+	for (auto&& Ref : Callbacks)
 	{
-		const FSortableCallback& Ref = *CallbackPtr;
-
 		if (!IsValid(Ref.Handler))
 		{
 			continue;
@@ -64,9 +61,12 @@ void UHeartInputLinkerBase::AddReferencedObjects(UObject* InThis, FReferenceColl
 
 	for (auto&& Element : This->InputCallbackMappings)
 	{
-		if (!Element.Value.Handler->IsAsset())
+		for (auto&& Callback : Element.Value)
 		{
-			Collector.AddReferencedObject(const_cast<FSortableCallback*>(&Element.Value)->Handler, This);
+			if (!Callback.Handler->IsAsset())
+			{
+				Collector.AddReferencedObject(const_cast<FSortableCallback&>(Callback).Handler, This);
+			}
 		}
 	}
 }
@@ -108,7 +108,10 @@ void UHeartInputLinkerBase::BindInputCallback(const FInputTrip& Trip, const FSor
 {
 	if (ensure(Trip.IsValid()))
 	{
-		InputCallbackMappings.Add(Trip, InputCallback);
+		// Insert after all callbacks of the same or higher priority, which keeps the list sorted, and ties in bind order.
+		TArray<FSortableCallback>& Callbacks = InputCallbackMappings.FindOrAdd(Trip);
+		const int32 Index = Algo::UpperBound(Callbacks, InputCallback);
+		Callbacks.Insert(InputCallback, Index);
 	}
 }
 
@@ -133,25 +136,28 @@ TArray<FHeartManualInputQueryResult> UHeartInputLinkerBase::QueryManualTriggers(
 {
 	TArray<FHeartManualInputQueryResult> Results;
 
-	for (auto&& ConditionalInputCallback : InputCallbackMappings)
+	for (auto&& ConditionalInputCallbacks : InputCallbackMappings)
 	{
-		const UHeartInputHandlerAssetBase* Handler = ConditionalInputCallback.Value.Handler;
-		if (!IsValid(Handler))
+		if (ConditionalInputCallbacks.Key.Type != Manual)
 		{
 			continue;
 		}
 
-		if (ConditionalInputCallback.Key.Type != Manual)
+		for (auto&& Callback : ConditionalInputCallbacks.Value)
 		{
-			continue;
-		}
+			const UHeartInputHandlerAssetBase* Handler = Callback.Handler;
+			if (!IsValid(Handler))
+			{
+				continue;
+			}
 
-		if (!Handler->PassCondition(Target))
-		{
-			continue;
-		}
+			if (!Handler->PassCondition(Target))
+			{
+				continue;
+			}
 
-		Results.Add({ConditionalInputCallback.Key.CustomKey, Handler->GetDescription(Target)});
+			Results.Add({ConditionalInputCallbacks.Key.CustomKey, Handler->GetDescription(Target)});
+		}
 	}
 
 	return Results;
@@ -159,7 +165,7 @@ TArray<FHeartManualInputQueryResult> UHeartInputLinkerBase::QueryManualTriggers(
 
 FCallbackQuery UHeartInputLinkerBase::Query(const FInputTrip& Trip) const
 {
-	return FCallbackQuery(this, Trip).Sort();
+	return FCallbackQuery(this, Trip);
 }
 
 void UHeartInputLinkerBase::AddBindings(const TArray<FHeartBoundInput>& Bindings)
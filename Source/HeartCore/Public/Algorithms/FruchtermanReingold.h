@@ -6,18 +6,66 @@
 
 namespace Nodesoup
 {
+    enum class ERepulsionMode : uint8
+    {
+        // Test every pair of vertices. O(N²) per iteration.
+        Exact,
+
+        // Bucket vertices into a uniform grid, and only test vertices in neighboring cells. An approximation, as
+        // vertices beyond RepulsionCutoff of each other are never tested.
+        SpatialGrid
+    };
+
     class HEARTCORE_API FruchtermanReingold
     {
     public:
-        FruchtermanReingold(FGraphView InGraph, double InStrength = 15.0);
+        FruchtermanReingold(FGraphView InGraph, double InStrength = 15.0, ERepulsionMode InRepulsionMode = ERepulsionMode::Exact,
+            const FExecutionSettings& InExecution = FExecutionSettings());
 
         void operator()(TArray<FVector2D>& Positions);
 
+        // Swaps in an updated graph, keeping the current temperature and movements, so an ongoing layout isn't reset
+        // when the graph changes. Vertices added past the end of the old graph start at rest.
+        void SetGraph(FGraphView InGraph);
+
+        // Vertices further apart than this do not repel each other. Also used as the cell size in SpatialGrid mode.
+        static constexpr double RepulsionCutoff = 1000.0;
+
     private:
+        // Positions and movements split into separate X/Y arrays, so the inner repulsion loops can be vectorized.
+        template <typename T>
+        struct TForceBuffers
+        {
+            TArray<T> X;
+            TArray<T> Y;
+
+            // Movements accumulated by each task. These are summed in task order, so results don't depend on scheduling.
+            TArray<TArray<T>> TaskMovementsX;
+            TArray<TArray<T>> TaskMovementsY;
+        };
+
+        void RepulseExact(TConstArrayView<FVector2D> Positions);
+        void RepulseSpatialGrid(TConstArrayView<FVector2D> Positions);
+        void Repulse(int32 Node, int32 Adj, TConstArrayView<FVector2D> Positions);
+
+        template <typename T>
+        void RepulseParallel(TConstArrayView<FVector2D> Positions, TForceBuffers<T>& Buffers);
+
+        void BuildSpatialGrid(TConstArrayView<FVector2D> Positions);
+
         FGraphView Graph;
         const double Strength;
         const double StrengthSqr;
+        const ERepulsionMode RepulsionMode;
+        const FExecutionSettings Execution;
         double Temperature;
         TArray<FVector2D> Movements;
+
+        // Spatial grid buckets, as the head of a linked list of vertices per cell. Kept to avoid reallocating each iteration.
+        TMap<FIntPoint, int32> CellHeads;
+        TArray<int32> CellNext;
+
+        TForceBuffers<float> FloatBuffers;
+        TForceBuffers<double> DoubleBuffers;
     };
 }
\ No newline at end of file
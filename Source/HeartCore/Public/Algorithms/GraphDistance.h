@@ -0,0 +1,32 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Nodesoup.h"
+
+namespace Nodesoup
+{
+    /** Compressed copy of an adjacency list with every edge stored in both directions, for fast traversal */
+    class HEARTCORE_API FUndirectedGraph
+    {
+    public:
+        explicit FUndirectedGraph(FGraphView Graph);
+
+        int32 Num() const { return Offsets.Num() - 1; }
+
+        TConstArrayView<int32> Neighbors(const int32 Vertex) const
+        {
+            return TConstArrayView<int32>(Indices.GetData() + Offsets[Vertex], Offsets[Vertex + 1] - Offsets[Vertex]);
+        }
+
+    private:
+        TArray<int32> Offsets;
+        TArray<int32> Indices;
+    };
+
+    /**
+     * Finds the number of edges on the shortest path from Source to every vertex. Unreachable vertices are INDEX_NONE.
+     * Queue is scratch space, passed in so repeated searches don't reallocate it.
+     */
+    HEARTCORE_API void BreadthFirstDistances(const FUndirectedGraph& Graph, int32 Source, TArrayView<int32> OutDistances, TArray<int32>& Queue);
+}
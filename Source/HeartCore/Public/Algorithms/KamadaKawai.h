@@ -7,13 +7,23 @@
 namespace Nodesoup
 {
     // https://gist.github.com/terakun/b7eff90c889c1485898ec9256ca9f91d
-    class KamadaKawai
+    class HEARTCORE_API KamadaKawai
     {
     public:
-        KamadaKawai(FGraphView InGraph, double Strength = 300.0, double InEnergyThreshold = 1e-2);
+        // Springs are stored for every pair of vertices, so memory grows with the square of the vertex count: this many
+        // vertices already hold 256 MiB of springs. Larger graphs are rejected, and should use SparseStress instead.
+        static constexpr int32 MaxVertices = 4096;
+
+        static bool CanLayout(const int32 NumVertices) { return NumVertices <= MaxVertices; }
+
+        KamadaKawai(FGraphView InGraph, double Strength = 300.0, double InEnergyThreshold = 1e-2,
+            const FExecutionSettings& InExecution = FExecutionSettings());
 
         void operator()(TArray<FVector2D>& Positions) const;
 
+        // Overload that reports progress after each vertex is relaxed.
+        void operator()(TArray<FVector2D>& Positions, const FGraphProgressCallback& Progress) const;
+
     private:
         struct FSpring
         {
@@ -23,9 +33,15 @@ namespace Nodesoup
 
         FGraphView Graph;
         const double EnergyThreshold;
-        TArray<TArray<FSpring>> Springs;
+        const FExecutionSettings Execution;
 
-        static FTwoDimIntArray FloydWarshall(FGraphView Graph);
+        // Springs between every pair of vertices, flattened into rows of Graph.Num(). Empty if the graph is too large.
+        TArray<FSpring, FDefaultAllocator64> Springs;
+
+        FORCEINLINE const FSpring& GetSpring(const int32 A, const int32 B) const
+        {
+            return Springs[static_cast<int64>(A) * Graph.Num() + B];
+        }
 
         double FindMaxVertexEnergy(TConstArrayView<FVector2D> Positions, int32& MaxEnergyVertex) const;
 
@@ -0,0 +1,68 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Nodesoup.h"
+
+namespace Nodesoup
+{
+    /**
+     * Layered layout for directed graphs (Sugiyama, Tagawa & Toda, 1981). Cycles are broken by reversing back edges,
+     * vertices are assigned to layers with longest-path layering, ordered within each layer by barycentric sweeps to
+     * reduce crossings, and given coordinates with Brandes & Koepf's "Fast and Simple Horizontal Coordinate Assignment".
+     * Deterministic, and close to linear in the number of edges, aside from the crossing minimization sweeps.
+     */
+    class HEARTCORE_API LayeredLayout
+    {
+    public:
+        LayeredLayout(FGraphView Graph, int32 CrossingSweeps = 24);
+
+        /** Writes the layer of each vertex to X, and its coordinate within the layer to Y, both in whole units */
+        void operator()(TArray<FVector2D>& Positions) const;
+
+        int32 NumLayers() const { return Layers.Num(); }
+
+    private:
+        void BreakCycles(FGraphView Graph);
+        void AssignLayers();
+        void InsertDummies();
+        void OrderLayers(int32 CrossingSweeps);
+        void SortByBarycenter(TArray<int32>& LayerVertices, const TArray<TArray<int32>>& Neighbors);
+        int64 CountCrossings() const;
+        void MarkTypeOneConflicts();
+        void AssignCoordinates();
+        void AlignAndCompact(const TArray<TArray<int32>>& Ordering, const TArray<TArray<int32>>& Neighbors, TArray<double>& OutX) const;
+
+        bool IsDummy(const int32 Vertex) const { return Vertex >= NumVertices; }
+
+        static uint64 EdgeKey(const int32 A, const int32 B)
+        {
+            return static_cast<uint64>(FMath::Min(A, B)) << 32 | static_cast<uint32>(FMath::Max(A, B));
+        }
+
+        // Number of vertices in the input graph. Dummy vertices splitting long edges are numbered after these.
+        const int32 NumVertices;
+
+        // Edges of the input graph with cycles broken, sorted and without duplicates.
+        TArray<TPair<int32, int32>> Edges;
+
+        // Layer of every vertex, including dummies.
+        TArray<int32> Layer;
+
+        // Edges after long edges have been split, so every edge connects adjacent layers.
+        TArray<TArray<int32>> Predecessors;
+        TArray<TArray<int32>> Successors;
+
+        // Vertices of each layer, in order, and the index of each vertex in its layer.
+        TArray<TArray<int32>> Layers;
+        TArray<int32> Position;
+
+        // Scratch space for crossing minimization.
+        TArray<double> Barycenters;
+
+        // Edges crossing an inner segment between two dummies, which are not allowed to be aligned.
+        TSet<uint64> Conflicts;
+
+        TArray<double> Coordinates;
+    };
+}
\ No newline at end of file
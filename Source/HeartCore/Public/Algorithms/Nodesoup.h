@@ -8,12 +8,69 @@ namespace Nodesoup
 
     using FTwoDimIntArray = TArray<TArray<int32>>;
 
-    using FGraphView = const FTwoDimIntArray&;
+    /**
+     * Adjacency list in compressed sparse row form. The vertices adjacent to vertex V are stored in
+     * Indices[Offsets[V]] up to Indices[Offsets[V + 1]], so the whole graph lives in two flat arrays.
+     */
+    struct HEARTCORE_API FCompressedGraph
+    {
+        FCompressedGraph();
+        explicit FCompressedGraph(const FTwoDimIntArray& AdjacencyList);
+
+        int32 Num() const { return Offsets.Num() - 1; }
+
+        /** Clears the graph, keeping allocations for reuse */
+        void Reset();
+
+        /** Appends a vertex, whose adjacent vertices are pushed to Indices before the next call. */
+        void FinishVertex() { Offsets.Add(Indices.Num()); }
+
+        TArray<int32> Offsets;
+        TArray<int32> Indices;
+    };
+
+    /** Non-owning view of a compressed graph, as consumed by the layout algorithms */
+    class FGraphView
+    {
+    public:
+        FGraphView(const FCompressedGraph& Graph)
+          : Offsets(Graph.Offsets)
+          , Indices(Graph.Indices) {}
+
+        // Views must not outlive the graph they point into.
+        FGraphView(const FCompressedGraph&&) = delete;
+
+        int32 Num() const { return FMath::Max(Offsets.Num() - 1, 0); }
+
+        TConstArrayView<int32> operator[](const int32 Vertex) const
+        {
+            return TConstArrayView<int32>(Indices.GetData() + Offsets[Vertex], Offsets[Vertex + 1] - Offsets[Vertex]);
+        }
+
+    private:
+        TConstArrayView<int32> Offsets;
+        TConstArrayView<int32> Indices;
+    };
+
+    /** Options for how the work of a layout iteration is executed */
+    struct FExecutionSettings
+    {
+        // Number of tasks to split vertices across. Results are deterministic for a given number of tasks, regardless
+        // of how the tasks are scheduled.
+        int32 NumTasks = 1;
+
+        // Accumulate repulsion forces in single precision. Halves the memory bandwidth of the inner loops, at the cost of
+        // accuracy. Only used by Fruchterman-Reingold.
+        bool SinglePrecision = false;
+    };
 
     /** Main library functions */
 
     using FGraphIterationCallback = TFunctionRef<void(TConstArrayView<FVector2D>, int32)>;
 
+    /** Called as a long-running layout progresses. Return false to stop early. */
+    using FGraphProgressCallback = TFunctionRef<bool(TConstArrayView<FVector2D>)>;
+
     /**
      * Applies the Freuchterman-Reingold algorithm to layout graph @p in a frame of dimensions
      * @p width and @p height, in @p iter-count iterations
@@ -24,15 +81,61 @@ namespace Nodesoup
         uint32 Width,
         uint32 Height,
         uint32 Iterations = 300,
-        double Strength = 15.0);
+        double Strength = 15.0,
+        const FExecutionSettings& Execution = FExecutionSettings());
 
     HEARTCORE_API TArray<FVector2D> kamada_kawai(
         FGraphView Graph,
         uint32 Width,
         uint32 Height,
         double Strength = 300.0,
-        double EnergyThreshold = 1e-2);
+        double EnergyThreshold = 1e-2,
+        const FExecutionSettings& Execution = FExecutionSettings());
+
+    /**
+     * Applies pivot-based sparse stress majorization to layout graph @p in a frame of dimensions
+     * @p width and @p height, in @p iter-count iterations
+     */
+    HEARTCORE_API TArray<FVector2D> sparse_stress(
+        FGraphView Graph,
+        uint32 Width,
+        uint32 Height,
+        int32 NumPivots = 50,
+        uint32 Iterations = 100,
+        const FExecutionSettings& Execution = FExecutionSettings());
+
+    /**
+     * Applies a layered layout to directed graph @p, with layers @p LayerSpacing apart along X, and vertices within a
+     * layer @p VertexSpacing apart along Y
+     */
+    HEARTCORE_API TArray<FVector2D> layered(
+        FGraphView Graph,
+        double LayerSpacing,
+        double VertexSpacing,
+        int32 CrossingSweeps = 24);
 
     /** Assigns diameters to vertices based on their degree */
     HEARTCORE_API TArray<double> SizeRadii(FGraphView Graph, double MinRadius = 4.0, double Strength = 300.0);
+
+    /** Adjacency list overloads, which compress the graph on every call */
+
+    UE_DEPRECATED(5.5, "Pass an FCompressedGraph instead")
+    HEARTCORE_API TArray<FVector2D> fruchterman_reingold(
+        const FTwoDimIntArray& Graph,
+        const FGraphIterationCallback& Callback,
+        uint32 Width,
+        uint32 Height,
+        uint32 Iterations = 300,
+        double Strength = 15.0);
+
+    UE_DEPRECATED(5.5, "Pass an FCompressedGraph instead")
+    HEARTCORE_API TArray<FVector2D> kamada_kawai(
+        const FTwoDimIntArray& Graph,
+        uint32 Width,
+        uint32 Height,
+        double Strength = 300.0,
+        double EnergyThreshold = 1e-2);
+
+    UE_DEPRECATED(5.5, "Pass an FCompressedGraph instead")
+    HEARTCORE_API TArray<double> SizeRadii(const FTwoDimIntArray& Graph, double MinRadius = 4.0, double Strength = 300.0);
 }
\ No newline at end of file
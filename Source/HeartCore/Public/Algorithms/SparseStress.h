@@ -0,0 +1,42 @@
+// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "GraphDistance.h"
+
+namespace Nodesoup
+{
+    /**
+     * Pivot-based sparse stress majorization (Ortmann, Klimenta & Brandes, "A Sparse Stress Model", 2016).
+     * Rather than springs between every pair of vertices like Kamada-Kawai, each vertex keeps springs to its neighbors
+     * and to a small set of pivots, which stand in for the rest of the graph. Memory is O(N*k), and each iteration is
+     * O(E + N*k).
+     */
+    class HEARTCORE_API SparseStress
+    {
+    public:
+        SparseStress(FGraphView InGraph, int32 NumPivots = 50, const FExecutionSettings& InExecution = FExecutionSettings());
+
+        /** Place vertices using Pivot MDS, which is a good starting point for the stress iterations */
+        void Initialize(TArray<FVector2D>& Positions) const;
+
+        /** Run one iteration of stress majorization */
+        void operator()(TArray<FVector2D>& Positions);
+
+    private:
+        void SelectPivots(int32 NumPivots);
+
+        const FUndirectedGraph Graph;
+        const FExecutionSettings Execution;
+
+        TArray<int32> Pivots;
+
+        // Distance from each pivot to every vertex, flattened into rows of Graph.Num(). Unreachable is INDEX_NONE.
+        TArray<int32> PivotDistances;
+
+        // Number of vertices closer to each pivot than to any other. Pivots standing in for more vertices pull harder.
+        TArray<int32> RegionSizes;
+
+        TArray<FVector2D> NextPositions;
+    };
+}
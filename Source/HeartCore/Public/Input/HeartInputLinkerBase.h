@@ -31,12 +31,13 @@ namespace Heart::Input
 	public:
 		FCallbackQuery(const UHeartInputLinkerBase* Linker, const FInputTrip& Trip);
 
+		// Callbacks are stored pre-sorted by priority, so this is a no-op, kept for existing callers.
 		FCallbackQuery& Sort();
 
 		FCallbackQuery& ForEachWithBreak(const UObject* Target, const TFunctionRef<bool(const FSortableCallback&)>& Predicate);
 
 	private:
-		TArray<const FSortableCallback*> Callbacks;
+		TConstArrayView<FSortableCallback> Callbacks;
 	};
 }
 
@@ -70,8 +71,9 @@ public:
 	void RemoveBindings(const TArray<FHeartBoundInput>& Bindings);
 
 protected:
-	// Input trips that fire a delegate.
-	TMultiMap<Heart::Input::FInputTrip, const Heart::Input::FSortableCallback> InputCallbackMappings;
+	// Input trips that fire a delegate. Each trip's callbacks are kept sorted by priority as they are bound, so
+	// dispatching an input is a single lookup, without allocating or sorting.
+	TMap<Heart::Input::FInputTrip, TArray<Heart::Input::FSortableCallback>> InputCallbackMappings;
 };
 
 namespace Heart::Input
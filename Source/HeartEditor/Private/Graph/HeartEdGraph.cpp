@@ -67,9 +67,8 @@ void UHeartEdGraph::PostInitProperties()
 	{
 		UHeartGraph* HeartGraph = GetHeartGraph();
 
-		HeartGraph->GetOnNodeAdded().AddUObject(this, &ThisClass::OnNodeAdded);
-		HeartGraph->GetOnNodeRemoved().AddUObject(this, &ThisClass::OnNodeRemoved);
-		HeartGraph->GetOnNodeConnectionsChanged().AddUObject(this, &ThisClass::OnNodeConnectionsChanged);
+		// Listen for batches, so bulk edits resync the EdGraph once, instead of once per node.
+		HeartGraph->GetOnBatchEvent().AddUObject(this, &ThisClass::OnGraphBatch);
 	}
 }
 
@@ -186,14 +185,14 @@ void UHeartEdGraph::CreateSlateInputLinker()
 	SlateInputLinker->AddBindings({DebugInput});
 }
 
-void UHeartEdGraph::CreateEdGraphNode(UHeartGraphNode* Node)
+UHeartEdGraphNode* UHeartEdGraph::CreateEdGraphNode(UHeartGraphNode* Node)
 {
 	Modify();
 
 	auto&& HeartGraph = GetHeartGraph();
 	HeartGraph->Modify();
 
-	if (!ensure(GEditor)) return;
+	if (!ensure(GEditor)) return nullptr;
 
 	const TSubclassOf<UHeartEdGraphNode> EdGraphNodeClass = GEditor->GetEditorSubsystem<UHeartRegistryEditorSubsystem>()->GetAssignedEdGraphNodeClass(Node->GetClass());
 
@@ -212,71 +211,137 @@ void UHeartEdGraph::CreateEdGraphNode(UHeartGraphNode* Node)
 	// Since we live in the HeartGraph, mark it as having changed.
 	HeartGraph->PostEditChange();
 	HeartGraph->MarkPackageDirty();
+
+	return NewEdGraphNode;
 }
 
-void UHeartEdGraph::OnNodeAdded(UHeartGraphNode* HeartGraphNode)
+void UHeartEdGraph::OnGraphBatch(const FHeartGraphBatchEvent& BatchEvent)
 {
-	if (IsValid(HeartGraphNode))
+	// Map the EdGraph nodes once, instead of searching them for every node and link in the batch.
+	TMap<FHeartNodeGuid, UHeartEdGraphNode*> EdNodes;
+	EdNodes.Reserve(Nodes.Num());
+	for (UEdGraphNode* Element : Nodes)
 	{
-		if (auto&& EdGraphNode = FindEdGraphNodeForNode(HeartGraphNode))
+		if (UHeartEdGraphNode* HeartEdGraphNode = Cast<UHeartEdGraphNode>(Element))
 		{
-			AddNode(EdGraphNode);
+			if (const UHeartGraphNode* HeartGraphNode = HeartEdGraphNode->GetHeartGraphNode();
+				IsValid(HeartGraphNode))
+			{
+				EdNodes.Add(HeartGraphNode->GetGuid(), HeartEdGraphNode);
+			}
 		}
-		else
+	}
+
+	for (const UHeartGraphNode* HeartGraphNode : BatchEvent.Removed.AffectedNodes)
+	{
+		if (IsValid(HeartGraphNode))
 		{
-			CreateEdGraphNode(HeartGraphNode);
+			UHeartEdGraphNode* EdGraphNode = nullptr;
+			if (EdNodes.RemoveAndCopyValue(HeartGraphNode->GetGuid(), EdGraphNode))
+			{
+				EdGraphNode->DestroyNode();
+			}
 		}
 	}
-}
 
-void UHeartEdGraph::OnNodeRemoved(UHeartGraphNode* HeartGraphNode)
-{
-	if (IsValid(HeartGraphNode))
+	const UHeartGraph* HeartGraph = GetHeartGraph();
+
+	for (const FHeartNodeGuid& NodeGuid : BatchEvent.Added.NewNodes)
 	{
-		if (auto&& EdGraphNode = FindEdGraphNodeForNode(HeartGraphNode))
+		UHeartGraphNode* HeartGraphNode = HeartGraph->GetNode(NodeGuid);
+		if (!IsValid(HeartGraphNode))
 		{
-			EdGraphNode->DestroyNode();
+			continue;
 		}
-	}
-}
 
-void UHeartEdGraph::OnNodeConnectionsChanged(const FHeartGraphConnectionEvent& HeartGraphConnectionEvent)
-{
-	// @todo this needs to be more robust, and not break with bulk ConnectionEvents
+		if (UHeartEdGraphNode* EdGraphNode = EdNodes.FindRef(NodeGuid))
+		{
+			AddNode(EdGraphNode);
+		}
+		else if (UHeartEdGraphNode* NewEdGraphNode = CreateEdGraphNode(HeartGraphNode))
+		{
+			EdNodes.Add(NodeGuid, NewEdGraphNode);
+		}
+	}
 
-	if (HeartGraphConnectionEvent.AffectedNodes.Num() != 2 ||
-		HeartGraphConnectionEvent.AffectedPins.Num() != 2)
+	if (!BatchEvent.Connections.AffectedNodes.IsEmpty())
 	{
-		return;
+		ResyncConnections(BatchEvent.Connections, EdNodes);
 	}
+}
 
-	const UHeartGraphNode* NodeA = HeartGraphConnectionEvent.AffectedNodes.Get(FSetElementId::FromInteger(0));
-	const UHeartGraphNode* NodeB = HeartGraphConnectionEvent.AffectedNodes.Get(FSetElementId::FromInteger(1));
-	const UEdGraphNode* EdNodeA = FindEdGraphNodeForNode(NodeA);
-	const UEdGraphNode* EdNodeB = FindEdGraphNodeForNode(NodeB);
-	const FHeartPinGuid PinAGuid = HeartGraphConnectionEvent.AffectedPins.Get(FSetElementId::FromInteger(0));
-	const FHeartPinGuid PinBGuid = HeartGraphConnectionEvent.AffectedPins.Get(FSetElementId::FromInteger(1));
+void UHeartEdGraph::ResyncConnections(const FHeartGraphConnectionEvent& HeartGraphConnectionEvent,
+									  const TMap<FHeartNodeGuid, UHeartEdGraphNode*>& EdNodes)
+{
+	// Connection events may be coalesced from a batch, in which case they don't say which pins were linked to which.
+	// Instead, the links of every affected pin are resynced against the Heart model.
+	const UHeartGraph* HeartGraph = GetHeartGraph();
 
-	if (EdNodeA && EdNodeB)
-	{
-		auto&& EdGraphPinA = EdNodeA->FindPin(NodeA->GetPinDescChecked(PinAGuid).Name);
-		auto&& EdGraphPinB = EdNodeB->FindPin(NodeB->GetPinDescChecked(PinBGuid).Name);
+	auto ByAffected = [&HeartGraphConnectionEvent](const FHeartPinGuid Pin)
+		{
+			return HeartGraphConnectionEvent.AffectedPins.Contains(Pin);
+		};
 
-		if (EdGraphPinA && EdGraphPinB)
+	for (const UHeartGraphNode* Node : HeartGraphConnectionEvent.AffectedNodes)
+	{
+		const UEdGraphNode* EdNode = IsValid(Node) ? EdNodes.FindRef(Node->GetGuid()) : nullptr;
+		if (!EdNode)
 		{
-			auto NodeAView = NodeA->ViewConnections(PinAGuid);
-			auto NodeBView = NodeB->ViewConnections(PinBGuid);
+			continue;
+		}
 
-			if (NodeAView.IsValid() && NodeBView.IsValid() &&
-				NodeAView.Get().GetLinks().Contains(NodeB->GetPinReference(PinBGuid)) &&
-				NodeBView.Get().GetLinks().Contains(NodeA->GetPinReference(PinAGuid)))
+		// Visit the node's own pins, rather than looking every affected pin up on every affected node.
+		Node->QueryPins()
+			.Filter(ByAffected)
+			.ForEach([HeartGraph, Node, EdNode, &EdNodes](const FHeartPinGuid PinGuid)
 			{
-				EdGraphPinA->MakeLinkTo(EdGraphPinB);
-			}
-			else
-			{
-				EdGraphPinA->BreakLinkTo(EdGraphPinB);
-			}
-		}
+				auto PinView = Node->ViewPin(PinGuid);
+				if (!PinView.IsValid())
+				{
+					return;
+				}
+
+				UEdGraphPin* EdGraphPin = EdNode->FindPin(PinView.Get().Name);
+				if (!EdGraphPin)
+				{
+					return;
+				}
+
+				TArray<UEdGraphPin*, TInlineAllocator<4>> LinkedPins;
+				if (auto ConnectionsView = Node->ViewConnections(PinGuid);
+					ConnectionsView.IsValid())
+				{
+					for (const FHeartGraphPinReference& Link : ConnectionsView.Get().GetLinks())
+					{
+						const UHeartGraphNode* LinkedNode = HeartGraph->GetNode(Link.NodeGuid);
+						const UEdGraphNode* LinkedEdNode = IsValid(LinkedNode) ? EdNodes.FindRef(Link.NodeGuid) : nullptr;
+						if (!LinkedEdNode)
+						{
+							continue;
+						}
+
+						if (UEdGraphPin* LinkedEdPin = LinkedEdNode->FindPin(LinkedNode->GetPinDescChecked(Link.PinGuid).Name))
+						{
+							LinkedPins.Add(LinkedEdPin);
+						}
+					}
+				}
+
+				for (int32 i = EdGraphPin->LinkedTo.Num() - 1; i >= 0; --i)
+				{
+					if (!LinkedPins.Contains(EdGraphPin->LinkedTo[i]))
+					{
+						EdGraphPin->BreakLinkTo(EdGraphPin->LinkedTo[i]);
+					}
+				}
+
+				for (UEdGraphPin* LinkedPin : LinkedPins)
+				{
+					if (!EdGraphPin->LinkedTo.Contains(LinkedPin))
+					{
+						EdGraphPin->MakeLinkTo(LinkedPin);
+					}
+				}
+			});
 	}
 }
\ No newline at end of file
@@ -66,11 +66,11 @@ protected:
 
 private:
 	// Create the EdGraph node equivalent to a HeartNode
-	void CreateEdGraphNode(UHeartGraphNode* Node);
+	UHeartEdGraphNode* CreateEdGraphNode(UHeartGraphNode* Node);
 
-	void OnNodeAdded(UHeartGraphNode* HeartGraphNode);
-	void OnNodeRemoved(UHeartGraphNode* HeartGraphNode);
-	void OnNodeConnectionsChanged(const FHeartGraphConnectionEvent& HeartGraphConnectionEvent);
+	void OnGraphBatch(const FHeartGraphBatchEvent& BatchEvent);
+	void ResyncConnections(const FHeartGraphConnectionEvent& HeartGraphConnectionEvent,
+						   const TMap<FHeartNodeGuid, UHeartEdGraphNode*>& EdNodes);
 
 	// Transient, so it can be remade on PostLoad/CreateGraph since the class used, change be changed by the schema.
 	UPROPERTY(Transient)
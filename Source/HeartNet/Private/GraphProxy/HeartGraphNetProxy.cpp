@@ -178,10 +178,7 @@ bool UHeartGraphNetProxy::SetupGraphProxy(UHeartGraph* InSourceGraph)
 	SourceGraph = InSourceGraph;
 
 	// Node delegates
-	SourceGraph->GetOnNodeAdded().AddUObject(this, &ThisClass::OnNodeAdded_Source);
-	SourceGraph->GetOnNodeRemoved().AddUObject(this, &ThisClass::OnNodeRemoved_Source);
-	SourceGraph->GetOnNodeMoved().AddUObject(this, &ThisClass::OnNodesMoved_Source);
-	SourceGraph->GetOnNodeConnectionsChanged().AddUObject(this, &ThisClass::OnNodeConnectionsChanged_Source);
+	SourceGraph->GetOnBatchEvent().AddUObject(this, &ThisClass::OnGraphBatch_Source);
 
 	// Extension delegates
 	SourceGraph->GetOnExtensionAdded().AddUObject(this, &ThisClass::OnExtensionAdded_Source);
@@ -201,6 +198,46 @@ bool UHeartGraphNetProxy::SetupGraphProxy(UHeartGraph* InSourceGraph)
 	return true;
 }
 
+void UHeartGraphNetProxy::OnGraphBatch_Source(const FHeartGraphBatchEvent& BatchEvent)
+{
+	for (auto&& Element : BatchEvent.Removed.AffectedNodes)
+	{
+		if (IsValid(Element))
+		{
+			OnNodeRemoved_Source(Element);
+		}
+	}
+
+	// Gather every node touched by the batch, so each is only serialized once.
+	TSet<TObjectPtr<UHeartGraphNode>> NodesToUpdate;
+	{
+		TGuardValue<TSet<TObjectPtr<UHeartGraphNode>>*> BatchGuard(BatchedNodeUpdates, &NodesToUpdate);
+
+		for (auto&& Element : BatchEvent.Added.NewNodes)
+		{
+			if (UHeartGraphNode* Node = SourceGraph->GetNode(Element))
+			{
+				OnNodeAdded_Source(Node);
+			}
+		}
+
+		if (!BatchEvent.Connections.AffectedNodes.IsEmpty())
+		{
+			OnNodeConnectionsChanged_Source(BatchEvent.Connections);
+		}
+
+		if (!BatchEvent.Moved.AffectedNodes.IsEmpty())
+		{
+			OnNodesMoved_Source(BatchEvent.Moved);
+		}
+	}
+
+	for (auto&& Element : NodesToUpdate)
+	{
+		UpdateReplicatedNodeData(Element);
+	}
+}
+
 void UHeartGraphNetProxy::OnNodeAdded_Source(UHeartGraphNode* HeartGraphNode)
 {
 	if (ShouldReplicateNode(HeartGraphNode))
@@ -277,6 +314,12 @@ void UHeartGraphNetProxy::UpdateReplicatedNodeData(TObjectPtr<UHeartGraphNode> N
 {
 	if (!IsValid(Node)) return;
 
+	if (BatchedNodeUpdates)
+	{
+		BatchedNodeUpdates->Add(Node);
+		return;
+	}
+
 	ReplicatedNodes.Operate(Node->GetGuid(),
 		[Node](FHeartReplicatedFlake& Data)
 		{
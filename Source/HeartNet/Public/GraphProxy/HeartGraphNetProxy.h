@@ -115,6 +115,9 @@ protected:
 	bool SetupGraphProxy(UHeartGraph* InSourceGraph);
 
 	// These functions are callbacks for when the source graph is changed, which propagate via replication to clients.
+	// Node edits are received as batches, and dispatched to the per-event callbacks below. Nodes they update while a
+	// batch is dispatched are only serialized once, after every callback has run.
+	virtual void OnGraphBatch_Source(const FHeartGraphBatchEvent& BatchEvent);
 	virtual void OnNodeAdded_Source(UHeartGraphNode* HeartGraphNode);
 	virtual void OnNodeRemoved_Source(UHeartGraphNode* HeartGraphNode);
 	virtual void OnNodesMoved_Source(const FHeartNodeMoveEvent& NodeMoveEvent);
@@ -126,6 +129,7 @@ protected:
 	virtual bool ShouldReplicateNode(TObjectPtr<UHeartGraphNode> Node) const;
 	virtual bool ShouldReplicateExtension(TObjectPtr<UHeartGraphExtension> Extension) const;
 
+	// Updates the replicated data of a node, or defers it to the end of the batch being dispatched.
 	void UpdateReplicatedNodeData(TObjectPtr<UHeartGraphNode> Node);
 	void UpdateReplicatedExtensionData(TObjectPtr<UHeartGraphExtension> Extension);
 	void EditReplicatedNodeData(const FHeartReplicatedFlake& NodeData, FGameplayTag EventType);
@@ -270,4 +274,7 @@ private:
 		MAX
 	};
 	bool RecursionGuards[ERecursiveCheck::MAX] = {};
+
+	// Nodes to update once the batch currently being dispatched by OnGraphBatch_Source has been handled.
+	TSet<TObjectPtr<UHeartGraphNode>>* BatchedNodeUpdates = nullptr;
 };
\ No newline at end of file
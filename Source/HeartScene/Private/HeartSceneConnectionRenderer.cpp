@@ -0,0 +1,336 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#include "HeartSceneConnectionRenderer.h"
+#include "HeartSceneGenerator.h"
+
+#include "Model/HeartGraph.h"
+#include "Model/HeartGraphNode.h"
+
+#include "Components/LineBatchComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HeartSceneConnectionRenderer)
+
+UHeartSceneConnectionRenderer::UHeartSceneConnectionRenderer()
+{
+	// Only ticks to flush connection changes, when there are some.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	Color = FLinearColor::White;
+	Thickness = 2.f;
+	Segments = 12;
+	Tangent = FVector(200.0, 0.0, 0.0);
+}
+
+void UHeartSceneConnectionRenderer::OnRegister()
+{
+	Super::OnRegister();
+
+	if (!IsValid(LineBatch))
+	{
+		LineBatch = NewObject<ULineBatchComponent>(GetOwner(), NAME_None, RF_Transient);
+		LineBatch->PrimaryComponentTick.bCanEverTick = false;
+		LineBatch->RegisterComponent();
+	}
+
+	if (!IsValid(Generator) && IsValid(GetOwner()))
+	{
+		SetGenerator(GetOwner()->FindComponentByClass<UHeartSceneGenerator>());
+	}
+}
+
+void UHeartSceneConnectionRenderer::OnUnregister()
+{
+	SetGenerator(nullptr);
+
+	if (IsValid(LineBatch))
+	{
+		LineBatch->DestroyComponent();
+		LineBatch = nullptr;
+	}
+
+	Super::OnUnregister();
+}
+
+void UHeartSceneConnectionRenderer::TickComponent(const float DeltaTime, const ELevelTick TickType,
+												  FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SetComponentTickEnabled(false);
+
+	if (!IsValid(LineBatch) || !IsValid(Graph))
+	{
+		DirtyConnections.Empty();
+		DirtyLocations.Empty();
+		return;
+	}
+
+	for (auto&& Node : DirtyConnections)
+	{
+		RefreshConnectionsOfNode(Node);
+	}
+
+	// Redraw each edge once, even if both of its nodes moved.
+	TSet<int32> EdgesToDraw;
+	for (auto&& Node : DirtyLocations)
+	{
+		if (const TArray<int32>* NodeEdgeIds = NodeEdges.Find(Node))
+		{
+			EdgesToDraw.Append(*NodeEdgeIds);
+		}
+	}
+
+	for (const int32 EdgeId : EdgesToDraw)
+	{
+		WriteEdgeLines(EdgeId);
+	}
+
+	DirtyConnections.Empty();
+	DirtyLocations.Empty();
+
+	// All changes made this frame reach the renderer at once.
+	LineBatch->MarkRenderStateDirty();
+}
+
+void UHeartSceneConnectionRenderer::SetGenerator(UHeartSceneGenerator* NewGenerator)
+{
+	if (Generator == NewGenerator)
+	{
+		return;
+	}
+
+	if (IsValid(Generator))
+	{
+		Generator->GetOnGenerated().RemoveAll(this);
+	}
+
+	Generator = NewGenerator;
+
+	if (IsValid(Generator))
+	{
+		Generator->GetOnGenerated().AddUObject(this, &ThisClass::RebuildAll);
+	}
+
+	RebuildAll();
+}
+
+void UHeartSceneConnectionRenderer::RebuildAll()
+{
+	BindToGraph(IsValid(Generator) ? Generator->GetHeartGraph() : nullptr);
+
+	Edges.Empty();
+	RangeOwners.Empty();
+	NodeEdges.Empty();
+	DirtyLocations.Empty();
+	DirtyConnections.Empty();
+
+	if (IsValid(LineBatch))
+	{
+		LineBatch->Flush();
+	}
+
+	if (!IsValid(Graph))
+	{
+		return;
+	}
+
+	Graph->ForEachNode(
+		[this](const UHeartGraphNode* Node)
+		{
+			DirtyConnections.Add(Node->GetGuid());
+			return true;
+		});
+
+	MarkDirty();
+}
+
+void UHeartSceneConnectionRenderer::BindToGraph(UHeartGraph* NewGraph)
+{
+	if (Graph == NewGraph)
+	{
+		return;
+	}
+
+	if (IsValid(Graph))
+	{
+		Graph->GetOnBatchEvent().RemoveAll(this);
+	}
+
+	Graph = NewGraph;
+
+	if (IsValid(Graph))
+	{
+		Graph->GetOnBatchEvent().AddUObject(this, &ThisClass::OnGraphBatchEvent);
+	}
+}
+
+void UHeartSceneConnectionRenderer::OnGraphBatchEvent(const FHeartGraphBatchEvent& Event)
+{
+	for (auto&& Node : Event.Removed.AffectedNodes)
+	{
+		if (IsValid(Node))
+		{
+			RemoveConnectionsOfNode(Node->GetGuid(), false);
+			DirtyConnections.Remove(Node->GetGuid());
+			DirtyLocations.Remove(Node->GetGuid());
+		}
+	}
+
+	DirtyConnections.Append(Event.Added.NewNodes);
+
+	for (auto&& Node : Event.Connections.AffectedNodes)
+	{
+		if (IsValid(Node))
+		{
+			DirtyConnections.Add(Node->GetGuid());
+		}
+	}
+
+	for (auto&& Node : Event.Moved.AffectedNodes)
+	{
+		if (IsValid(Node))
+		{
+			DirtyLocations.Add(Node->GetGuid());
+		}
+	}
+
+	if (!DirtyConnections.IsEmpty() || !DirtyLocations.IsEmpty())
+	{
+		MarkDirty();
+	}
+	else if (!Event.Removed.AffectedNodes.IsEmpty() && IsValid(LineBatch))
+	{
+		LineBatch->MarkRenderStateDirty();
+	}
+}
+
+void UHeartSceneConnectionRenderer::MarkDirty()
+{
+	if (!IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UHeartSceneConnectionRenderer::RefreshConnectionsOfNode(const FHeartNodeGuid& Node)
+{
+	RemoveConnectionsOfNode(Node, true);
+
+	const UHeartGraphNode* GraphNode = Graph->GetNode(Node);
+	if (!IsValid(GraphNode) || !Generator->IsNodeDisplayed(Node))
+	{
+		return;
+	}
+
+	// Only outgoing links are gathered, so each connection is added by exactly one of its nodes. Several pins linking
+	// the same pair of nodes are drawn as one edge.
+	TSet<FHeartNodeGuid> Targets;
+	GraphNode->FindPinsByDirection(EHeartPinDirection::Output)
+		.ForEach(
+		[&](const FHeartPinGuid PinGuid)
+		{
+			auto&& LinksView = GraphNode->ViewConnections(PinGuid);
+			if (!LinksView.IsValid())
+			{
+				return;
+			}
+
+			for (auto&& Link : LinksView.Get().GetLinks())
+			{
+				Targets.Add(Link.NodeGuid);
+			}
+		});
+
+	for (auto&& Target : Targets)
+	{
+		if (Generator->IsNodeDisplayed(Target))
+		{
+			AddEdge(Node, Target);
+		}
+	}
+}
+
+void UHeartSceneConnectionRenderer::RemoveConnectionsOfNode(const FHeartNodeGuid& Node, const bool OutgoingOnly)
+{
+	TArray<int32>* NodeEdgeIds = NodeEdges.Find(Node);
+	if (!NodeEdgeIds)
+	{
+		return;
+	}
+
+	// Copied, as removing edges edits this node's list.
+	const TArray<int32> EdgeIds = *NodeEdgeIds;
+	for (const int32 EdgeId : EdgeIds)
+	{
+		if (!OutgoingOnly || Edges[EdgeId].From == Node)
+		{
+			RemoveEdge(EdgeId);
+		}
+	}
+}
+
+void UHeartSceneConnectionRenderer::AddEdge(const FHeartNodeGuid& From, const FHeartNodeGuid& To)
+{
+	const int32 EdgeId = Edges.Add({ From, To, RangeOwners.Num() });
+	RangeOwners.Add(EdgeId);
+
+	NodeEdges.FindOrAdd(From).Add(EdgeId);
+	if (To != From)
+	{
+		NodeEdges.FindOrAdd(To).Add(EdgeId);
+	}
+
+	LineBatch->BatchedLines.AddDefaulted(Segments);
+	WriteEdgeLines(EdgeId);
+}
+
+void UHeartSceneConnectionRenderer::RemoveEdge(const int32 EdgeId)
+{
+	const FEdge Edge = Edges[EdgeId];
+	Edges.RemoveAt(EdgeId);
+
+	for (auto&& Node : { Edge.From, Edge.To })
+	{
+		if (TArray<int32>* NodeEdgeIds = NodeEdges.Find(Node))
+		{
+			NodeEdgeIds->RemoveSingleSwap(EdgeId);
+			if (NodeEdgeIds->IsEmpty())
+			{
+				NodeEdges.Remove(Node);
+			}
+		}
+	}
+
+	// Move the last range into the hole, so the line batch stays dense, and only Segments lines are copied.
+	TArray<FBatchedLine>& Lines = LineBatch->BatchedLines;
+	const int32 LastRange = RangeOwners.Num() - 1;
+	if (Edge.Range != LastRange)
+	{
+		const int32 MovedEdge = RangeOwners[LastRange];
+		FMemory::Memcpy(&Lines[Edge.Range * Segments], &Lines[LastRange * Segments], Segments * sizeof(FBatchedLine));
+		Edges[MovedEdge].Range = Edge.Range;
+		RangeOwners[Edge.Range] = MovedEdge;
+	}
+
+	RangeOwners.Pop(EAllowShrinking::No);
+	Lines.SetNum(RangeOwners.Num() * Segments, EAllowShrinking::No);
+}
+
+void UHeartSceneConnectionRenderer::WriteEdgeLines(const int32 EdgeId)
+{
+	const FEdge& Edge = Edges[EdgeId];
+
+	const FVector Start = Generator->GetNodeVisualLocation(Edge.From);
+	const FVector End = Generator->GetNodeVisualLocation(Edge.To);
+
+	FBatchedLine* Lines = &LineBatch->BatchedLines[Edge.Range * Segments];
+
+	FVector Previous = Start;
+	for (int32 i = 1; i <= Segments; ++i)
+	{
+		const float Alpha = static_cast<float>(i) / Segments;
+		const FVector Point = Segments == 1 ? End : FMath::CubicInterp(Start, Tangent, End, Tangent, Alpha);
+		Lines[i - 1] = FBatchedLine(Previous, Point, Color, 0.f, Thickness, SDPG_World);
+		Previous = Point;
+	}
+}
\ No newline at end of file
@@ -11,16 +11,43 @@
 #include "ModelView/HeartGraphSchema.h"
 #include "ModelView/HeartNodeLocationModifier.h"
 
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HeartSceneGenerator)
 
 UHeartSceneGenerator::UHeartSceneGenerator()
 {
-	PrimaryComponentTick.bCanEverTick = false;
+	// Only ticks to flush instance transform updates, when there are some.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 	UseWorldSpaceInModifiers = false;
+	UseInstancedRendering = false;
+	UseHierarchicalInstances = false;
 
 	LocationModifiers = CreateDefaultSubobject<UHeartNodeLocationModifierStack>("LocationModifiers");
 }
 
+void UHeartSceneGenerator::TickComponent(const float DeltaTime, const ELevelTick TickType,
+										 FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Send all instance moves made since the last tick to the renderer at once, instead of once per moved node.
+	for (auto&& Batch : InstanceBatches)
+	{
+		if (Batch.Value.RenderStateDirty)
+		{
+			Batch.Value.RenderStateDirty = false;
+			if (IsValid(Batch.Value.Component))
+			{
+				Batch.Value.Component->MarkRenderStateDirty();
+			}
+		}
+	}
+
+	SetComponentTickEnabled(false);
+}
+
 UHeartGraph* UHeartSceneGenerator::GetHeartGraph() const
 {
 	return Graph;
@@ -28,6 +55,15 @@ UHeartGraph* UHeartSceneGenerator::GetHeartGraph() const
 
 FVector UHeartSceneGenerator::GetNodeLocation3D(const FHeartNodeGuid& Node) const
 {
+	if (auto&& Instance = InstancedNodes.Find(Node))
+	{
+		if (ensure(IsValid(LocationModifiers)))
+		{
+			return LocationModifiers->ProxyToLocation3D(Instance->Location);
+		}
+		return FVector();
+	}
+
 	if (!SceneNodes.Contains(Node))
 	{
 		return FVector();
@@ -44,6 +80,16 @@ FVector UHeartSceneGenerator::GetNodeLocation3D(const FHeartNodeGuid& Node) cons
 
 void UHeartSceneGenerator::SetNodeLocation3D(const FHeartNodeGuid& Node, const FVector& Location, const bool InProgressMove)
 {
+	if (auto&& Instance = InstancedNodes.Find(Node))
+	{
+		if (ensure(IsValid(LocationModifiers)))
+		{
+			Instance->Location = LocationModifiers->LocationToProxy3D(Location);
+			UpdateInstanceTransform(InstanceBatches.FindChecked(Instance->VisualizerClass), *Instance);
+		}
+		return;
+	}
+
 	if (!SceneNodes.Contains(Node))
 	{
 		return;
@@ -70,6 +116,7 @@ void UHeartSceneGenerator::SetDisplayedGraph(UHeartGraph* NewGraph)
 {
 	if (IsValid(Graph))
 	{
+		ClearInstances();
 		OnReset();
 	}
 
@@ -78,8 +125,10 @@ void UHeartSceneGenerator::SetDisplayedGraph(UHeartGraph* NewGraph)
 
 void UHeartSceneGenerator::Regenerate()
 {
+	ClearInstances();
 	OnReset();
 	Generate();
+	OnGenerated.Broadcast();
 }
 
 UHeartSceneNode* UHeartSceneGenerator::GetSceneNode(const FHeartNodeGuid& NodeGuid) const
@@ -91,6 +140,100 @@ UHeartSceneNode* UHeartSceneGenerator::GetSceneNode(const FHeartNodeGuid& NodeGu
 	return nullptr;
 }
 
+bool UHeartSceneGenerator::IsNodeInstanced(const FHeartNodeGuid& NodeGuid) const
+{
+	return InstancedNodes.Contains(NodeGuid);
+}
+
+bool UHeartSceneGenerator::IsNodeDisplayed(const FHeartNodeGuid& NodeGuid) const
+{
+	return InstancedNodes.Contains(NodeGuid) || SceneNodes.Contains(NodeGuid);
+}
+
+FVector UHeartSceneGenerator::GetNodeVisualLocation(const FHeartNodeGuid& NodeGuid) const
+{
+	if (auto&& Instance = InstancedNodes.Find(NodeGuid))
+	{
+		if (UseWorldSpaceInModifiers)
+		{
+			return Instance->Location;
+		}
+
+		const FHeartSceneInstanceBatch& Batch = InstanceBatches.FindChecked(Instance->VisualizerClass);
+		return Batch.Component->GetComponentTransform().TransformPosition(Instance->Location);
+	}
+
+	if (const UHeartSceneNode* SceneNode = GetSceneNode(NodeGuid))
+	{
+		return SceneNode->GetComponentLocation();
+	}
+
+	return FVector::ZeroVector;
+}
+
+FHeartNodeGuid UHeartSceneGenerator::GetNodeForInstance(const UPrimitiveComponent* Component, const int32 InstanceIndex) const
+{
+	for (auto&& Batch : InstanceBatches)
+	{
+		if (Batch.Value.Component.Get() == Component)
+		{
+			return Batch.Value.Nodes.IsValidIndex(InstanceIndex) ? Batch.Value.Nodes[InstanceIndex] : FHeartNodeGuid();
+		}
+	}
+	return FHeartNodeGuid();
+}
+
+UHeartSceneNode* UHeartSceneGenerator::PromoteNode(const FHeartNodeGuid& NodeGuid)
+{
+	FHeartSceneNodeInstance Instance;
+	if (auto&& InstancePtr = InstancedNodes.Find(NodeGuid))
+	{
+		Instance = *InstancePtr;
+	}
+	else
+	{
+		return GetSceneNode(NodeGuid);
+	}
+
+	UHeartGraphNode* GraphNode = IsValid(Graph) ? Graph->GetNode(NodeGuid) : nullptr;
+	if (!IsValid(GraphNode))
+	{
+		return nullptr;
+	}
+
+	RemoveNodeInstance(NodeGuid);
+
+	UHeartSceneNode* SceneNode = CreateSceneNode(GraphNode, Instance.VisualizerClass);
+
+	if (UseWorldSpaceInModifiers)
+	{
+		SceneNode->SetWorldLocation(Instance.Location);
+	}
+	else
+	{
+		SceneNode->SetRelativeLocation(Instance.Location);
+	}
+
+	return SceneNode;
+}
+
+bool UHeartSceneGenerator::DemoteNode(const FHeartNodeGuid& NodeGuid)
+{
+	UHeartSceneNode* SceneNode = GetSceneNode(NodeGuid);
+	if (!IsValid(SceneNode) || !CanInstanceVisualizer(SceneNode->GetClass()))
+	{
+		return false;
+	}
+
+	const FVector Location = UseWorldSpaceInModifiers ? SceneNode->GetComponentLocation() : SceneNode->GetRelativeLocation();
+
+	SceneNodes.Remove(NodeGuid);
+	SceneNode->DestroyComponent();
+
+	AddNodeInstance(NodeGuid, SceneNode->GetClass(), Location);
+	return true;
+}
+
 void UHeartSceneGenerator::OnReset_Implementation()
 {
 }
@@ -122,23 +265,131 @@ UHeartSceneNode* UHeartSceneGenerator::AddNodeToDisplay(UHeartGraphNode* GraphNo
 
 	if (const TSubclassOf<UHeartSceneNode> VisualizerClass = GetVisualClassForNode(GraphNode))
 	{
-		auto&& SceneNode = NewObject<UHeartSceneNode>(GetOwner(), VisualizerClass);
-		check(SceneNode);
+		if (UseInstancedRendering && CanInstanceVisualizer(VisualizerClass))
+		{
+			AddNodeInstance(GraphNode->GetGuid(), VisualizerClass, FVector::ZeroVector);
+			return nullptr;
+		}
+
+		return CreateSceneNode(GraphNode, VisualizerClass);
+	}
+	else
+	{
+		UE_LOG(LogHeartGraphScene, Warning, TEXT("Unable to determine Visual Class. Node '%s' will not be displayed"), *GraphNode->GetName())
+		return nullptr;
+	}
+}
 
-		SceneNode->Generator = this;
-		SceneNode->GraphNode = GraphNode;
+bool UHeartSceneGenerator::CanInstanceVisualizer(const TSubclassOf<UHeartSceneNode> VisualizerClass) const
+{
+	return IsValid(VisualizerClass) && IsValid(VisualizerClass->GetDefaultObject<UHeartSceneNode>()->InstancedMesh);
+}
 
-		SceneNodes.Add(GraphNode->GetGuid(), SceneNode);
+UHeartSceneNode* UHeartSceneGenerator::CreateSceneNode(UHeartGraphNode* GraphNode, const TSubclassOf<UHeartSceneNode> VisualizerClass)
+{
+	auto&& SceneNode = NewObject<UHeartSceneNode>(GetOwner(), VisualizerClass);
+	check(SceneNode);
 
-		SceneNode->RegisterComponent();
+	SceneNode->Generator = this;
+	SceneNode->GraphNode = GraphNode;
 
-		SceneNode->NativeOnCreated();
+	SceneNodes.Add(GraphNode->GetGuid(), SceneNode);
+
+	SceneNode->RegisterComponent();
+
+	SceneNode->NativeOnCreated();
+
+	return SceneNode;
+}
 
-		return SceneNode;
+void UHeartSceneGenerator::AddNodeInstance(const FHeartNodeGuid& NodeGuid, const TSubclassOf<UHeartSceneNode> VisualizerClass,
+										   const FVector& Location)
+{
+	FHeartSceneInstanceBatch& Batch = InstanceBatches.FindOrAdd(VisualizerClass);
+
+	if (!IsValid(Batch.Component))
+	{
+		const UHeartSceneNode* VisualizerCDO = VisualizerClass->GetDefaultObject<UHeartSceneNode>();
+
+		if (UseHierarchicalInstances)
+		{
+			Batch.Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(GetOwner());
+		}
+		else
+		{
+			Batch.Component = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+
+			// Removing an instance moves the last instance into its place, so only one index changes. HISM always does this.
+			Batch.Component->bSupportRemoveAtSwap = true;
+		}
+
+		Batch.Component->SetStaticMesh(VisualizerCDO->InstancedMesh);
+		for (int32 i = 0; i < VisualizerCDO->InstancedMaterials.Num(); ++i)
+		{
+			Batch.Component->SetMaterial(i, VisualizerCDO->InstancedMaterials[i]);
+		}
+		Batch.Component->RegisterComponent();
+		Batch.Nodes.Reset();
 	}
-	else
+
+	FHeartSceneNodeInstance& Instance = InstancedNodes.Add(NodeGuid);
+	Instance.VisualizerClass = VisualizerClass;
+	Instance.Location = Location;
+	Instance.Index = Batch.Component->AddInstance(
+		VisualizerClass->GetDefaultObject<UHeartSceneNode>()->InstancedMeshTransform * FTransform(Location),
+		UseWorldSpaceInModifiers);
+
+	check(Instance.Index == Batch.Nodes.Num());
+	Batch.Nodes.Add(NodeGuid);
+}
+
+void UHeartSceneGenerator::RemoveNodeInstance(const FHeartNodeGuid& NodeGuid)
+{
+	FHeartSceneNodeInstance Instance;
+	if (!InstancedNodes.RemoveAndCopyValue(NodeGuid, Instance))
 	{
-		UE_LOG(LogHeartGraphScene, Warning, TEXT("Unable to determine Visual Class. Node '%s' will not be displayed"), *GraphNode->GetName())
-		return nullptr;
+		return;
 	}
+
+	FHeartSceneInstanceBatch& Batch = InstanceBatches.FindChecked(Instance.VisualizerClass);
+	Batch.Component->RemoveInstance(Instance.Index);
+
+	// Mirror the swap the component did, moving the last instance into the removed one's place.
+	const int32 LastIndex = Batch.Nodes.Num() - 1;
+	if (Instance.Index != LastIndex)
+	{
+		const FHeartNodeGuid MovedNode = Batch.Nodes[LastIndex];
+		Batch.Nodes[Instance.Index] = MovedNode;
+		InstancedNodes.FindChecked(MovedNode).Index = Instance.Index;
+	}
+	Batch.Nodes.Pop(EAllowShrinking::No);
+}
+
+void UHeartSceneGenerator::UpdateInstanceTransform(FHeartSceneInstanceBatch& Batch, const FHeartSceneNodeInstance& Instance)
+{
+	const FTransform Transform =
+		Instance.VisualizerClass->GetDefaultObject<UHeartSceneNode>()->InstancedMeshTransform * FTransform(Instance.Location);
+
+	// The render state is only marked dirty once per tick, for all instances moved in that frame.
+	Batch.Component->UpdateInstanceTransform(Instance.Index, Transform, UseWorldSpaceInModifiers, false, true);
+
+	if (!Batch.RenderStateDirty)
+	{
+		Batch.RenderStateDirty = true;
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UHeartSceneGenerator::ClearInstances()
+{
+	for (auto&& Batch : InstanceBatches)
+	{
+		if (IsValid(Batch.Value.Component))
+		{
+			Batch.Value.Component->DestroyComponent();
+		}
+	}
+
+	InstanceBatches.Empty();
+	InstancedNodes.Empty();
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+﻿// Copyright Guy (Drakynfly) Lundvall. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "Model/HeartGuids.h"
+#include "Containers/SparseArray.h"
+
+#include "HeartSceneConnectionRenderer.generated.h"
+
+struct FHeartGraphBatchEvent;
+class UHeartGraph;
+class UHeartSceneGenerator;
+class ULineBatchComponent;
+
+/**
+ * Draws every connection of the graph displayed by a scene generator as lines in a single line batch, so all edges
+ * render in one draw call, instead of a component per connection. Each connection owns a fixed range of lines in the
+ * batch, and only connections touching moved, added, or reconnected nodes are rebuilt.
+ */
+UCLASS(Blueprintable, ClassGroup = ("Heart"), meta = (BlueprintSpawnableComponent))
+class HEARTSCENE_API UHeartSceneConnectionRenderer : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHeartSceneConnectionRenderer();
+
+	/** UActorComponent */
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	/** UActorComponent */
+
+	// Set the generator whose nodes are connected. If never called, the first generator on the owning actor is used.
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneConnectionRenderer")
+	void SetGenerator(UHeartSceneGenerator* NewGenerator);
+
+	// Throw away all lines and rebuild every connection.
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneConnectionRenderer")
+	void RebuildAll();
+
+	int32 GetNumConnections() const { return Edges.Num(); }
+
+protected:
+	void BindToGraph(UHeartGraph* NewGraph);
+	void OnGraphBatchEvent(const FHeartGraphBatchEvent& Event);
+
+	void MarkDirty();
+
+	// Drop a node's outgoing connections and gather them again from its pins.
+	void RefreshConnectionsOfNode(const FHeartNodeGuid& Node);
+	void RemoveConnectionsOfNode(const FHeartNodeGuid& Node, bool OutgoingOnly);
+
+	void AddEdge(const FHeartNodeGuid& From, const FHeartNodeGuid& To);
+	void RemoveEdge(int32 EdgeId);
+	void WriteEdgeLines(int32 EdgeId);
+
+protected:
+	UPROPERTY(EditAnywhere, Category = "Connections")
+	FLinearColor Color;
+
+	// Width of the lines in world units. Zero draws one pixel wide lines.
+	UPROPERTY(EditAnywhere, Category = "Connections", meta = (ClampMin = 0))
+	float Thickness;
+
+	// Number of line segments each connection is drawn with. One draws straight lines.
+	UPROPERTY(EditAnywhere, Category = "Connections", meta = (ClampMin = 1, ClampMax = 64))
+	int32 Segments;
+
+	// Tangent at each end of a curved connection, leaving the output node and entering the input node.
+	UPROPERTY(EditAnywhere, Category = "Connections")
+	FVector Tangent;
+
+private:
+	UPROPERTY()
+	TObjectPtr<UHeartSceneGenerator> Generator;
+
+	UPROPERTY()
+	TObjectPtr<UHeartGraph> Graph;
+
+	UPROPERTY(Transient)
+	TObjectPtr<ULineBatchComponent> LineBatch;
+
+	struct FEdge
+	{
+		FHeartNodeGuid From;
+		FHeartNodeGuid To;
+
+		// Which range of Segments lines in the line batch this edge is drawn with.
+		int32 Range = INDEX_NONE;
+	};
+
+	TSparseArray<FEdge> Edges;
+
+	// The edge drawn by each range of lines. Ranges are kept dense by moving the last range into removed ones.
+	TArray<int32> RangeOwners;
+
+	// Edges leaving or entering each node
+	TMap<FHeartNodeGuid, TArray<int32>> NodeEdges;
+
+	// Nodes whose connections must be gathered again, or whose edges must be redrawn.
+	TSet<FHeartNodeGuid> DirtyConnections;
+	TSet<FHeartNodeGuid> DirtyLocations;
+};
\ No newline at end of file
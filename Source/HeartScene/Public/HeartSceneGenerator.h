@@ -12,6 +12,41 @@ class UHeartGraph;
 class UHeartGraphNode3D;
 class UHeartNodeLocationModifierStack;
 class UHeartSceneNode;
+class UInstancedStaticMeshComponent;
+
+// All instances drawn for one visualizer class.
+USTRUCT()
+struct FHeartSceneInstanceBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Component;
+
+	// The node drawn by each instance, by instance index.
+	UPROPERTY()
+	TArray<FHeartNodeGuid> Nodes;
+
+	// Are there instance transform updates waiting to be sent to the renderer?
+	bool RenderStateDirty = false;
+};
+
+// A node that is drawn as an instance in a batch, instead of by its own scene node.
+USTRUCT()
+struct FHeartSceneNodeInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<UHeartSceneNode> VisualizerClass;
+
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
+
+	// Location of the node, in the same space a scene node would use.
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+};
 
 UCLASS(Blueprintable, ClassGroup = ("Heart"), meta = (BlueprintSpawnableComponent))
 class HEARTSCENE_API UHeartSceneGenerator : public UActorComponent, public IHeartGraphInterface3D
@@ -21,6 +56,10 @@ class HEARTSCENE_API UHeartSceneGenerator : public UActorComponent, public IHear
 public:
 	UHeartSceneGenerator();
 
+	/** UActorComponent */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	/** UActorComponent */
+
 	/** IHeartGraphInterface */
 	virtual UHeartGraph* GetHeartGraph() const override;
 	/** IHeartGraphInterface */
@@ -37,9 +76,37 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
 	void Regenerate();
 
+	// Get the scene node for a node. Returns null for nodes drawn as instances, unless they have been promoted.
 	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
 	UHeartSceneNode* GetSceneNode(const FHeartNodeGuid& NodeGuid) const;
 
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
+	bool IsNodeInstanced(const FHeartNodeGuid& NodeGuid) const;
+
+	// Is the node shown, either by a scene node or an instance?
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
+	bool IsNodeDisplayed(const FHeartNodeGuid& NodeGuid) const;
+
+	// World space location of the node's visual. Unlike GetNodeLocation3D, this is after location modifiers are applied.
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
+	FVector GetNodeVisualLocation(const FHeartNodeGuid& NodeGuid) const;
+
+	// Broadcast after Regenerate has displayed the graph.
+	FSimpleMulticastDelegate::RegistrationType& GetOnGenerated() { return OnGenerated; }
+
+	// Find the node drawn by an instance, e.g., from the Component and Item of a hit result.
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
+	FHeartNodeGuid GetNodeForInstance(const UPrimitiveComponent* Component, int32 InstanceIndex) const;
+
+	// Replace a node's instance with a full scene node, e.g., when the user starts interacting with it. Returns the
+	// scene node, which will already exist if the node was not instanced.
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
+	UHeartSceneNode* PromoteNode(const FHeartNodeGuid& NodeGuid);
+
+	// Return a promoted node to being drawn as an instance. Returns false if the node's visualizer can't be instanced.
+	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
+	bool DemoteNode(const FHeartNodeGuid& NodeGuid);
+
 protected:
 	UFUNCTION(BlueprintNativeEvent, Category = "Heart|SceneGenerator")
 	void OnReset();
@@ -49,9 +116,19 @@ protected:
 
 	TSubclassOf<UHeartSceneNode> GetVisualClassForNode(const UHeartGraphNode* GraphNode) const;
 
+	// Display a node. Returns null if the node was drawn as an instance, instead of with a scene node.
 	UFUNCTION(BlueprintCallable, Category = "Heart|SceneGenerator")
 	UHeartSceneNode* AddNodeToDisplay(UHeartGraphNode* GraphNode);
 
+	bool CanInstanceVisualizer(TSubclassOf<UHeartSceneNode> VisualizerClass) const;
+
+private:
+	UHeartSceneNode* CreateSceneNode(UHeartGraphNode* GraphNode, TSubclassOf<UHeartSceneNode> VisualizerClass);
+	void AddNodeInstance(const FHeartNodeGuid& NodeGuid, TSubclassOf<UHeartSceneNode> VisualizerClass, const FVector& Location);
+	void RemoveNodeInstance(const FHeartNodeGuid& NodeGuid);
+	void UpdateInstanceTransform(FHeartSceneInstanceBatch& Batch, const FHeartSceneNodeInstance& Instance);
+	void ClearInstances();
+
 protected:
 	UPROPERTY()
 	TObjectPtr<UHeartGraph> Graph;
@@ -65,4 +142,22 @@ protected:
 	// Should the LocationModifiers work with world space vectors, instead of relative?
 	UPROPERTY(EditAnywhere, Category = "Visualization")
 	bool UseWorldSpaceInModifiers;
+
+	// Draw nodes whose visualizer class has an InstancedMesh as instances, batched into one component per visualizer
+	// class, instead of creating a scene component per node. Use PromoteNode to give a node its own component.
+	UPROPERTY(EditAnywhere, Category = "Visualization")
+	bool UseInstancedRendering;
+
+	// Batch instances with hierarchical instanced meshes, which cull and LOD clusters of instances. Better for large graphs.
+	UPROPERTY(EditAnywhere, Category = "Visualization", meta = (EditCondition = "UseInstancedRendering"))
+	bool UseHierarchicalInstances;
+
+private:
+	UPROPERTY()
+	TMap<TSubclassOf<UHeartSceneNode>, FHeartSceneInstanceBatch> InstanceBatches;
+
+	UPROPERTY()
+	TMap<FHeartNodeGuid, FHeartSceneNodeInstance> InstancedNodes;
+
+	FSimpleMulticastDelegate OnGenerated;
 };
\ No newline at end of file
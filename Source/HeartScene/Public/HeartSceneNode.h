@@ -9,6 +9,8 @@
 
 class UHeartGraphNode;
 class UHeartSceneGenerator;
+class UMaterialInterface;
+class UStaticMesh;
 
 /**
  * Base class for a 3D representation of a Heart node in a graph visualizer.
@@ -39,4 +41,19 @@ protected:
 
 	UPROPERTY()
 	TWeakObjectPtr<UHeartSceneGenerator> Generator;
+
+	/**
+	 * Mesh used to draw nodes of this class as instances, when the generator has instanced rendering enabled. Nodes
+	 * drawn as instances don't have a component of their own until they are promoted. Leave empty to always create
+	 * a component per node.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Instancing")
+	TObjectPtr<UStaticMesh> InstancedMesh;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Instancing")
+	TArray<TObjectPtr<UMaterialInterface>> InstancedMaterials;
+
+	// Transform of the instanced mesh, relative to the node location.
+	UPROPERTY(EditDefaultsOnly, Category = "Instancing")
+	FTransform InstancedMeshTransform;
 };